@@ -0,0 +1,96 @@
+#ifndef ANIMATEDMESH_H
+#define ANIMATEDMESH_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <vector>
+
+// ==================== AnimatedMesh Class ====================
+// A whole model in one static buffer, every vertex pre-transformed to its
+// rest pose in model space and tagged with a part id. The vertex shader
+// (vertex_animated.glsl) moves vertices by part id from a few per-model
+// uniforms, so animated parts need no per-frame matrices and the model is
+// a single draw call.
+class AnimatedMesh {
+private:
+    unsigned int VAO, VBO, EBO;
+    std::vector<float> vertices;         // Position, color, part id (7 floats)
+    std::vector<unsigned int> indices;
+    unsigned int indexCount;
+
+    template <typename VertexVector>
+    unsigned int appendVertices(const VertexVector& partVertices, const glm::mat4& restTransform, float partId) {
+        unsigned int base = static_cast<unsigned int>(vertices.size() / 7);
+        for (size_t v = 0; v + 5 < partVertices.size(); v += 6) {
+            glm::vec4 p = restTransform * glm::vec4(partVertices[v], partVertices[v + 1], partVertices[v + 2], 1.0f);
+            vertices.insert(vertices.end(), { p.x, p.y, p.z,
+                partVertices[v + 3], partVertices[v + 4], partVertices[v + 5], partId });
+        }
+        return base;
+    }
+
+public:
+    AnimatedMesh() : VAO(0), VBO(0), EBO(0), indexCount(0) {}
+
+    // Indexed part (6-float vertices as built by Cube/Cylinder)
+    template <typename VertexVector, typename IndexVector>
+    void add(const VertexVector& partVertices, const IndexVector& partIndices,
+        const glm::mat4& restTransform, int partId) {
+        unsigned int base = appendVertices(partVertices, restTransform, static_cast<float>(partId));
+        for (unsigned int index : partIndices) indices.push_back(base + index);
+    }
+
+    // Non-indexed triangles (WheelSpokes) become sequential indices
+    template <typename VertexVector>
+    void addArrays(const VertexVector& partVertices, const glm::mat4& restTransform, int partId) {
+        unsigned int base = appendVertices(partVertices, restTransform, static_cast<float>(partId));
+        unsigned int count = static_cast<unsigned int>(partVertices.size() / 6);
+        for (unsigned int i = 0; i < count; i++) indices.push_back(base + i);
+    }
+
+    void upload() {
+        glGenVertexArrays(1, &VAO);
+        glGenBuffers(1, &VBO);
+        glGenBuffers(1, &EBO);
+
+        glBindVertexArray(VAO);
+        glBindBuffer(GL_ARRAY_BUFFER, VBO);
+        glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
+
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 7 * sizeof(float), (void*)0);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 7 * sizeof(float), (void*)(3 * sizeof(float)));
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(2, 1, GL_FLOAT, GL_FALSE, 7 * sizeof(float), (void*)(6 * sizeof(float)));
+        glEnableVertexAttribArray(2);
+        glBindVertexArray(0);
+
+        indexCount = static_cast<unsigned int>(indices.size());
+        std::vector<float>().swap(vertices);
+        std::vector<unsigned int>().swap(indices);
+    }
+
+    // Per-model uniforms must already be set on the bound shader
+    void draw() const {
+        glBindVertexArray(VAO);
+        glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, (void*)0);
+        drawStats().count(indexCount);
+        glBindVertexArray(0);
+    }
+
+    bool isUploaded() const { return VAO != 0; }
+    unsigned int getIndexCount() const { return indexCount; }
+
+    void cleanup() {
+        if (VAO) glDeleteVertexArrays(1, &VAO);
+        if (VBO) glDeleteBuffers(1, &VBO);
+        if (EBO) glDeleteBuffers(1, &EBO);
+        VAO = VBO = EBO = 0;
+        indexCount = 0;
+    }
+};
+
+#endif
@@ -0,0 +1,229 @@
+#ifndef ANIMATIONSYSTEM_H
+#define ANIMATIONSYSTEM_H
+
+#include <algorithm>
+#include <vector>
+
+// ==================== Easing Curves ====================
+// Every curve is a cubic e(u) = a*u^3 + b*u^2 + c*u with e(0) = 0 and
+// e(1) = 1, so all channels evaluate the same polynomial and the batch
+// pass never branches on the curve type.
+enum EasingCurve { EASE_LINEAR, EASE_IN, EASE_OUT, EASE_IN_OUT };
+
+struct Keyframe {
+    float time;              // Seconds after the track starts
+    float value;
+    EasingCurve curve;       // Easing of the segment ending at this key
+};
+
+// ==================== AnimationSystem Class ====================
+// Float channels driven by the sim clock, stored as structure-of-arrays:
+//   value = from + delta * e(clamp((t - start) / duration)) + rate * (t - start)
+// Eased moves (doors, steering) use delta/duration, continuous motion
+// (wheel spin) uses rate. Keyframe tracks only re-aim their channel's
+// segment when a key is passed; the per-frame work is one SIMD pass over
+// all channels, whatever owns them.
+class AnimationSystem {
+public:
+    typedef int Channel;
+
+private:
+    struct Track {
+        Channel channel;
+        std::vector<Keyframe> keys;
+        float startTime;
+        size_t next;             // Key the channel is currently heading to
+    };
+
+    // Channel SoA
+    std::vector<float> from, delta, startTime, invDuration, rate;
+    std::vector<float> coeffA, coeffB, coeffC;
+    std::vector<float> values;
+    std::vector<int> trackOf;    // Index into tracks, -1 = none
+
+    std::vector<Track> tracks;
+    float time;
+
+    static void curveCoefficients(EasingCurve curve, float& a, float& b, float& c) {
+        switch (curve) {
+        case EASE_IN:     a = 0.0f;  b = 1.0f;  c = 0.0f; break;   // u^2
+        case EASE_OUT:    a = 0.0f;  b = -1.0f; c = 2.0f; break;   // 2u - u^2
+        case EASE_IN_OUT: a = -2.0f; b = 3.0f;  c = 0.0f; break;   // smoothstep
+        default:          a = 0.0f;  b = 0.0f;  c = 1.0f; break;
+        }
+    }
+
+    void setSegment(Channel c, float start, float target, float duration, EasingCurve curve) {
+        from[c] = values[c];
+        delta[c] = target - values[c];
+        startTime[c] = start;
+        invDuration[c] = duration > 0.0f ? 1.0f / duration : 0.0f;
+        rate[c] = 0.0f;
+        curveCoefficients(curve, coeffA[c], coeffB[c], coeffC[c]);
+        if (duration <= 0.0f) {
+            from[c] = target;
+            delta[c] = 0.0f;
+        }
+    }
+
+    void stopTrack(Channel c) {
+        int t = trackOf[c];
+        if (t < 0) return;
+        // Swap-remove, fixing the moved track's back reference
+        tracks[t] = tracks.back();
+        tracks.pop_back();
+        if (t < static_cast<int>(tracks.size())) trackOf[tracks[t].channel] = t;
+        trackOf[c] = -1;
+    }
+
+    // Sequencing: channels whose segment ended move on to their next key.
+    // Segments start at the key time, not at 'time', so tracks do not drift.
+    void advanceTracks() {
+        for (size_t t = 0; t < tracks.size();) {
+            Track& track = tracks[t];
+            Channel c = track.channel;
+            bool finished = false;
+            while (time >= track.startTime + track.keys[track.next].time) {
+                float keyTime = track.startTime + track.keys[track.next].time;
+                values[c] = track.keys[track.next].value;
+                if (++track.next == track.keys.size()) {
+                    setSegment(c, keyTime, values[c], 0.0f, EASE_LINEAR);
+                    finished = true;
+                    break;
+                }
+                const Keyframe& key = track.keys[track.next];
+                setSegment(c, keyTime, key.value, key.time - track.keys[track.next - 1].time, key.curve);
+            }
+            if (finished) stopTrack(c);
+            else t++;
+        }
+    }
+
+    static void evaluateScalar(const AnimationSystem& s, float now, float* out, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            float elapsed = now - s.startTime[i];
+            float u = std::min(std::max(elapsed * s.invDuration[i], 0.0f), 1.0f);
+            float e = ((s.coeffA[i] * u + s.coeffB[i]) * u + s.coeffC[i]) * u;
+            out[i] = s.from[i] + s.delta[i] * e + s.rate[i] * elapsed;
+        }
+    }
+
+#ifdef BUS_SIMD_X86
+    static size_t evaluateSSE2(const AnimationSystem& s, float now, float* out, size_t n) {
+        const __m128 t = _mm_set1_ps(now);
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 one = _mm_set1_ps(1.0f);
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            __m128 elapsed = _mm_sub_ps(t, _mm_loadu_ps(&s.startTime[i]));
+            __m128 u = _mm_min_ps(_mm_max_ps(_mm_mul_ps(elapsed, _mm_loadu_ps(&s.invDuration[i])), zero), one);
+            __m128 e = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&s.coeffA[i]), u), _mm_loadu_ps(&s.coeffB[i]));
+            e = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(e, u), _mm_loadu_ps(&s.coeffC[i])), u);
+            __m128 v = _mm_add_ps(_mm_loadu_ps(&s.from[i]), _mm_mul_ps(_mm_loadu_ps(&s.delta[i]), e));
+            _mm_storeu_ps(&out[i], _mm_add_ps(v, _mm_mul_ps(_mm_loadu_ps(&s.rate[i]), elapsed)));
+        }
+        return i;
+    }
+
+    BUS_TARGET_AVX2 static size_t evaluateAVX2(const AnimationSystem& s, float now, float* out, size_t n) {
+        const __m256 t = _mm256_set1_ps(now);
+        const __m256 zero = _mm256_setzero_ps();
+        const __m256 one = _mm256_set1_ps(1.0f);
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            __m256 elapsed = _mm256_sub_ps(t, _mm256_loadu_ps(&s.startTime[i]));
+            __m256 u = _mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(elapsed, _mm256_loadu_ps(&s.invDuration[i])), zero), one);
+            __m256 e = _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(&s.coeffA[i]), u), _mm256_loadu_ps(&s.coeffB[i]));
+            e = _mm256_mul_ps(_mm256_add_ps(_mm256_mul_ps(e, u), _mm256_loadu_ps(&s.coeffC[i])), u);
+            __m256 v = _mm256_add_ps(_mm256_loadu_ps(&s.from[i]), _mm256_mul_ps(_mm256_loadu_ps(&s.delta[i]), e));
+            _mm256_storeu_ps(&out[i], _mm256_add_ps(v, _mm256_mul_ps(_mm256_loadu_ps(&s.rate[i]), elapsed)));
+        }
+        _mm256_zeroupper();
+        return i;
+    }
+#endif
+
+public:
+    AnimationSystem() : time(0.0f) {}
+
+    Channel addChannel(float initialValue) {
+        from.push_back(initialValue);
+        delta.push_back(0.0f);
+        startTime.push_back(time);
+        invDuration.push_back(0.0f);
+        rate.push_back(0.0f);
+        coeffA.push_back(0.0f);
+        coeffB.push_back(0.0f);
+        coeffC.push_back(1.0f);
+        values.push_back(initialValue);
+        trackOf.push_back(-1);
+        return static_cast<Channel>(values.size()) - 1;
+    }
+
+    // Eased move from the current value; cancels any rate or keyframe track
+    void animateTo(Channel c, float target, float duration, EasingCurve curve = EASE_IN_OUT) {
+        stopTrack(c);
+        setSegment(c, time, target, duration, curve);
+    }
+
+    // Continuous motion in units per second from the current value
+    void setRate(Channel c, float unitsPerSecond) {
+        stopTrack(c);
+        setSegment(c, time, values[c], 0.0f, EASE_LINEAR);
+        rate[c] = unitsPerSecond;
+    }
+
+    // Rebases the channel, e.g. to wrap an angle; keeps its current rate
+    void setValue(Channel c, float value) {
+        float currentRate = trackOf[c] < 0 ? rate[c] : 0.0f;
+        stopTrack(c);
+        values[c] = value;
+        setSegment(c, time, value, 0.0f, EASE_LINEAR);
+        rate[c] = currentRate;
+    }
+
+    // Keys sorted by time; the first segment runs from the current value
+    void play(Channel c, const std::vector<Keyframe>& keys) {
+        stopTrack(c);
+        if (keys.empty()) return;
+
+        Track track;
+        track.channel = c;
+        track.keys = keys;
+        track.startTime = time;
+        track.next = 0;
+        setSegment(c, time, keys[0].value, keys[0].time, keys[0].curve);
+        trackOf[c] = static_cast<int>(tracks.size());
+        tracks.push_back(track);
+    }
+
+    // Advances the sim clock and evaluates every channel in one batch
+    void update(float deltaTime) {
+        time += deltaTime;
+        advanceTracks();
+
+        size_t n = values.size();
+        size_t done = 0;
+#ifdef BUS_SIMD_X86
+        TransformKernel::SimdLevel level = TransformKernel::activeSimdLevel();
+        if (level == TransformKernel::SIMD_AVX2) done = evaluateAVX2(*this, time, values.data(), n);
+        else if (level == TransformKernel::SIMD_SSE2) done = evaluateSSE2(*this, time, values.data(), n);
+#endif
+        evaluateScalar(*this, time, values.data(), done, n);
+    }
+
+    float value(Channel c) const { return values[c]; }
+    float getRate(Channel c) const { return rate[c]; }
+    float getTime() const { return time; }
+
+    // No eased segment, track or rate left to play
+    bool isSettled(Channel c) const {
+        return trackOf[c] < 0 && rate[c] == 0.0f &&
+            (invDuration[c] == 0.0f || (time - startTime[c]) * invDuration[c] >= 1.0f);
+    }
+
+    size_t getChannelCount() const { return values.size(); }
+    size_t getActiveTrackCount() const { return tracks.size(); }
+};
+
+#endif
@@ -0,0 +1,164 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <new>
+#include <vector>
+
+// ==================== Arena Class ====================
+// Bump allocator for data that dies all at once (a bus's parts, their CPU
+// geometry). Allocating moves an offset through large blocks; nothing is
+// freed piece by piece except the latest allocation, which deallocate()
+// takes back (build-then-release sequences and growth at the top stay flat).
+// reset() rewinds to the first block but keeps every block, so whatever is
+// rebuilt in the same arena stops touching the heap after the first build.
+// Allocation takes a short lock: one model's geometry is built by several
+// pool tasks at once.
+class Arena {
+private:
+    struct Block {
+        unsigned char* data;
+        size_t size;
+    };
+
+    std::vector<Block> blocks;
+    size_t current;          // Block being filled
+    size_t offset;           // First free byte in it
+    size_t usedBytes;        // Handed out since reset(), alignment padding included
+    size_t highWater;
+    size_t blockSize;
+    mutable std::mutex mutex;
+
+public:
+    static const size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+
+    explicit Arena(size_t blockBytes = DEFAULT_BLOCK_SIZE)
+        : current(0), offset(0), usedBytes(0), highWater(0), blockSize(blockBytes) {
+    }
+
+    ~Arena() { release(); }
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    // 'alignment' must be a power of two
+    void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t)) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (bytes == 0) bytes = 1;
+        while (true) {
+            if (current == blocks.size()) {
+                Block block;
+                block.size = std::max(blockSize, bytes + alignment);
+                block.data = static_cast<unsigned char*>(::operator new(block.size));
+                blocks.push_back(block);
+            }
+
+            Block& block = blocks[current];
+            uintptr_t base = reinterpret_cast<uintptr_t>(block.data);
+            size_t start = static_cast<size_t>(((base + offset + alignment - 1) & ~(uintptr_t)(alignment - 1)) - base);
+            if (start + bytes <= block.size) {
+                usedBytes += start + bytes - offset;
+                highWater = std::max(highWater, usedBytes);
+                offset = start + bytes;
+                return block.data + start;
+            }
+            // The rest of this block is skipped until reset()
+            current++;
+            offset = 0;
+        }
+    }
+
+    template <typename T>
+    T* allocateArray(size_t count) {
+        return static_cast<T*>(allocate(count * sizeof(T), alignof(T)));
+    }
+
+    // Only the latest allocation is given back; anything else waits for reset()
+    void deallocate(void* pointer, size_t bytes) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (current >= blocks.size() || bytes == 0 || bytes > offset) return;
+        if (static_cast<unsigned char*>(pointer) != blocks[current].data + offset - bytes) return;
+        offset -= bytes;
+        usedBytes -= bytes;
+    }
+
+    // Everything allocated so far is dead; the blocks are kept
+    void reset() {
+        std::lock_guard<std::mutex> lock(mutex);
+        current = 0;
+        offset = 0;
+        usedBytes = 0;
+    }
+
+    // Returns the blocks to the heap
+    void release() {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const Block& block : blocks) ::operator delete(block.data);
+        blocks.clear();
+        current = 0;
+        offset = 0;
+        usedBytes = 0;
+    }
+
+    size_t getUsedBytes() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return usedBytes;
+    }
+
+    size_t getCapacity() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        size_t capacity = 0;
+        for (const Block& block : blocks) capacity += block.size;
+        return capacity;
+    }
+
+    void printInfo(const char* label) const {
+        std::lock_guard<std::mutex> lock(mutex);
+        size_t capacity = 0;
+        for (const Block& block : blocks) capacity += block.size;
+        std::cout << label << " arena: " << usedBytes / 1024 << " KB in use, " << highWater / 1024 << " KB peak, "
+            << capacity / 1024 << " KB in " << blocks.size() << (blocks.size() == 1 ? " block" : " blocks") << std::endl;
+    }
+};
+
+// ==================== ArenaAllocator Class ====================
+// Standard allocator over an Arena, for containers whose memory should live
+// there (ArenaVector). Without an arena it falls back to the heap, so the
+// same types work for standalone objects.
+template <typename T>
+class ArenaAllocator {
+public:
+    typedef T value_type;
+
+    Arena* arena;
+
+    ArenaAllocator() : arena(nullptr) {}
+    explicit ArenaAllocator(Arena* target) : arena(target) {}
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : arena(other.arena) {}
+
+    T* allocate(size_t count) {
+        if (!arena) return static_cast<T*>(::operator new(count * sizeof(T)));
+        return arena->allocateArray<T>(count);
+    }
+
+    void deallocate(T* pointer, size_t count) {
+        if (!arena) ::operator delete(pointer);
+        else arena->deallocate(pointer, count * sizeof(T));
+    }
+};
+
+template <typename T, typename U>
+inline bool operator==(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) { return a.arena == b.arena; }
+
+template <typename T, typename U>
+inline bool operator!=(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) { return a.arena != b.arena; }
+
+template <typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+#endif
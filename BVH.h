@@ -0,0 +1,292 @@
+#ifndef BVH_H
+#define BVH_H
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <vector>
+
+// ==================== BoundingBox Struct ====================
+struct BoundingBox {
+    glm::vec3 minCorner;
+    glm::vec3 maxCorner;
+
+    BoundingBox() : minCorner(FLT_MAX), maxCorner(-FLT_MAX) {}
+    BoundingBox(const glm::vec3& minC, const glm::vec3& maxC) : minCorner(minC), maxCorner(maxC) {}
+
+    void grow(const glm::vec3& point) {
+        minCorner = glm::min(minCorner, point);
+        maxCorner = glm::max(maxCorner, point);
+    }
+
+    void grow(const BoundingBox& box) {
+        minCorner = glm::min(minCorner, box.minCorner);
+        maxCorner = glm::max(maxCorner, box.maxCorner);
+    }
+
+    glm::vec3 center() const { return (minCorner + maxCorner) * 0.5f; }
+
+    float surfaceArea() const {
+        glm::vec3 d = glm::max(maxCorner - minCorner, glm::vec3(0.0f));
+        return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+    }
+
+    bool contains(const glm::vec3& point, float margin = 0.0f) const {
+        return point.x > minCorner.x - margin && point.x < maxCorner.x + margin &&
+            point.y > minCorner.y - margin && point.y < maxCorner.y + margin &&
+            point.z > minCorner.z - margin && point.z < maxCorner.z + margin;
+    }
+};
+
+// ==================== Ray Struct ====================
+// Segment origin + direction * t, t in [0, tMax]. The direction need not be
+// unit length: sweeps use the whole move as direction and t in [0, 1].
+struct Ray {
+    glm::vec3 origin;
+    glm::vec3 direction;
+    glm::vec3 inverseDirection;
+
+    Ray(const glm::vec3& o, const glm::vec3& d) : origin(o), direction(d) {
+        // Zero components become huge instead of inf, so 0 * inf never yields NaN
+        for (int i = 0; i < 3; i++) {
+            inverseDirection[i] = 1.0f / (std::fabs(d[i]) > 1e-12f ? d[i] : (d[i] < 0.0f ? -1e-12f : 1e-12f));
+        }
+    }
+
+    // Slab test against the box grown by 'inflate'. On a hit returns the
+    // entry t (0 if the origin is already inside) and the entered face normal.
+    bool intersect(const BoundingBox& box, float inflate, float tMax, float& tEntry, glm::vec3* normal = nullptr) const {
+        float tNear = 0.0f, tFar = tMax;
+        int axis = -1;
+        for (int i = 0; i < 3; i++) {
+            float t0 = (box.minCorner[i] - inflate - origin[i]) * inverseDirection[i];
+            float t1 = (box.maxCorner[i] + inflate - origin[i]) * inverseDirection[i];
+            if (t0 > t1) std::swap(t0, t1);
+            if (t0 > tNear) {
+                tNear = t0;
+                axis = i;
+            }
+            tFar = std::min(tFar, t1);
+            if (tNear > tFar) return false;
+        }
+        tEntry = tNear;
+        if (normal) {
+            *normal = glm::vec3(0.0f);
+            if (axis >= 0) (*normal)[axis] = direction[axis] > 0.0f ? -1.0f : 1.0f;
+        }
+        return true;
+    }
+};
+
+// ==================== BVH Class ====================
+// Bounding volume hierarchy over boxes, built with binned SAH (surface area
+// heuristic: split where the children's area-weighted item counts are
+// smallest). Nodes live in one array, children right after their parent
+// pair, so refit() is a single reverse pass: moving parts (doors) only
+// update their boxes instead of rebuilding the tree.
+// Queries return the nearest accepted item; the caller's filter decides what
+// an item hit means (skip enclosing shells, test finer geometry, ...).
+class BVH {
+public:
+    static const int MAX_LEAF_ITEMS = 2;
+    static const int BIN_COUNT = 12;
+    static const int MAX_DEPTH = 64;
+
+private:
+    struct Node {
+        BoundingBox bounds;
+        int first;           // Leaf: first entry in order; inner: left child (right = first + 1)
+        int count;           // Items in a leaf, 0 for inner nodes
+    };
+
+    std::vector<Node> nodes;
+    std::vector<int> order;            // Item ids, leaf ranges contiguous
+    std::vector<BoundingBox> boxes;    // Per item, as last given
+
+    void subdivide(int nodeIndex, int depth) {
+        Node& node = nodes[nodeIndex];
+        if (node.count <= MAX_LEAF_ITEMS || depth >= MAX_DEPTH) return;
+
+        BoundingBox centroidBounds;
+        for (int i = node.first; i < node.first + node.count; i++) centroidBounds.grow(boxes[order[i]].center());
+
+        // Cheapest split over the bins of every axis
+        float bestCost = FLT_MAX;
+        int bestAxis = -1;
+        float bestSplit = 0.0f;
+        for (int axis = 0; axis < 3; axis++) {
+            float lo = centroidBounds.minCorner[axis], hi = centroidBounds.maxCorner[axis];
+            if (hi - lo < 1e-6f) continue;
+
+            BoundingBox binBounds[BIN_COUNT];
+            int binCounts[BIN_COUNT] = {};
+            float scale = BIN_COUNT / (hi - lo);
+            for (int i = node.first; i < node.first + node.count; i++) {
+                const BoundingBox& box = boxes[order[i]];
+                int bin = std::min(BIN_COUNT - 1, static_cast<int>((box.center()[axis] - lo) * scale));
+                binCounts[bin]++;
+                binBounds[bin].grow(box);
+            }
+
+            float leftArea[BIN_COUNT - 1];
+            int leftCount[BIN_COUNT - 1];
+            BoundingBox sweep;
+            int count = 0;
+            for (int b = 0; b < BIN_COUNT - 1; b++) {
+                if (binCounts[b]) sweep.grow(binBounds[b]);
+                count += binCounts[b];
+                leftArea[b] = sweep.surfaceArea();
+                leftCount[b] = count;
+            }
+            sweep = BoundingBox();
+            count = 0;
+            for (int b = BIN_COUNT - 1; b > 0; b--) {
+                if (binCounts[b]) sweep.grow(binBounds[b]);
+                count += binCounts[b];
+                if (leftCount[b - 1] == 0 || count == 0) continue;
+                float cost = leftArea[b - 1] * leftCount[b - 1] + sweep.surfaceArea() * count;
+                if (cost < bestCost) {
+                    bestCost = cost;
+                    bestAxis = axis;
+                    bestSplit = lo + b / scale;
+                }
+            }
+        }
+
+        // Not splitting costs every item's test at this node's area
+        if (bestAxis < 0 || bestCost >= node.bounds.surfaceArea() * node.count) return;
+
+        int* begin = &order[node.first];
+        int* end = begin + node.count;
+        int* middle = std::partition(begin, end,
+            [this, bestAxis, bestSplit](int item) { return boxes[item].center()[bestAxis] < bestSplit; });
+        int leftCount = static_cast<int>(middle - begin);
+        if (leftCount == 0 || leftCount == node.count) return;
+
+        int left = static_cast<int>(nodes.size());
+        Node leftNode, rightNode;
+        leftNode.first = node.first;
+        leftNode.count = leftCount;
+        rightNode.first = node.first + leftCount;
+        rightNode.count = node.count - leftCount;
+        node.first = left;
+        node.count = 0;
+        nodes.push_back(leftNode);        // 'node' may dangle from here on
+        nodes.push_back(rightNode);
+
+        for (int child = left; child < left + 2; child++) {
+            nodes[child].bounds = BoundingBox();
+            for (int i = nodes[child].first; i < nodes[child].first + nodes[child].count; i++) {
+                nodes[child].bounds.grow(boxes[order[i]]);
+            }
+            subdivide(child, depth + 1);
+        }
+    }
+
+public:
+    void build(const std::vector<BoundingBox>& itemBoxes) {
+        boxes = itemBoxes;
+        nodes.clear();
+        order.resize(boxes.size());
+        for (size_t i = 0; i < order.size(); i++) order[i] = static_cast<int>(i);
+        if (boxes.empty()) return;
+
+        nodes.reserve(boxes.size() * 2);
+        Node root;
+        root.first = 0;
+        root.count = static_cast<int>(boxes.size());
+        for (const BoundingBox& box : boxes) root.bounds.grow(box);
+        nodes.push_back(root);
+        subdivide(0, 0);
+    }
+
+    // Same items, new boxes; the topology is kept, so quality slowly drops
+    // if items travel far from where they were at build()
+    void refit(const std::vector<BoundingBox>& itemBoxes) {
+        if (itemBoxes.size() != boxes.size()) {
+            build(itemBoxes);
+            return;
+        }
+        boxes = itemBoxes;
+        for (int n = static_cast<int>(nodes.size()) - 1; n >= 0; n--) {
+            Node& node = nodes[n];
+            node.bounds = BoundingBox();
+            if (node.count > 0) {
+                for (int i = node.first; i < node.first + node.count; i++) node.bounds.grow(boxes[order[i]]);
+            }
+            else {
+                node.bounds.grow(nodes[node.first].bounds);
+                node.bounds.grow(nodes[node.first + 1].bounds);
+            }
+        }
+    }
+
+    // Nearest item whose box, grown by 'inflate', the ray enters within
+    // tMax. accept(item, float& t, glm::vec3& normal) gets the box hit and
+    // rejects it, or refines t and normal against finer geometry (t only
+    // grows). On success tMax is the hit t.
+    template <typename Accept>
+    bool raycast(const Ray& ray, float inflate, float& tMax, int& hitItem, glm::vec3& hitNormal, Accept accept) const {
+        if (nodes.empty()) return false;
+
+        struct Entry { int node; float t; };
+        Entry stack[MAX_DEPTH * 2 + 2];
+        int top = 0;
+        bool found = false;
+        float tEntry;
+        glm::vec3 normal;
+        if (ray.intersect(nodes[0].bounds, inflate, tMax, tEntry)) stack[top++] = Entry{ 0, tEntry };
+
+        while (top > 0) {
+            Entry entry = stack[--top];
+            if (entry.t > tMax) continue;     // A nearer hit was found since it was pushed
+            const Node& node = nodes[entry.node];
+
+            if (node.count > 0) {
+                for (int i = node.first; i < node.first + node.count; i++) {
+                    int item = order[i];
+                    if (!ray.intersect(boxes[item], inflate, tMax, tEntry, &normal)) continue;
+                    if (!accept(item, tEntry, normal) || tEntry > tMax) continue;
+                    tMax = tEntry;
+                    hitItem = item;
+                    hitNormal = normal;
+                    found = true;
+                }
+                continue;
+            }
+
+            // Nearer child on top of the stack, so it can shrink tMax for the other
+            float tLeft, tRight;
+            bool hitLeft = ray.intersect(nodes[node.first].bounds, inflate, tMax, tLeft);
+            bool hitRight = ray.intersect(nodes[node.first + 1].bounds, inflate, tMax, tRight);
+            if (hitLeft && hitRight) {
+                if (tLeft <= tRight) {
+                    stack[top++] = Entry{ node.first + 1, tRight };
+                    stack[top++] = Entry{ node.first, tLeft };
+                }
+                else {
+                    stack[top++] = Entry{ node.first, tLeft };
+                    stack[top++] = Entry{ node.first + 1, tRight };
+                }
+            }
+            else if (hitLeft) stack[top++] = Entry{ node.first, tLeft };
+            else if (hitRight) stack[top++] = Entry{ node.first + 1, tRight };
+        }
+        return found;
+    }
+
+    BoundingBox getBounds() const { return nodes.empty() ? BoundingBox() : nodes[0].bounds; }
+    const BoundingBox& getItemBounds(int item) const { return boxes[item]; }
+    size_t getItemCount() const { return boxes.size(); }
+    size_t getNodeCount() const { return nodes.size(); }
+
+    void clear() {
+        nodes.clear();
+        order.clear();
+        boxes.clear();
+    }
+};
+
+#endif
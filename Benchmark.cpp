@@ -0,0 +1,680 @@
+// ==================== CPU Microbenchmarks ====================
+// Scene construction and camera math hot paths, measured without a GL context:
+// only CPU-side code runs, the GL entry points are linked (glad) but never called.
+// Output follows the Google Benchmark console/JSON format so results can be
+// tracked with the usual tooling (e.g. compare.py).
+//
+// Build (Linux):
+//   g++ -std=c++14 -O2 -I<path to glad/glm includes> Benchmark.cpp glad.c -pthread -o bus_bench
+// Run:
+//   ./bus_bench --benchmark_out=results.json [--benchmark_filter=<regex>] [--benchmark_min_time=<seconds>]
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+extern const unsigned int SCR_WIDTH = 800;
+extern const unsigned int SCR_HEIGHT = 600;
+
+#include "Shader.h"
+#include "Vertices.h"
+#include "ThreadPool.h"
+#include "JobSystem.h"
+#include "Arena.h"
+#include "PartPool.h"
+#include "MeshOptimizer.h"
+#include "FaceCuller.h"
+#include "BVH.h"
+#include "MeshBuffer.h"
+#include "AnimatedMesh.h"
+#include "DrawList.h"
+#include "ClusteredLighting.h"
+#include "TransformKernel.h"
+#include "AnimationSystem.h"
+#include "FleetSimulation.h"
+#include "Class.h"
+#include "PortalRenderer.h"
+#include "BusModel.h"
+#include "OcclusionCuller.h"
+#include "BusInterior.h"
+#include "Camera.h"
+#include "CollisionWorld.h"
+#include "PerformanceHud.h"
+
+// ==================== Benchmark Harness ====================
+class BenchmarkState {
+private:
+    size_t iterations;
+    size_t remaining;
+    double itemsProcessed;
+    std::chrono::steady_clock::time_point realStart;
+    std::clock_t cpuStart;
+    double realSeconds;
+    double cpuSeconds;
+
+public:
+    explicit BenchmarkState(size_t n)
+        : iterations(n), remaining(n), itemsProcessed(0.0), cpuStart(0), realSeconds(0.0), cpuSeconds(0.0) {
+    }
+
+    // Loop condition; only the loop itself is timed, setup before it is not
+    bool keepRunning() {
+        if (remaining == iterations) {
+            realStart = std::chrono::steady_clock::now();
+            cpuStart = std::clock();
+        }
+        if (remaining == 0) {
+            cpuSeconds = static_cast<double>(std::clock() - cpuStart) / CLOCKS_PER_SEC;
+            realSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - realStart).count();
+            return false;
+        }
+        remaining--;
+        return true;
+    }
+
+    size_t maxIterations() const { return iterations; }
+    void setItemsProcessed(double items) { itemsProcessed = items; }
+    double getItemsProcessed() const { return itemsProcessed; }
+    double getRealSeconds() const { return realSeconds; }
+    double getCpuSeconds() const { return cpuSeconds; }
+};
+
+// Keeps the compiler from discarding a result computed only for timing
+template <typename T>
+inline void doNotOptimize(const T& value) {
+#if defined(_MSC_VER)
+    static volatile const void* sink;
+    sink = &value;
+    _ReadWriteBarrier();
+#else
+    asm volatile("" : : "g"(&value) : "memory");
+#endif
+}
+
+struct BenchmarkResult {
+    std::string name;
+    size_t iterations;
+    double realTime;           // ns per iteration
+    double cpuTime;            // ns per iteration
+    double itemsPerSecond;     // 0 = not reported
+};
+
+class BenchmarkRunner {
+private:
+    struct Entry {
+        std::string name;
+        std::function<void(BenchmarkState&)> function;
+    };
+
+    std::vector<Entry> entries;
+    double minTime;
+
+    BenchmarkResult run(const Entry& entry) const {
+        size_t n = 1;
+        while (true) {
+            BenchmarkState state(n);
+            entry.function(state);
+            double real = state.getRealSeconds();
+            double cpu = state.getCpuSeconds();
+
+            // Grow until one run covers the minimum time, as Google Benchmark does
+            if (real >= minTime || n >= 1000000000) {
+                BenchmarkResult result;
+                result.name = entry.name;
+                result.iterations = n;
+                result.realTime = real * 1e9 / n;
+                result.cpuTime = cpu * 1e9 / n;
+                result.itemsPerSecond = (state.getItemsProcessed() > 0.0 && real > 0.0)
+                    ? state.getItemsProcessed() / real : 0.0;
+                return result;
+            }
+
+            double multiplier = real > 0.0 ? minTime * 1.4 / real : 10.0;
+            if (multiplier > 10.0) multiplier = 10.0;
+            if (multiplier < 1.4) multiplier = 1.4;
+            n = static_cast<size_t>(n * multiplier) + 1;
+        }
+    }
+
+    static std::string currentDate() {
+        std::time_t now = std::time(nullptr);
+        std::tm local;
+#if defined(_MSC_VER)
+        localtime_s(&local, &now);
+#else
+        localtime_r(&now, &local);
+#endif
+        char buffer[32];
+        std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%S", &local);
+        return buffer;
+    }
+
+    static std::string jsonEscape(const std::string& text) {
+        std::string out;
+        for (char c : text) {
+            if (c == '"' || c == '\\') out += '\\';
+            out += c;
+        }
+        return out;
+    }
+
+public:
+    BenchmarkRunner() : minTime(0.5) {}
+
+    void add(const std::string& name, std::function<void(BenchmarkState&)> function) {
+        entries.push_back({ name, function });
+    }
+
+    void setMinTime(double seconds) { minTime = seconds; }
+
+    void list(const std::string& filter) const {
+        std::regex pattern(filter);
+        for (const auto& entry : entries) {
+            if (std::regex_search(entry.name, pattern)) std::cout << entry.name << std::endl;
+        }
+    }
+
+    std::vector<BenchmarkResult> runAll(const std::string& filter) const {
+        std::regex pattern(filter);
+        std::vector<BenchmarkResult> results;
+
+        char line[160];
+        std::snprintf(line, sizeof(line), "%-40s %15s %15s %12s", "Benchmark", "Time", "CPU", "Iterations");
+        std::cout << line << "\n" << std::string(85, '-') << std::endl;
+
+        for (const auto& entry : entries) {
+            if (!std::regex_search(entry.name, pattern)) continue;
+
+            BenchmarkResult result = run(entry);
+            results.push_back(result);
+
+            std::snprintf(line, sizeof(line), "%-40s %12.1f ns %12.1f ns %12zu",
+                result.name.c_str(), result.realTime, result.cpuTime, result.iterations);
+            std::cout << line;
+            if (result.itemsPerSecond > 0.0) {
+                std::snprintf(line, sizeof(line), " items_per_second=%.4gM/s", result.itemsPerSecond / 1e6);
+                std::cout << line;
+            }
+            std::cout << std::endl;
+        }
+        return results;
+    }
+
+    // Same top-level layout as Google Benchmark's JSON reporter
+    static bool writeJson(const std::string& path, const std::vector<BenchmarkResult>& results,
+        const char* executable) {
+        std::ofstream file(path);
+        if (!file) {
+            std::cerr << "ERROR::BENCHMARK::CANNOT_WRITE " << path << std::endl;
+            return false;
+        }
+
+        file << "{\n  \"context\": {\n";
+        file << "    \"date\": \"" << currentDate() << "\",\n";
+        file << "    \"executable\": \"" << jsonEscape(executable) << "\",\n";
+        file << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n";
+        file << "    \"simd_level\": \""
+            << TransformKernel::simdLevelName(TransformKernel::activeSimdLevel()) << "\",\n";
+#ifdef NDEBUG
+        file << "    \"library_build_type\": \"release\"\n";
+#else
+        file << "    \"library_build_type\": \"debug\"\n";
+#endif
+        file << "  },\n  \"benchmarks\": [\n";
+
+        for (size_t i = 0; i < results.size(); i++) {
+            const BenchmarkResult& r = results[i];
+            file << "    {\n";
+            file << "      \"name\": \"" << jsonEscape(r.name) << "\",\n";
+            file << "      \"run_name\": \"" << jsonEscape(r.name) << "\",\n";
+            file << "      \"run_type\": \"iteration\",\n";
+            file << "      \"repetitions\": 1,\n";
+            file << "      \"repetition_index\": 0,\n";
+            file << "      \"threads\": 1,\n";
+            file << "      \"iterations\": " << r.iterations << ",\n";
+            file << "      \"real_time\": " << r.realTime << ",\n";
+            file << "      \"cpu_time\": " << r.cpuTime << ",\n";
+            file << "      \"time_unit\": \"ns\"";
+            if (r.itemsPerSecond > 0.0) file << ",\n      \"items_per_second\": " << r.itemsPerSecond;
+            file << "\n    }" << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+        file << "  ]\n}\n";
+        return true;
+    }
+};
+
+// ==================== Benchmarks ====================
+// Synthetic part transforms shaped like the bus parts (mostly unrotated boxes,
+// every fourth part spinning about Z like a wheel)
+static TransformBatch makeBatch(size_t n) {
+    TransformBatch batch;
+    batch.reserve(n);
+    for (size_t i = 0; i < n; i++) {
+        float f = static_cast<float>(i);
+        glm::vec3 position(std::fmod(f * 0.37f, 8.0f) - 3.5f, std::fmod(f * 0.11f, 2.0f) - 1.0f, std::fmod(f * 0.23f, 2.0f) - 1.0f);
+        glm::vec3 scale(0.1f + std::fmod(f * 0.07f, 1.0f), 0.1f + std::fmod(f * 0.05f, 0.5f), 0.05f);
+        if (i % 4 == 3) batch.add(position, glm::vec3(1.0f), glm::radians(90.0f + f), glm::vec3(0.0f, 0.0f, 1.0f));
+        else batch.add(position, scale);
+    }
+    return batch;
+}
+
+static void registerBenchmarks(BenchmarkRunner& runner) {
+    runner.add("Cylinder/CreateGeometry", [](BenchmarkState& state) {
+        Cylinder wheel(glm::vec3(-3.1f, -1.0f, 1.0f), 0.4f, 0.2f, glm::vec3(0.1f));
+        while (state.keepRunning()) {
+            wheel.createGeometry();
+            doNotOptimize(wheel);
+        }
+        });
+
+    runner.add("WheelSpokes/CreateSpokes", [](BenchmarkState& state) {
+        WheelSpokes spokes(glm::vec3(-3.1f, -1.0f, 1.0f), 0.25f, 0.22f);
+        while (state.keepRunning()) {
+            spokes.createSpokes(6);
+            doNotOptimize(spokes);
+        }
+        });
+
+    runner.add("BusModel/Build", [](BenchmarkState& state) {
+        while (state.keepRunning()) {
+            BusModel bus;
+            bus.build();
+            doNotOptimize(bus);
+        }
+        });
+
+    // Spawn builds a new bus (parts and CPU geometry) every iteration;
+    // Respawn recycles one, reusing its arenas and pools
+    runner.add("BusModel/Spawn", [](BenchmarkState& state) {
+        while (state.keepRunning()) {
+            BusModel bus;
+            bus.build();
+            bus.createGeometry();
+            doNotOptimize(bus);
+        }
+        });
+
+    runner.add("BusModel/Respawn", [](BenchmarkState& state) {
+        BusModel bus;
+        bus.build();
+        bus.createGeometry();
+        while (state.keepRunning()) {
+            bus.reset();
+            bus.build();
+            bus.createGeometry();
+            doNotOptimize(bus);
+        }
+        });
+
+    runner.add("BusInterior/Build", [](BenchmarkState& state) {
+        while (state.keepRunning()) {
+            BusInterior interior;
+            interior.build();
+            doNotOptimize(interior);
+        }
+        });
+
+    runner.add("Camera/UpdateVectors", [](BenchmarkState& state) {
+        Camera camera;
+        while (state.keepRunning()) {
+            camera.rotateYaw(0.01f);
+            doNotOptimize(camera);
+        }
+        });
+
+    runner.add("Camera/UpdateVectorsWithRoll", [](BenchmarkState& state) {
+        Camera camera;
+        while (state.keepRunning()) {
+            camera.rotateRoll(0.01f);
+            doNotOptimize(camera);
+        }
+        });
+
+    runner.add("Camera/GetViewMatrix", [](BenchmarkState& state) {
+        Camera camera;
+        while (state.keepRunning()) {
+            glm::mat4 view = camera.getViewMatrix();
+            doNotOptimize(view);
+        }
+        });
+
+    runner.add("BusModel/Submit", [](BenchmarkState& state) {
+        BusModel bus;
+        bus.build();
+        DrawList list;
+        glm::mat4 baseModel(1.0f);
+        while (state.keepRunning()) {
+            list.clear();
+            bus.submit(list, baseModel);
+            doNotOptimize(list);
+        }
+        state.setItemsProcessed(static_cast<double>(state.maxIterations()) * list.size());
+        });
+
+    runner.add("BusInterior/Submit", [](BenchmarkState& state) {
+        BusInterior interior;
+        interior.build();
+        DrawList list;
+        glm::mat4 baseModel(1.0f);
+        while (state.keepRunning()) {
+            list.clear();
+            interior.submit(list, baseModel);
+            doNotOptimize(list);
+        }
+        state.setItemsProcessed(static_cast<double>(state.maxIterations()) * list.size());
+        });
+
+    runner.add("DrawList/SortFrontToBack", [](BenchmarkState& state) {
+        BusInterior interior;
+        interior.build();
+        DrawList list;
+        interior.submit(list, glm::mat4(1.0f));
+        glm::vec3 eye(0.0f, 5.0f, 15.0f);
+        int step = 0;
+        while (state.keepRunning()) {
+            // Moving eye, so every iteration really reorders the list
+            eye.x = static_cast<float>(step++ % 16) - 8.0f;
+            list.sortFrontToBack(eye);
+            doNotOptimize(list);
+        }
+        state.setItemsProcessed(static_cast<double>(state.maxIterations()) * list.size());
+        });
+
+    // Per-part matrix building: the glm chain used by draw() against the batch kernel
+    const size_t partCounts[] = { 64, 4096, 262144 };
+    for (size_t n : partCounts) {
+        std::string suffix = "/" + std::to_string(n);
+
+        runner.add("PartMatrices/GlmChain" + suffix, [n](BenchmarkState& state) {
+            TransformBatch batch = makeBatch(n);
+            std::vector<glm::mat4> out(n);
+            glm::mat4 parent = glm::translate(glm::mat4(1.0f), glm::vec3(2.0f, 0.0f, 0.0f));
+            glm::vec3 zAxis(0.0f, 0.0f, 1.0f);
+            std::vector<float> angles(n);
+            for (size_t i = 0; i < n; i++) angles[i] = 2.0f * std::atan2(batch.qz[i], batch.qw[i]);
+
+            while (state.keepRunning()) {
+                for (size_t i = 0; i < n; i++) {
+                    glm::mat4 model = glm::translate(parent, glm::vec3(batch.tx[i], batch.ty[i], batch.tz[i]));
+                    if (angles[i] != 0.0f) model = glm::rotate(model, angles[i], zAxis);
+                    out[i] = glm::scale(model, glm::vec3(batch.sx[i], batch.sy[i], batch.sz[i]));
+                }
+                doNotOptimize(out[0]);
+            }
+            state.setItemsProcessed(static_cast<double>(state.maxIterations()) * n);
+            });
+
+        const TransformKernel::SimdLevel levels[] = {
+            TransformKernel::SIMD_SCALAR, TransformKernel::SIMD_SSE2, TransformKernel::SIMD_AVX2 };
+        for (TransformKernel::SimdLevel level : levels) {
+            if (level > TransformKernel::activeSimdLevel()) continue;
+
+            runner.add(std::string("PartMatrices/") + TransformKernel::simdLevelName(level) + suffix,
+                [n, level](BenchmarkState& state) {
+                TransformBatch batch = makeBatch(n);
+                std::vector<glm::mat4> out(n);
+                glm::mat4 parent = glm::translate(glm::mat4(1.0f), glm::vec3(2.0f, 0.0f, 0.0f));
+                while (state.keepRunning()) {
+                    TransformKernel::computeWorldMatrices(batch, parent, out.data(), level);
+                    doNotOptimize(out[0]);
+                }
+                state.setItemsProcessed(static_cast<double>(state.maxIterations()) * n);
+                });
+        }
+    }
+
+    // Fleet animation: per bus a door (eased), wheel (rate) and light (keyframe) channel
+    const size_t channelCounts[] = { 64, 4096, 262144 };
+    for (size_t n : channelCounts) {
+        runner.add("Animation/Update/" + std::to_string(n), [n](BenchmarkState& state) {
+            AnimationSystem animation;
+            std::vector<AnimationSystem::Channel> channels;
+            for (size_t i = 0; i < n; i++) channels.push_back(animation.addChannel(0.0f));
+            for (size_t i = 0; i < n; i++) {
+                if (i % 3 == 0) animation.animateTo(channels[i], 1.0f, 0.8f);
+                else if (i % 3 == 1) animation.setRate(channels[i], 200.0f);
+                else if (i % 96 == 2) animation.play(channels[i], { { 0.1f, 1.0f, EASE_LINEAR }, { 0.3f, 0.0f, EASE_OUT } });
+            }
+            while (state.keepRunning()) {
+                animation.update(1.0f / 60.0f);
+                doNotOptimize(animation);
+            }
+            state.setItemsProcessed(static_cast<double>(state.maxIterations()) * n);
+            });
+    }
+
+    // Fleet kinematics: one fixed step of 10k buses (three batches) on a 125 km
+    // loop with a stop every 400 m, per SIMD level on one thread, then as batch jobs
+    auto makeFleet = [](FleetSimulation& fleet) {
+        std::vector<glm::vec2> points;
+        const int controlPoints = 256;                  // About 490 units apart
+        const float radius = 20000.0f;
+        for (int i = 0; i < controlPoints; i++) {
+            float angle = 2.0f * 3.14159265f * static_cast<float>(i) / controlPoints;
+            points.push_back(glm::vec2(radius * std::cos(angle), radius * std::sin(angle)));
+        }
+        fleet.getRoute().build(points);
+        for (float d = 200.0f; d < fleet.getRoute().getLength(); d += 400.0f) fleet.getRoute().addStop(d);
+        fleet.spawn(10000);
+        for (int i = 0; i < 600; i++) fleet.step();     // Past the start, a mix of moving and dwelling
+    };
+    const TransformKernel::SimdLevel fleetLevels[] = {
+        TransformKernel::SIMD_SCALAR, TransformKernel::SIMD_SSE2, TransformKernel::SIMD_AVX2 };
+    for (TransformKernel::SimdLevel level : fleetLevels) {
+        if (level > TransformKernel::activeSimdLevel()) continue;
+
+        runner.add(std::string("Fleet/Step/") + TransformKernel::simdLevelName(level) + "/10000",
+            [makeFleet, level](BenchmarkState& state) {
+            FleetSimulation fleet;
+            makeFleet(fleet);
+            fleet.setSimdLevel(level);
+            while (state.keepRunning()) {
+                fleet.step();
+                doNotOptimize(fleet);
+            }
+            state.setItemsProcessed(static_cast<double>(state.maxIterations()) * fleet.size());
+            });
+    }
+    runner.add("Fleet/Step/Jobs/10000", [makeFleet](BenchmarkState& state) {
+        FleetSimulation fleet;
+        makeFleet(fleet);
+        JobSystem jobs;
+        while (state.keepRunning()) {
+            fleet.step(jobs);
+            doNotOptimize(fleet);
+        }
+        state.setItemsProcessed(static_cast<double>(state.maxIterations()) * fleet.size());
+        });
+
+    // Load-time mesh optimization of one wheel (weld, Tipsify, overdraw and fetch order)
+    runner.add("MeshOptimizer/Cylinder", [](BenchmarkState& state) {
+        Cylinder wheel(glm::vec3(0.0f), 0.5f, 0.3f, glm::vec3(0.1f));
+        wheel.createGeometry();
+        while (state.keepRunning()) {
+            std::vector<float> vertices(wheel.getVertices().begin(), wheel.getVertices().end());
+            std::vector<unsigned int> indices(wheel.getIndices().begin(), wheel.getIndices().end());
+            MeshOptimizer::optimize(vertices, indices);
+            doNotOptimize(indices);
+        }
+        state.setItemsProcessed(static_cast<double>(state.maxIterations()) * wheel.getIndices().size() / 3);
+        });
+
+    // Clustered light culling: lights scattered along the road ahead of the camera
+    const size_t lightCounts[] = { 64, 256, 1024 };
+    for (size_t n : lightCounts) {
+        runner.add("Lighting/Cull/" + std::to_string(n), [n](BenchmarkState& state) {
+            ClusteredLighting lighting;
+            uint32_t seed = 12345;
+            auto random01 = [&seed]() {
+                seed = seed * 1664525u + 1013904223u;
+                return static_cast<float>(seed >> 8) / static_cast<float>(1u << 24);
+            };
+            for (size_t i = 0; i < n; i++) {
+                PointLight light;
+                light.position = glm::vec3(-random01() * 200.0f, random01() * 6.0f - 1.0f, random01() * 40.0f - 20.0f);
+                light.radius = 4.0f + random01() * 10.0f;
+                light.color = glm::vec3(1.0f, 0.8f, 0.6f);
+                light.intensity = 5.0f;
+                lighting.addLight(light);
+            }
+            glm::mat4 view = glm::lookAt(glm::vec3(5.0f, 2.0f, 0.0f), glm::vec3(-10.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+            glm::mat4 projection = glm::perspective(glm::radians(45.0f), 800.0f / 600.0f, 0.1f, 224.0f);
+            while (state.keepRunning()) {
+                lighting.cull(view, projection, 0.1f, 224.0f);
+                doNotOptimize(lighting);
+            }
+            state.setItemsProcessed(static_cast<double>(state.maxIterations()) * n);
+            });
+    }
+
+    // Fleet picking: buses sharing one part tree on a grid, top-level refit
+    // plus a fan of pick rays and one camera sweep per iteration
+    const size_t fleetSizes[] = { 100, 1000, 4000 };
+    for (size_t n : fleetSizes) {
+        runner.add("Collision/PickFleet/" + std::to_string(n), [n](BenchmarkState& state) {
+            BusModel bus;
+            bus.build();
+            CollisionWorld collision;
+            size_t columns = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(n))));
+            for (size_t i = 0; i < n; i++) {
+                int instance = collision.addInstance(&bus.getPartTree(), 0);
+                glm::vec3 offset(static_cast<float>(i % columns) * 12.0f, 0.0f, static_cast<float>(i / columns) * 6.0f);
+                collision.setTransform(instance, glm::translate(glm::mat4(1.0f), offset));
+            }
+            collision.update();
+
+            const int rayCount = 64;
+            glm::vec3 eye(-20.0f, 8.0f, -20.0f);
+            size_t hits = 0;
+            while (state.keepRunning()) {
+                collision.update();
+                for (int r = 0; r < rayCount; r++) {
+                    float angle = r * 0.02f;
+                    CollisionWorld::Hit hit;
+                    if (collision.pick(eye, glm::vec3(std::cos(angle), -0.1f, std::sin(angle)), 500.0f, hit)) hits++;
+                }
+                glm::vec3 moved = collision.moveSphere(glm::vec3(-2.0f, 0.0f, 3.0f), glm::vec3(2.0f, 0.0f, -3.0f), 0.2f);
+                doNotOptimize(moved);
+            }
+            doNotOptimize(hits);
+            state.setItemsProcessed(static_cast<double>(state.maxIterations()) * (rayCount + 1));
+            });
+    }
+
+    // Fleet frame: per bus, draw-list recording and sorting, then one merge.
+    // Serial runs it on one thread; Jobs as a per-frame job graph (one job
+    // per bus, the merge depending on all of them) on the work-stealing system.
+    const size_t busCounts[] = { 8, 64, 256 };
+    for (size_t n : busCounts) {
+        for (int threaded = 0; threaded < 2; threaded++) {
+            std::string name = std::string("JobSystem/FleetFrame/") + (threaded ? "Jobs/" : "Serial/") + std::to_string(n);
+            runner.add(name, [n, threaded](BenchmarkState& state) {
+                std::vector<BusModel> fleet(n);
+                std::vector<DrawList> lists(n);
+                std::vector<glm::mat4> baseModels(n);
+                for (size_t i = 0; i < n; i++) {
+                    fleet[i].build();
+                    baseModels[i] = glm::translate(glm::mat4(1.0f), glm::vec3(static_cast<float>(i % 16) * 12.0f, 0.0f, static_cast<float>(i / 16) * 6.0f));
+                }
+                DrawList frameList;
+                glm::vec3 eye(-20.0f, 8.0f, -20.0f);
+                auto recordBus = [&](size_t i) {
+                    lists[i].clear();
+                    fleet[i].submit(lists[i], baseModels[i]);
+                    lists[i].sortFrontToBack(eye);
+                };
+                auto merge = [&] {
+                    frameList.clear();
+                    for (const DrawList& list : lists) frameList.append(list);
+                };
+
+                JobSystem jobs;
+                JobGraph frameJobs;
+                std::vector<JobGraph::Job> busJobs(n);
+                while (state.keepRunning()) {
+                    if (threaded) {
+                        frameJobs.reset();
+                        for (size_t i = 0; i < n; i++) busJobs[i] = frameJobs.add("bus", [&recordBus, i] { recordBus(i); });
+                        JobGraph::Job mergeJob = frameJobs.add("merge", merge);
+                        for (size_t i = 0; i < n; i++) frameJobs.addDependency(mergeJob, busJobs[i]);
+                        jobs.run(frameJobs);
+                        jobs.waitAll(frameJobs);
+                    }
+                    else {
+                        for (size_t i = 0; i < n; i++) recordBus(i);
+                        merge();
+                    }
+                    doNotOptimize(frameList);
+                }
+                state.setItemsProcessed(static_cast<double>(state.maxIterations()) * n);
+                });
+        }
+    }
+
+    // CPU side of the overlay: a full graph plus the lines the main loop adds
+    runner.add("Hud/Build", [](BenchmarkState& state) {
+        PerformanceHud hud;
+        for (int i = 0; i < 240; i++) hud.addFrameTime(12.0f + static_cast<float>(i % 25));
+        size_t quads = 0;
+        while (state.keepRunning()) {
+            hud.addLine("Draws %u, triangles %u", 152u, 12480u);
+            hud.addLine("Culled %d of %d interior groups (occlusion)", 3, 8);
+            hud.addLine("GPU");
+            hud.extendLine(" %s %.3f ms", "scene", 0.412);
+            hud.extendLine(" %s %.3f ms", "hud", 0.011);
+            hud.addLine("GPU memory: meshes %u KB, detail %u/%u KB, targets %u KB", 1210u, 342u, 65536u, 0u);
+            quads = hud.build();
+            hud.clearLines();
+            doNotOptimize(quads);
+        }
+        });
+}
+
+int main(int argc, char** argv) {
+    std::string filter = ".*";
+    std::string outPath;
+    bool listOnly = false;
+
+    BenchmarkRunner runner;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg.compare(0, 19, "--benchmark_filter=") == 0) filter = arg.substr(19);
+        else if (arg.compare(0, 16, "--benchmark_out=") == 0) outPath = arg.substr(16);
+        else if (arg.compare(0, 21, "--benchmark_min_time=") == 0) runner.setMinTime(std::atof(arg.c_str() + 21));
+        else if (arg == "--benchmark_list_tests") listOnly = true;
+        else {
+            std::cerr << "Unknown argument: " << arg << std::endl;
+            std::cerr << "Usage: " << argv[0] << " [--benchmark_filter=<regex>] [--benchmark_out=<file.json>]"
+                << " [--benchmark_min_time=<seconds>] [--benchmark_list_tests]" << std::endl;
+            return 1;
+        }
+    }
+
+    registerBenchmarks(runner);
+
+    if (listOnly) {
+        runner.list(filter);
+        return 0;
+    }
+
+    std::vector<BenchmarkResult> results = runner.runAll(filter);
+    if (!outPath.empty() && !BenchmarkRunner::writeJson(outPath, results, argv[0])) return 1;
+    return 0;
+}
@@ -5,13 +5,31 @@
 #include <glm/gtc/type_ptr.hpp>
 #include <iostream>
 #include <vector>
+#include <chrono>
 #include <cmath>
 #include <fstream>
 #include <sstream>
+#include <cstdlib>
 #include "Shader.h"
 #include "Vertices.h"
+#include "ThreadPool.h"
+#include "JobSystem.h"
+#include "Arena.h"
+#include "PartPool.h"
+#include "MeshOptimizer.h"
+#include "FaceCuller.h"
+#include "BVH.h"
+#include "MeshBuffer.h"
+#include "AnimatedMesh.h"
+#include "DrawList.h"
+#include "ClusteredLighting.h"
+#include "TransformKernel.h"
+#include "AnimationSystem.h"
+#include "FleetSimulation.h"
 #include "Class.h"
+#include "PortalRenderer.h"
 #include "BusModel.h"
+#include "OcclusionCuller.h"
 #include "BusInterior.h"
 
 // Constants
@@ -19,6 +37,76 @@ const unsigned int SCR_WIDTH = 800;
 const unsigned int SCR_HEIGHT = 600;
 
 #include "Camera.h"
+#include "OverdrawMeter.h"
+#include "MultiViewRenderer.h"
+#include "StartupTimer.h"
+#include "ResidencyManager.h"
+#include "WorldStreamer.h"
+#include "FramePacer.h"
+#include "RenderGraph.h"
+#include "CollisionWorld.h"
+#include "FrameCapture.h"
+#include "IdleTracker.h"
+#include "PerformanceHud.h"
+#include "Metrics.h"
+#include "GlTrace.h"
+
+// Interior residency: built in the background once the camera is this close
+// to the bus, drawn through the windows only within the draw distance
+const float INTERIOR_PREFETCH_DISTANCE = 30.0f;
+const float INTERIOR_DRAW_DISTANCE = 20.0f;
+
+// Night scene for clustered lighting: sky and the light every surface gets
+const glm::vec3 NIGHT_SKY(0.02f, 0.03f, 0.08f);
+const glm::vec3 NIGHT_AMBIENT(0.06f, 0.07f, 0.12f);
+
+// Picking and free-flight camera collision
+enum PickTag { PICK_EXTERIOR, PICK_INTERIOR };
+const float CAMERA_RADIUS = 0.2f;       // Above the near plane, so walls never clip into view
+const float PICK_DISTANCE = 500.0f;
+const int HEADLESS_FRAMES = 300;
+const int DEFAULT_METRICS_PORT = 9464;
+
+// Fleet: buses on both lanes of the road, out to a turning loop at each end
+const int DEFAULT_FLEET_SIZE = 2000;                // With a bare --fleet; off unless asked for
+const float FLEET_ROUTE_HALF_SPAN = 10000.0f;     // Straights from x = -span to span
+const float FLEET_LANE_OFFSET = 2.6f;             // Clear of the player's bus on the centre line
+const float FLEET_LOOP_RADIUS = 20.0f;
+const float FLEET_STOP_SPACING = 400.0f;
+const float FLEET_DRAW_DISTANCE = 200.0f;
+const size_t MAX_FLEET_DRAWN = 32;
+
+// Renderer toggles shared between the input handler and the main loop
+struct RenderSettings {
+    bool depthPrepass;       // Depth-only pass before the color pass
+    bool measureOverdraw;    // Debug: count fragments per pixel
+    bool overdrawToggled;    // Set on toggle so the meter restarts its average
+    bool portals;            // Exterior and interior together, interior seen through windows
+    bool multiView;          // Main camera plus driver and interior cameras in one frame
+    bool viewArray;          // Multi-view through the viewport array when supported
+    bool infoRequested;      // Set by I so the main loop prints renderer stats
+    size_t detailBudget;     // GPU bytes for optional detail sets (interior, ...)
+    bool gpuAnimation;       // Bus exterior from one static buffer, animated in the vertex shader
+    bool clusteredLighting;  // Night scene lit by headlights, cabin and street lamps (single view)
+    bool vsync;              // Swap interval 1
+    bool lowLatency;         // Fence wait: at most one frame in flight
+    int frameLimit;          // Frames per second, 0 = unlimited
+    bool pacingChanged;      // Set on any of the above so the main loop reapplies them
+    bool cameraCollision;    // Free-flight camera stops at (and slides along) bus parts
+    bool pickRequested;      // Set by a left click; the main loop casts the ray
+    double pickX, pickY;     // Cursor position of the click, window coordinates
+    bool captureToggled;     // Set by F3 so the main loop starts or stops recording
+    bool capturePng;         // Format of the recording F3 starts: PNG frames instead of Y4M
+    bool idleRendering;      // Stop rendering (and sleep) while nothing on screen changes
+    bool showHud;            // Performance overlay: frame-time graph, draw counts, GPU pass times
+    bool showFleet;          // Draw the fleet buses near the camera (single view)
+
+    RenderSettings() : depthPrepass(false), measureOverdraw(false), overdrawToggled(false), portals(true),
+        multiView(false), viewArray(true), infoRequested(false), detailBudget(64u * 1024u * 1024u),
+        gpuAnimation(false), clusteredLighting(false), vsync(true), lowLatency(false), frameLimit(0), pacingChanged(false),
+        cameraCollision(true), pickRequested(false), pickX(0.0), pickY(0.0), captureToggled(false), capturePng(false),
+        idleRendering(true), showHud(false), showFleet(true) {}
+};
 
 // Forward declarations
 class Cube;
@@ -36,10 +124,11 @@ private:
     Camera& camera;
     BusModel& bus;
     BusInterior& interior;
-    float& wheelRotation;
     bool& showInterior;
+    RenderSettings& settings;
     bool fullscreen;
     float deltaTime;
+    bool activity;           // An input or window event arrived since consumeActivity()
 
     static InputHandler* instance;
 
@@ -51,10 +140,28 @@ private:
         if (instance) instance->scrollCallback(win, xoffset, yoffset);
     }
 
+    static void mouseButtonCallbackStatic(GLFWwindow* win, int button, int action, int mods) {
+        if (instance) instance->mouseButtonCallback(win, button, action, mods);
+    }
+
+    // The window system lost the window's contents (uncovered, restored)
+    static void refreshCallbackStatic(GLFWwindow* win) {
+        if (instance) instance->activity = true;
+    }
+
     void scrollCallback(GLFWwindow* win, double xoffset, double yoffset) {
+        activity = true;
         camera.processMouseScroll(static_cast<float>(yoffset));
     }
 
+    // Left click picks the part under the cursor
+    void mouseButtonCallback(GLFWwindow* win, int button, int action, int mods) {
+        activity = true;
+        if (button != GLFW_MOUSE_BUTTON_LEFT || action != GLFW_PRESS) return;
+        glfwGetCursorPos(win, &settings.pickX, &settings.pickY);
+        settings.pickRequested = true;
+    }
+
     void toggleOrbitMode() {
         camera.toggleOrbitMode();
 
@@ -69,12 +176,12 @@ private:
     }
 
     void keyCallback(GLFWwindow* win, int key, int scancode, int action, int mods) {
+        activity = true;
         if (action != GLFW_PRESS && action != GLFW_REPEAT) return;
 
         float moveSpeed = 2.5f;
         float rotateSpeed = 45.0f;
         float busSpeed = 5.0f;
-        float wheelSpeed = 200.0f;
 
         switch (key) {
         case GLFW_KEY_ESCAPE:
@@ -129,17 +236,9 @@ private:
             // Bus Controls
         case GLFW_KEY_F:
             bus.busPosition -= busSpeed * deltaTime;
-            wheelRotation += wheelSpeed * deltaTime;
-            if (wheelRotation >= 360.0f) wheelRotation -= 360.0f;
             break;
         case GLFW_KEY_G:
             bus.busPosition += busSpeed * deltaTime;
-            wheelRotation -= wheelSpeed * deltaTime;
-            if (wheelRotation <= -360.0f) wheelRotation += 360.0f;
-            break;
-        case GLFW_KEY_R:
-            wheelRotation += wheelSpeed * deltaTime;
-            if (wheelRotation >= 360.0f) wheelRotation -= 360.0f;
             break;
         case GLFW_KEY_O:
             bus.toggleLights();
@@ -181,6 +280,91 @@ private:
         case GLFW_KEY_I:
             camera.printInfo();
             std::cout << "FPS: " << (1.0f / deltaTime) << std::endl;
+            if (showInterior) interior.printOcclusionInfo();
+            settings.infoRequested = true;
+            break;
+
+            // Interior occlusion culling
+        case GLFW_KEY_C:
+            interior.toggleOcclusionCulling();
+            break;
+
+            // Depth prepass
+        case GLFW_KEY_P:
+            settings.depthPrepass = !settings.depthPrepass;
+            std::cout << "Depth prepass " << (settings.depthPrepass ? "ENABLED" : "DISABLED") << std::endl;
+            break;
+
+            // Overdraw measurement
+        case GLFW_KEY_V:
+            settings.measureOverdraw = !settings.measureOverdraw;
+            settings.overdrawToggled = true;
+            std::cout << "Overdraw measurement " << (settings.measureOverdraw ? "ENABLED" : "DISABLED") << std::endl;
+            break;
+
+            // Window portals (off = interior or exterior only, by view mode)
+        case GLFW_KEY_N:
+            settings.portals = !settings.portals;
+            std::cout << "Window portal rendering " << (settings.portals ? "ENABLED" : "DISABLED") << std::endl;
+            break;
+
+            // Night scene with clustered point lights
+        case GLFW_KEY_8:
+            settings.clusteredLighting = !settings.clusteredLighting;
+            std::cout << "Clustered lighting " << (settings.clusteredLighting ? "ENABLED" : "DISABLED") << std::endl;
+            break;
+
+            // Multi-view layout / single-pass viewport array
+        case GLFW_KEY_T:
+            if (mods & GLFW_MOD_SHIFT) {
+                settings.viewArray = !settings.viewArray;
+                std::cout << "Multi-view viewport array " << (settings.viewArray ? "ENABLED" : "DISABLED") << std::endl;
+            }
+            else {
+                settings.multiView = !settings.multiView;
+                std::cout << "Multi-view layout " << (settings.multiView ? "ENABLED" : "DISABLED") << std::endl;
+            }
+            break;
+
+            // GPU-side animation of the bus exterior
+        case GLFW_KEY_U:
+            settings.gpuAnimation = !settings.gpuAnimation;
+            std::cout << "GPU part animation " << (settings.gpuAnimation ? "ENABLED" : "DISABLED") << std::endl;
+            break;
+
+            // Frame pacing: vsync / low-latency mode, frame limiter presets
+        case GLFW_KEY_H:
+            if (mods & GLFW_MOD_SHIFT) {
+                settings.lowLatency = !settings.lowLatency;
+                std::cout << "Low-latency mode " << (settings.lowLatency ? "ENABLED" : "DISABLED") << std::endl;
+            }
+            else {
+                settings.vsync = !settings.vsync;
+                std::cout << "VSync " << (settings.vsync ? "ENABLED" : "DISABLED") << std::endl;
+            }
+            settings.pacingChanged = true;
+            break;
+        case GLFW_KEY_7: {
+            static const int limits[] = { 0, 30, 60, 120, 144 };
+            int next = 0;
+            for (int i = 0; i < 5; i++) {
+                if (limits[i] == settings.frameLimit) next = (i + 1) % 5;
+            }
+            settings.frameLimit = limits[next];
+            if (settings.frameLimit > 0) std::cout << "Frame limit: " << settings.frameLimit << " fps" << std::endl;
+            else std::cout << "Frame limit OFF" << std::endl;
+            settings.pacingChanged = true;
+            break;
+        }
+
+            // GPU budget for optional detail sets (interior, ...)
+        case GLFW_KEY_9:
+            settings.detailBudget = std::max<size_t>(settings.detailBudget / 2, 16u * 1024u);
+            std::cout << "Detail GPU budget: " << settings.detailBudget / 1024 << " KB" << std::endl;
+            break;
+        case GLFW_KEY_0:
+            settings.detailBudget = std::min<size_t>(settings.detailBudget * 2, 1024u * 1024u * 1024u);
+            std::cout << "Detail GPU budget: " << settings.detailBudget / 1024 << " KB" << std::endl;
             break;
 
             // Toggle orbit mode
@@ -188,6 +372,36 @@ private:
             toggleOrbitMode();
             break;
 
+            // Camera collision with the bus
+        case GLFW_KEY_F2:
+            settings.cameraCollision = !settings.cameraCollision;
+            std::cout << "Camera collision " << (settings.cameraCollision ? "ENABLED" : "DISABLED") << std::endl;
+            break;
+
+            // Frame capture to disk
+        case GLFW_KEY_F3:
+            settings.capturePng = (mods & GLFW_MOD_SHIFT) != 0;
+            settings.captureToggled = true;
+            break;
+
+            // Performance overlay
+        case GLFW_KEY_F1:
+            settings.showHud = !settings.showHud;
+            std::cout << "Performance HUD " << (settings.showHud ? "ON" : "OFF") << std::endl;
+            break;
+
+            // Idle-aware rendering
+        case GLFW_KEY_F4:
+            settings.idleRendering = !settings.idleRendering;
+            std::cout << "Idle frame skipping " << (settings.idleRendering ? "ENABLED" : "DISABLED") << std::endl;
+            break;
+
+            // Fleet simulation
+        case GLFW_KEY_F5:
+            settings.showFleet = !settings.showFleet;
+            std::cout << "Fleet buses " << (settings.showFleet ? "SHOWN" : "HIDDEN") << std::endl;
+            break;
+
             // Fullscreen
         case GLFW_KEY_F11:
             toggleFullscreen();
@@ -221,12 +435,15 @@ private:
     }
 
 public:
-    InputHandler(GLFWwindow* win, Camera& cam, BusModel& b, BusInterior& interior, float& wr, bool& si)
-        : window(win), camera(cam), bus(b), interior(interior), wheelRotation(wr),
-        showInterior(si), fullscreen(false), deltaTime(0.0f) {
+    InputHandler(GLFWwindow* win, Camera& cam, BusModel& b, BusInterior& interior, bool& si,
+        RenderSettings& rs)
+        : window(win), camera(cam), bus(b), interior(interior),
+        showInterior(si), settings(rs), fullscreen(false), deltaTime(0.0f), activity(true) {
         instance = this;
         glfwSetKeyCallback(window, keyCallbackStatic);
         glfwSetScrollCallback(window, scrollCallbackStatic);
+        glfwSetMouseButtonCallback(window, mouseButtonCallbackStatic);
+        glfwSetWindowRefreshCallback(window, refreshCallbackStatic);
     }
 
     ~InputHandler() {
@@ -237,6 +454,14 @@ public:
         deltaTime = dt;
     }
 
+    // True once after any key, button, scroll or refresh event. Held keys need
+    // no events: what they move (camera, bus, wheels) is tracked directly
+    bool consumeActivity() {
+        bool any = activity;
+        activity = false;
+        return any;
+    }
+
     void updateOrbitRotation() {
         if (camera.isOrbitMode()) {
             double xpos, ypos;
@@ -293,20 +518,30 @@ public:
                 camera.rotateRoll(rotateSpeed * deltaTime);
         }
 
+        // Wheel spin and steering are animation channels; input only sets their targets
+        float wheelRate = 0.0f;
         if (glfwGetKey(window, GLFW_KEY_F) == GLFW_PRESS) {
             bus.busPosition -= busSpeed * deltaTime;
-            wheelRotation += wheelSpeed * deltaTime;
-            if (wheelRotation >= 360.0f) wheelRotation -= 360.0f;
+            wheelRate += wheelSpeed;
         }
         if (glfwGetKey(window, GLFW_KEY_G) == GLFW_PRESS) {
             bus.busPosition += busSpeed * deltaTime;
-            wheelRotation -= wheelSpeed * deltaTime;
-            if (wheelRotation <= -360.0f) wheelRotation += 360.0f;
+            wheelRate -= wheelSpeed;
         }
         if (glfwGetKey(window, GLFW_KEY_R) == GLFW_PRESS) {
-            wheelRotation += wheelSpeed * deltaTime;
-            if (wheelRotation >= 360.0f) wheelRotation -= 360.0f;
+            wheelRate += wheelSpeed;
+        }
+        bus.setWheelSpeed(wheelRate);
+
+        float steering = 0.0f;
+        if (glfwGetKey(window, GLFW_KEY_J) == GLFW_PRESS) {
+            if (glfwGetKey(window, GLFW_KEY_LEFT_SHIFT) == GLFW_PRESS ||
+                glfwGetKey(window, GLFW_KEY_RIGHT_SHIFT) == GLFW_PRESS)
+                steering = 1.0f;
+            else
+                steering = -1.0f;
         }
+        interior.setSteering(steering);
         // Look-at rotation (continuous)
         if (glfwGetKey(window, GLFW_KEY_K) == GLFW_PRESS) {
             if (glfwGetKey(window, GLFW_KEY_LEFT_SHIFT) == GLFW_PRESS ||
@@ -323,8 +558,111 @@ public:
 
 InputHandler* InputHandler::instance = nullptr;
 
+// Control points along one lane from x = 'from' to 'to', both ends included:
+// every 500 units, closing up toward either end to the 15 unit spacing of the
+// loops so neighbouring segments never differ much in length (uniform
+// Catmull-Rom overshoots where they do)
+void addFleetStraight(std::vector<glm::vec2>& points, float from, float to, float z) {
+    const float taper[] = { 0.0f, 15.0f, 30.0f, 60.0f, 120.0f, 250.0f };
+    const int taperCount = sizeof(taper) / sizeof(taper[0]);
+    float direction = to > from ? 1.0f : -1.0f;
+    float length = std::abs(to - from);
+    for (int i = 0; i < taperCount; i++) points.push_back(glm::vec2(from + direction * taper[i], z));
+    for (float offset = 500.0f; offset <= length - 500.0f; offset += 500.0f) {
+        points.push_back(glm::vec2(from + direction * offset, z));
+    }
+    for (int i = taperCount - 1; i >= 0; i--) points.push_back(glm::vec2(to - direction * taper[i], z));
+}
+
+// Turning loop past the end of a straight at x = 'end' (ends excluded): eases
+// out from the lane at 'laneZ' to a semicircle and back into the other lane,
+// with about 15 units between control points throughout
+void addFleetLoop(std::vector<glm::vec2>& points, float end, float outward, float laneZ) {
+    const float pi = 3.14159265f;
+    const float step = 15.0f;
+    const int easeSteps = 4;
+    const int arcSteps = 4;      // Quarter-turns of 45 degrees, about 15 units at this radius
+    float side = laneZ > 0.0f ? 1.0f : -1.0f;
+    float centreX = end + outward * step * easeSteps;
+    auto easedZ = [&](int k) {
+        float ease = 0.5f - 0.5f * std::cos(pi * static_cast<float>(k) / easeSteps);
+        return side * (std::abs(laneZ) + (FLEET_LOOP_RADIUS - std::abs(laneZ)) * ease);
+    };
+
+    for (int k = 1; k <= easeSteps; k++) points.push_back(glm::vec2(end + outward * step * k, easedZ(k)));
+    for (int a = 1; a < arcSteps; a++) {
+        float angle = pi * static_cast<float>(a) / arcSteps;
+        points.push_back(glm::vec2(centreX + outward * FLEET_LOOP_RADIUS * std::sin(angle),
+            side * FLEET_LOOP_RADIUS * std::cos(angle)));
+    }
+    for (int k = easeSteps; k >= 1; k--) points.push_back(glm::vec2(end + outward * step * k, -easedZ(k)));
+}
+
+// Out along one lane, round a turning loop, back along the other and round
+// the mirrored loop to the start
+bool buildFleetRoute(FleetRoute& route) {
+    const float span = FLEET_ROUTE_HALF_SPAN;
+    std::vector<glm::vec2> points;
+    addFleetStraight(points, -span, span, FLEET_LANE_OFFSET);
+    addFleetLoop(points, span, 1.0f, FLEET_LANE_OFFSET);
+    addFleetStraight(points, span, -span, -FLEET_LANE_OFFSET);
+    addFleetLoop(points, -span, -1.0f, -FLEET_LANE_OFFSET);
+    if (!route.build(points)) return false;
+
+    for (float d = FLEET_STOP_SPACING * 0.5f; d < route.getLength(); d += FLEET_STOP_SPACING) route.addStop(d);
+    return true;
+}
+
 // ==================== Main Function ====================
-int main() {
+// Command line:
+//   --headless           hidden window, no vsync, fixed time step of one recorded
+//                        frame, capture waits instead of dropping frames
+//   --capture=y4m|png    record from the first frame
+//   --frames=N           exit after N frames (headless default 300)
+//   --metrics-port=N     serve Prometheus metrics on 127.0.0.1:N (default 9464, 0 = off)
+//   --fleet[=N]          simulate N buses on the fleet route (2000 without N; off by default)
+// Debug builds with BUS_GL_TRACE defined trace every GL call (GlTrace.h):
+// per-frame counts on I and in the HUD.
+int main(int argc, char** argv) {
+    StartupTimer startup;
+
+    bool headless = false;
+    int captureFormat = -1;
+    int frameCount = 0;
+    int metricsPort = DEFAULT_METRICS_PORT;
+    int fleetSize = 0;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--headless") headless = true;
+        else if (arg == "--capture=y4m") captureFormat = FrameCapture::FORMAT_Y4M;
+        else if (arg == "--capture=png") captureFormat = FrameCapture::FORMAT_PNG;
+        else if (arg.compare(0, 9, "--frames=") == 0) frameCount = std::max(std::atoi(arg.c_str() + 9), 0);
+        else if (arg.compare(0, 15, "--metrics-port=") == 0) metricsPort = std::max(std::atoi(arg.c_str() + 15), 0);
+        else if (arg == "--fleet") fleetSize = DEFAULT_FLEET_SIZE;
+        else if (arg.compare(0, 8, "--fleet=") == 0) fleetSize = std::max(std::atoi(arg.c_str() + 8), 0);
+        else std::cerr << "Unknown option " << arg
+            << " (--headless, --capture=y4m|png, --frames=N, --metrics-port=N, --fleet[=N])" << std::endl;
+    }
+    if (headless && frameCount == 0) frameCount = HEADLESS_FRAMES;
+
+    // Geometry generation is pure CPU work: it runs on the pool while the
+    // window, GL context and shaders are created, then everything is
+    // uploaded in one pass. The interior only gets its part list here; its
+    // geometry is loaded on demand by the residency manager. The pool and
+    // the per-frame job system are declared after the models so they are
+    // joined before the models are destroyed.
+    BusModel bus;
+    BusInterior interior;
+    MetricsRegistry metrics;     // Before the job system: its timing hook records here
+    ThreadPool pool;
+    JobSystem jobs;
+    std::vector<std::future<void>> geometryJobs;
+
+    bus.build();
+    bus.createGeometry(pool, geometryJobs);
+    interior.build();
+    startup.mark("Part lists + job submission");
+
     if (!glfwInit()) {
         std::cerr << "Failed to initialize GLFW" << std::endl;
         return -1;
@@ -333,6 +671,9 @@ int main() {
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_STENCIL_BITS, 8);  // Window portals
+    if (headless) glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    if (GlTrace::ENABLED) glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, GL_TRUE);   // KHR_debug messages for the trace
 
 #ifdef __APPLE__
     glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
@@ -356,29 +697,115 @@ int main() {
         std::cerr << "Failed to initialize GLAD" << std::endl;
         return -1;
     }
+    GlTrace::install();
 
     glEnable(GL_DEPTH_TEST);
     glDepthFunc(GL_LEQUAL);
+    // Every part is closed and wound counter-clockwise from outside (MeshBuffer checks)
+    glEnable(GL_CULL_FACE);
+    glCullFace(GL_BACK);
+    glFrontFace(GL_CCW);
+    startup.mark("Window + GL context");
 
     ShaderProgram shader;
     if (!shader.create()) return -1;
 
-    BusModel bus;
-    bus.initialize();
+    OverdrawMeter overdraw;
+    if (!overdraw.setup()) return -1;
 
-    BusInterior interior;
-    interior.initialize();
+    // Optional: without it the GPU animation toggle keeps the packet path
+    ShaderProgram animatedShader;
+    bool animatedShaderReady = animatedShader.create("vertex_animated.glsl", "fragment.glsl");
+
+    // Optional as well: without it the night scene stays off
+    ClusteredLighting lighting;
+    bool lightingReady = lighting.setup();
+
+    // Optional too: without it F1 shows nothing
+    PerformanceHud hud;
+    hud.setup();
+    startup.mark("Shaders");
+
+    for (auto& job : geometryJobs) job.get();
+    startup.mark("Geometry jobs (" + std::to_string(pool.getThreadCount()) + " threads, remaining wait)");
+
+    bus.upload();
+
+    PortalRenderer portalRenderer;
+    portalRenderer.setup();
+
+    MultiViewRenderer multiView;
+    multiView.setup();
+    startup.mark("GPU upload (" + std::to_string(bus.getUploadedBytes() / 1024) + " KB)");
+    bus.printMeshInfo();
 
     Camera camera;
-    float wheelRotation = 0.0f;
+
+    // Road tiles streamed around the bus; the far plane reaches the end of the ring
+    FloatingOrigin worldOrigin;
+    WorldStreamer world;
+    world.setup();
+    world.update(worldOrigin, bus.busPosition, true);
+    camera.setFarPlane(WorldStreamer::viewDistance());
     bool showInterior = false;
-    InputHandler input(window, camera, bus, interior, wheelRotation, showInterior);
+    RenderSettings settings;
+    if (headless) settings.vsync = false;
+    InputHandler input(window, camera, bus, interior, showInterior, settings);
+
+    // One clock and one batched update for every animated part
+    AnimationSystem animation;
+    bus.bindAnimation(animation);
+    interior.bindAnimation(animation);
+
+    // Route simulation for the fleet at its own fixed rate; the buses near the
+    // camera share the bus's animated buffer, one draw each
+    struct FleetBusDraw {
+        glm::mat4 model;
+        float doors;
+        float wheelRotation;
+        bool lightsOn;
+
+        bool looksLike(const FleetBusDraw& other) const {
+            return model == other.model && doors == other.doors && wheelRotation == other.wheelRotation &&
+                lightsOn == other.lightsOn;
+        }
+    };
+    FleetSimulation fleet;
+    if (fleetSize > 0 && buildFleetRoute(fleet.getRoute())) fleet.spawn(static_cast<size_t>(fleetSize));
+    std::vector<size_t> fleetNear;
+    std::vector<FleetBusDraw> fleetBuses;
+    std::vector<FleetBusDraw> fleetBusesRendered;   // As of the last rendered frame
+    double fleetClock = glfwGetTime();
+
+    ResidencyManager residency(pool, settings.detailBudget);
+    int interiorAsset = residency.addAsset("Bus interior",
+        [&interior] { return interior.createGeometry(); },
+        [&interior] { interior.upload(); },
+        [&interior] { interior.release(); });
+
+    // Picking and camera collision: each part tree is an instance riding with
+    // the bus, under one top-level tree
+    CollisionWorld collision;
+    int exteriorInstance = collision.addInstance(&bus.getPartTree(), PICK_EXTERIOR);
+    int interiorInstance = collision.addInstance(&interior.getPartTree(), PICK_INTERIOR);
+    collision.setTransform(exteriorInstance, camera.getBaseModel(bus.busPosition));
+    collision.setTransform(interiorInstance, camera.getBaseModel(bus.busPosition));
+    collision.setEnabled(interiorInstance, false);
+    collision.update();
+    camera.setCollider([&collision, &settings](const glm::vec3& from, const glm::vec3& to) {
+        return settings.cameraCollision ? collision.moveSphere(from, to, CAMERA_RADIUS) : to;
+        });
+
+    DrawList exteriorList;
+    DrawList interiorList;
+    DrawList frameList;      // Everything drawn this frame, for the overdraw meter
 
     float deltaTime = 0.0f;
     float lastFrame = 0.0f;
 
     // Print controls
     std::cout << "\n=== ST BUS SIMULATOR WITH INTERIOR VIEW ===" << std::endl;
+    std::cout << "Transform kernel: " << TransformKernel::simdLevelName(TransformKernel::activeSimdLevel()) << std::endl;
     std::cout << "\n*** Press M to toggle between ORBIT and FREE-FLIGHT modes ***" << std::endl;
     std::cout << "\n*** Press 3 for INTERIOR VIEW | Press 4 to return to exterior ***" << std::endl;
     std::cout << "*** Press 5 for DRIVER VIEW | Press 6 to return to normal mode ***" << std::endl;
@@ -408,48 +835,522 @@ int main() {
     std::cout << "  I - Print Camera Info & FPS" << std::endl;
     std::cout << "  F/G - Move Bus Forward/Backward" << std::endl;
     std::cout << "  R - Rotate Wheels" << std::endl;
+    std::cout << "  J/Shift+J - Steer Left/Right" << std::endl;
     std::cout << "  O - Toggle Lights" << std::endl;
+    std::cout << "  C - Toggle Interior Occlusion Culling" << std::endl;
+    std::cout << "  P - Toggle Depth Prepass" << std::endl;
+    std::cout << "  V - Toggle Overdraw Measurement" << std::endl;
+    std::cout << "  N - Toggle Window Portal Rendering" << std::endl;
+    std::cout << "  T/Shift+T - Toggle Multi-View Layout / Viewport Array" << std::endl;
+    std::cout << "  9/0 - Halve/Double Detail GPU Budget" << std::endl;
+    std::cout << "  U - Toggle GPU Part Animation (one draw per bus)" << std::endl;
+    std::cout << "  8 - Toggle Night Scene (clustered lighting)" << std::endl;
+    std::cout << "  H/Shift+H - Toggle VSync / Low-Latency Mode" << std::endl;
+    std::cout << "  7 - Cycle Frame Limit (off/30/60/120/144)" << std::endl;
+    std::cout << "  Left Click - Pick Part (doors and lights toggle)" << std::endl;
+    std::cout << "  F1 - Toggle Performance HUD" << std::endl;
+    std::cout << "  F2 - Toggle Camera Collision" << std::endl;
+    std::cout << "  F3/Shift+F3 - Start/Stop Recording (Y4M video / PNG frames)" << std::endl;
+    std::cout << "  F4 - Toggle Idle Frame Skipping" << std::endl;
+    std::cout << "  F5 - Show/Hide Fleet Buses" << std::endl;
     std::cout << "  F11 - Fullscreen" << std::endl;
     std::cout << "  ESC - Exit\n" << std::endl;
 
   // glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
 
+    FramePacer pacer;
+    pacer.setVsync(settings.vsync);
+    RenderGraph graph;
+    JobGraph frameJobs;
+    IdleTracker idle;
+
+    // For a local scraping agent. Recorded once per rendered frame; jobs
+    // record their own run time from the workers.
+    MetricsRegistry::Histogram& frameTimeMetric = metrics.histogram("bus_frame_time_seconds",
+        "Time between rendered frames", { 0.004, 0.008, 0.0125, 0.0167, 0.025, 0.0333, 0.05, 0.1, 0.25, 1.0 });
+    MetricsRegistry::Counter& framesRenderedMetric = metrics.counter("bus_frames_rendered_total", "Frames rendered and presented");
+    MetricsRegistry::Counter& framesSkippedMetric = metrics.counter("bus_frames_skipped_total",
+        "Loop iterations that skipped rendering because nothing changed");
+    MetricsRegistry::Gauge& drawCallsMetric = metrics.gauge("bus_draw_calls", "Draw calls in the last rendered frame");
+    MetricsRegistry::Counter& drawCallsTotalMetric = metrics.counter("bus_draw_calls_total", "Draw calls since startup");
+    MetricsRegistry::Gauge& trianglesMetric = metrics.gauge("bus_triangles", "Triangles in the last rendered frame");
+    MetricsRegistry::Counter& tileUploadsMetric = metrics.counter("bus_uploads_total", "GPU uploads since startup", "kind=\"tile\"");
+    MetricsRegistry::Counter& detailUploadsMetric = metrics.counter("bus_uploads_total", "GPU uploads since startup", "kind=\"detail\"");
+    MetricsRegistry::Counter& tileUploadBytesMetric = metrics.counter("bus_upload_bytes_total", "Bytes uploaded to the GPU since startup",
+        "kind=\"tile\"");
+    MetricsRegistry::Counter& detailUploadBytesMetric = metrics.counter("bus_upload_bytes_total", "Bytes uploaded to the GPU since startup",
+        "kind=\"detail\"");
+    MetricsRegistry::Gauge& meshMemoryMetric = metrics.gauge("bus_gpu_memory_bytes", "GPU memory in use by pool", "pool=\"meshes\"");
+    MetricsRegistry::Gauge& detailMemoryMetric = metrics.gauge("bus_gpu_memory_bytes", "GPU memory in use by pool", "pool=\"detail\"");
+    MetricsRegistry::Gauge& targetMemoryMetric = metrics.gauge("bus_gpu_memory_bytes", "GPU memory in use by pool", "pool=\"targets\"");
+    MetricsRegistry::Histogram& jobTimeMetric = metrics.histogram("bus_job_seconds", "Run time of per-frame jobs",
+        { 0.00005, 0.0001, 0.00025, 0.0005, 0.001, 0.0025, 0.005, 0.01 });
+    jobs.setTimingHook([&jobTimeMetric](const JobGraph::Timing& timing) {
+        jobTimeMetric.observe((timing.endMs - timing.beginMs) / 1000.0);
+        });
+    MetricsServer metricsServer(metrics);
+    if (metricsPort > 0) metricsServer.start(metricsPort);
+
+    // Recorded at the frame limit's rate (60 fps without one); headless runs
+    // step the simulation by exactly one recorded frame each frame
+    FrameCapture capture(pool);
+    capture.setLossless(headless);
+    auto captureRate = [&settings] { return settings.frameLimit > 0 ? settings.frameLimit : 60; };
+    if (captureFormat >= 0) {
+        int width, height;
+        glfwGetFramebufferSize(window, &width, &height);
+        capture.start(static_cast<FrameCapture::Format>(captureFormat), width, height, captureRate());
+    }
+    int framesRendered = 0;
+
     while (!glfwWindowShouldClose(window)) {
+        // Nothing changed last time: the last frame stays on screen while the
+        // thread sleeps until an event, and the time asleep is not a step
+        if (idle.isIdle()) {
+            idle.waitForEvents();
+            lastFrame = static_cast<float>(glfwGetTime());
+        }
+
+        // Limiter and fence wait first, so the input below is as fresh as
+        // possible when the frame is rendered
+        pacer.beginFrame();
+
+        glfwPollEvents();
+        if (settings.pacingChanged) {
+            pacer.setVsync(settings.vsync);
+            pacer.setLowLatency(settings.lowLatency);
+            pacer.setFrameLimit(settings.frameLimit);
+            settings.pacingChanged = false;
+        }
+
         float currentFrame = static_cast<float>(glfwGetTime());
-        deltaTime = currentFrame - lastFrame;
+        deltaTime = headless ? 1.0f / captureRate() : currentFrame - lastFrame;
         lastFrame = currentFrame;
 
         input.setDeltaTime(deltaTime);
-
-        glClearColor(0.0f, 0.44f, 0.74f, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
         input.processContinuousInput();
         input.updateOrbitRotation();
-        bus.updateDoors();
+        pacer.mark(FramePacer::STAGE_INPUT);
+
+        animation.update(deltaTime);
+        bus.updateAnimation();
+
+        // Time asleep while idle still counts for the fleet, so it keeps its own clock
+        double fleetNow = glfwGetTime();
+        fleet.advance(headless ? deltaTime : fleetNow - fleetClock, jobs);
+        fleetClock = fleetNow;
+
+        // Floating origin: shift the scene back once the bus has driven far out
+        glm::vec3 originShift;
+        if (worldOrigin.rebase(bus.busPosition, WorldStreamer::TILE_LENGTH, originShift)) {
+            bus.busPosition -= originShift.x;
+            camera.shiftOrigin(originShift);
+        }
+        bool worldStreamed = world.update(worldOrigin, bus.busPosition) > 0;
+        if (settings.infoRequested) world.printInfo(worldOrigin, bus.busPosition);
+        pacer.mark(FramePacer::STAGE_UPDATE);
 
         shader.use();
         camera.setUniforms(shader);
 
-        bus.updateWheelRotation(wheelRotation);
-
         glm::mat4 baseModel = camera.getBaseModel(bus.busPosition);
+        glm::vec3 viewPos = camera.getPosition();
+        glm::vec3 localEye = glm::vec3(glm::inverse(baseModel) * glm::vec4(viewPos, 1.0f));
+        glm::mat4 view = camera.getViewMatrix();
+        glm::mat4 projection = camera.getProjectionMatrix();
+
+        int fbWidth, fbHeight;
+        glfwGetFramebufferSize(window, &fbWidth, &fbHeight);
+
+        // Interior residency: prefetch on approach, request while it can be seen
+        float busDistance = glm::length(viewPos - glm::vec3(baseModel[3]));
+        bool interiorWanted = settings.multiView || showInterior ||
+            (settings.portals && busDistance < INTERIOR_DRAW_DISTANCE);
+        if (interiorWanted) residency.request(interiorAsset);
+        else if (busDistance < INTERIOR_PREFETCH_DISTANCE) residency.prefetch(interiorAsset);
+        residency.setBudget(settings.detailBudget);
+        residency.update();
+        bool interiorReady = residency.isResident(interiorAsset);
+        if (settings.infoRequested) residency.printInfo();
+
+        // Collision instances follow the bus; the interior only collides once it is drawn
+        collision.setTransform(exteriorInstance, baseModel);
+        collision.setTransform(interiorInstance, baseModel);
+        collision.setEnabled(interiorInstance, interiorReady);
+        collision.update();
+        if (settings.infoRequested) collision.printInfo();
+
+        if (settings.pickRequested) {
+            settings.pickRequested = false;
+            int windowWidth, windowHeight;
+            glfwGetWindowSize(window, &windowWidth, &windowHeight);
+            if (settings.multiView) {
+                std::cout << "Picking works in the single-view layout" << std::endl;
+            }
+            else if (windowWidth > 0 && windowHeight > 0) {
+                // Cursor -> NDC -> world ray through the far plane
+                float ndcX = static_cast<float>(2.0 * settings.pickX / windowWidth - 1.0);
+                float ndcY = static_cast<float>(1.0 - 2.0 * settings.pickY / windowHeight);
+                glm::vec4 farPoint = glm::inverse(projection * view) * glm::vec4(ndcX, ndcY, 1.0f, 1.0f);
+                glm::vec3 direction = glm::vec3(farPoint) / farPoint.w - viewPos;
+
+                auto pickStart = std::chrono::steady_clock::now();
+                CollisionWorld::Hit hit;
+                bool picked = collision.pick(viewPos, direction, PICK_DISTANCE, hit);
+                double pickMicroseconds = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - pickStart).count();
+
+                if (!picked) {
+                    std::cout << "Picked nothing (" << pickMicroseconds << " us)" << std::endl;
+                }
+                else if (hit.tag == PICK_INTERIOR) {
+                    std::cout << "Picked interior part " << hit.item << " (" << interior.getPartGroupName(hit.item)
+                        << ") at " << hit.distance << " m (" << pickMicroseconds << " us)" << std::endl;
+                }
+                else {
+                    static const char* kindNames[] = { "body", "light", "door", "wheel" };
+                    BusModel::PartKind kind = bus.getPartKind(hit.item);
+                    std::cout << "Picked bus " << kindNames[kind] << " part " << hit.item
+                        << " at " << hit.distance << " m (" << pickMicroseconds << " us)" << std::endl;
+                    if (kind == BusModel::PART_KIND_DOOR) {
+                        if (bus.areDoorsOpening()) bus.closeDoors();
+                        else bus.openDoors();
+                    }
+                    else if (kind == BusModel::PART_KIND_LIGHT) {
+                        bus.toggleLights();
+                    }
+                }
+            }
+        }
 
-        if (showInterior) {
-            // Show interior view only
-            interior.draw(shader, baseModel);
+        // Fleet buses in reach of the camera, between the last two steps. Left
+        // out of the night scene: the animated shader is unlit and the fleet
+        // adds no lights of its own.
+        fleetBuses.clear();
+        bool fleetDrawable = animatedShaderReady && !settings.multiView && !(settings.clusteredLighting && lightingReady);
+        if (settings.showFleet && fleetDrawable && fleet.size() > 0) {
+            glm::vec2 eye(static_cast<float>(worldOrigin.toAbsoluteX(viewPos.x)), viewPos.z);
+            fleet.findNear(eye, FLEET_DRAW_DISTANCE, MAX_FLEET_DRAWN, fleetNear);
+            float blend = fleet.getBlend();
+            for (size_t b : fleetNear) {
+                glm::vec2 position, direction;
+                fleet.getRoute().sample(fleet.getDistance(b, blend), position, direction);
+                // The model faces -X: its X axis points backwards along the route
+                glm::mat4 model(1.0f);
+                model[0] = glm::vec4(-direction.x, 0.0f, -direction.y, 0.0f);
+                model[2] = glm::vec4(direction.y, 0.0f, -direction.x, 0.0f);
+                model[3] = glm::vec4(worldOrigin.toLocalX(position.x), 0.0f, position.y, 1.0f);
+                // Lights on while driving, off at stops
+                fleetBuses.push_back(FleetBusDraw{ model, fleet.getDoorOffset(b), fleet.getWheelRotation(b), fleet.getSpeed(b) > 0.0f });
+            }
+        }
+        if (settings.infoRequested && fleet.size() > 0) fleet.printInfo();
+
+        // Only buses that moved, or whose doors or lights changed, since the
+        // last rendered frame count: those parked at stops let the loop idle
+        bool fleetChanged = fleetBuses.size() != fleetBusesRendered.size();
+        for (size_t i = 0; i < fleetBuses.size() && !fleetChanged; i++) {
+            fleetChanged = !fleetBuses[i].looksLike(fleetBusesRendered[i]);
+        }
+
+        // Skip the frame when nothing that reaches the screen has changed;
+        // headless runs and recordings need every frame
+        idle.setEnabled(settings.idleRendering && !headless);
+        if (input.consumeActivity() || capture.isRecording() || bus.isAnimating() || interior.isAnimating() ||
+            worldStreamed || residency.isBuilding() || fleetChanged) {
+            idle.markChanged();
+        }
+        idle.trackCamera(camera.getRevision());
+        idle.trackFramebuffer(fbWidth, fbHeight);
+        if (!idle.shouldRender()) {
+            pacer.skipFrame();
+            framesSkippedMetric.add();
+            continue;
+        }
+        fleetBusesRendered = fleetBuses;
+        hud.addFrameTime(deltaTime * 1000.0f);
+        hud.setVisible(settings.showHud);
+        graph.setGpuTiming(hud.isVisible());
+
+        // Culling and packet recording are queued here as jobs; the graph's
+        // passes only draw, each waiting for the lists it needs
+        graph.reset();
+        frameJobs.reset();
+        RenderGraph::Resource backbuffer = graph.importBackbuffer(fbWidth, fbHeight);
+        auto clearBackbuffer = [](bool night) {
+            if (night) glClearColor(NIGHT_SKY.r, NIGHT_SKY.g, NIGHT_SKY.b, 1.0f);
+            else glClearColor(0.0f, 0.44f, 0.74f, 1.0f);
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+        };
+        bool interiorDrawn = false;
+
+        if (settings.multiView) {
+            // Left: main camera. Right column: driver seat (top) and rear of the cabin (bottom),
+            // both riding with the bus
+            int mainWidth = fbWidth * 2 / 3;
+            int sideWidth = fbWidth - mainWidth;
+            int halfHeight = fbHeight / 2;
+            float fov = glm::radians(camera.getFov());
+
+            glm::vec3 driverEye = glm::vec3(baseModel * glm::vec4(-1.2f, 0.3f, 0.0f, 1.0f));
+            glm::vec3 cabinEye = glm::vec3(baseModel * glm::vec4(4.0f, 0.6f, 0.0f, 1.0f));
+            glm::vec3 forward(-1.0f, 0.0f, 0.0f);
+            glm::vec3 worldUp(0.0f, 1.0f, 0.0f);
+
+            multiView.clearViews();
+            multiView.addView(view, glm::perspective(fov, (float)mainWidth / (float)std::max(fbHeight, 1),
+                camera.getNearPlane(), camera.getFarPlane()),
+                viewPos, 0, 0, mainWidth, fbHeight);
+            multiView.addView(glm::lookAt(driverEye, driverEye + forward, worldUp),
+                glm::perspective(glm::radians(60.0f), (float)sideWidth / (float)std::max(fbHeight - halfHeight, 1), 0.05f, camera.getFarPlane()),
+                driverEye, mainWidth, halfHeight, sideWidth, fbHeight - halfHeight);
+            multiView.addView(glm::lookAt(cabinEye, cabinEye + forward, worldUp),
+                glm::perspective(glm::radians(60.0f), (float)sideWidth / (float)std::max(halfHeight, 1), 0.05f, camera.getFarPlane()),
+                cabinEye, mainWidth, 0, sideWidth, halfHeight);
+
+            // Interior parts only for views inside the cabin (windows are opaque here)
+            unsigned int cabinViews = 0;
+            for (int i = 0; i < multiView.getViewCount(); i++) {
+                glm::vec3 eye = glm::vec3(glm::inverse(baseModel) * glm::vec4(multiView.getView(i).eye, 1.0f));
+                if (bus.isInsideCabin(eye)) cabinViews |= 1u << i;
+            }
+
+            // Exterior and interior are recorded and culled side by side, then merged
+            JobGraph::Job exteriorJob = frameJobs.add("exterior.submit", [&] {
+                exteriorList.clear();
+                bus.submit(exteriorList, baseModel);
+                world.submit(exteriorList, worldOrigin);
+                multiView.cull(exteriorList, multiView.allViews());
+                });
+            JobGraph::Job interiorJob = frameJobs.add("interior.submit", [&, cabinViews] {
+                interiorList.clear();
+                if (cabinViews && interiorReady) interior.submit(interiorList, baseModel);
+                multiView.cull(interiorList, cabinViews);
+                });
+            JobGraph::Job mergeJob = frameJobs.add("frame.sort", [&] {
+                frameList.clear();
+                frameList.append(exteriorList);
+                frameList.append(interiorList);
+                frameList.sortFrontToBack(viewPos);
+                }, { exteriorJob, interiorJob });
+            jobs.run(frameJobs);
+
+            RenderGraph::Pass scenePass = graph.addPass("scene", [&, mergeJob](const RenderGraph::PassContext&) {
+                jobs.wait(frameJobs, mergeJob);
+                clearBackbuffer(false);
+                multiView.render(frameList, shader, fbWidth, fbHeight, settings.viewArray);
+                });
+            graph.write(scenePass, backbuffer);
         }
         else {
-            // Show exterior view
-            bus.draw(shader, baseModel);
+            bool insideCabin = bus.isInsideCabin(localEye);
+            // Exterior stands in while the interior is still loading
+            bool drawExterior = settings.portals || !showInterior || !interiorReady;
+            bool drawInterior = interiorReady && interiorWanted;
+            bool throughPortals = settings.portals && !insideCabin;
+            bool lit = settings.clusteredLighting && lightingReady;
+            // One static draw for the whole bus; from inside the cabin the shell
+            // must be dropped per part, the overdraw meter replays packets and
+            // the animated shader is unlit
+            bool gpuExterior = drawExterior && settings.gpuAnimation && animatedShaderReady &&
+                !insideCabin && !settings.measureOverdraw && !lit;
+
+            // Interior only inside the windows; skipped when none is on screen
+            if (drawInterior && throughPortals) {
+                drawInterior = portalRenderer.prepare(bus.getPortals(), baseModel, projection * view,
+                    localEye, fbWidth, fbHeight);
+            }
+            interiorDrawn = drawInterior;
+
+            // Branch locals by value: the jobs and passes run after this block
+            JobGraph::Job exteriorJob = frameJobs.add("exterior.submit", [&, drawExterior, gpuExterior, insideCabin] {
+                exteriorList.clear();
+                if (drawExterior && !gpuExterior) bus.submit(exteriorList, baseModel, insideCabin ? &localEye : nullptr);
+                if (drawExterior) world.submit(exteriorList, worldOrigin);
+                exteriorList.sortFrontToBack(viewPos);
+                });
+            JobGraph::Job interiorJob = frameJobs.add("interior.submit", [&, drawInterior, throughPortals] {
+                interiorList.clear();
+                if (drawInterior) interior.submit(interiorList, baseModel, !throughPortals);
+                interiorList.sortFrontToBack(viewPos);
+                });
+            JobGraph::Job lightsJob = -1;
+            if (lit) {
+                lightsJob = frameJobs.add("lights.cull", [&, drawInterior] {
+                    lighting.clearLights();
+                    bus.collectLights(lighting, baseModel);
+                    if (drawInterior) interior.collectLights(lighting, baseModel);
+                    world.collectLights(lighting, worldOrigin);
+                    lighting.cull(view, projection, camera.getNearPlane(), camera.getFarPlane());
+                    });
+            }
+            jobs.run(frameJobs);
+
+            RenderGraph::Pass scenePass = graph.addPass("scene",
+                [&, gpuExterior, drawInterior, throughPortals, lit, exteriorJob, interiorJob, lightsJob](const RenderGraph::PassContext&) {
+                const ShaderProgram& sceneShader = lit ? lighting.getShader() : shader;
+                if (lit) {
+                    jobs.wait(frameJobs, lightsJob);
+                    lighting.upload();
+                    if (settings.infoRequested) lighting.printInfo();
+                    lighting.bind(view, projection, fbWidth, fbHeight, NIGHT_AMBIENT);
+                }
+
+                clearBackbuffer(lit);
+                jobs.wait(frameJobs, exteriorJob);
+                exteriorList.render(sceneShader, settings.depthPrepass);
+                if (gpuExterior) bus.drawAnimated(animatedShader, baseModel, view, projection);
+                if (!fleetBuses.empty()) bus.beginAnimated(animatedShader, view, projection);
+                for (const FleetBusDraw& fleetBus : fleetBuses) {
+                    bus.drawAnimated(animatedShader, fleetBus.model, fleetBus.doors, fleetBus.wheelRotation, fleetBus.lightsOn);
+                }
+                if (gpuExterior || !fleetBuses.empty()) sceneShader.use();
+
+                if (drawInterior) jobs.wait(frameJobs, interiorJob);
+                if (drawInterior && throughPortals) {
+                    portalRenderer.beginInterior(sceneShader, baseModel, view, projection);
+                    interiorList.render(sceneShader, settings.depthPrepass);
+                    interior.issueOcclusionQueries(sceneShader, baseModel, viewPos);
+                    portalRenderer.endInterior();
+                }
+                else if (drawInterior) {
+                    interiorList.render(sceneShader, settings.depthPrepass);
+                    interior.issueOcclusionQueries(sceneShader, baseModel, viewPos);
+                }
+                if (lit) shader.use();
+                });
+            graph.write(scenePass, backbuffer);
+
+            if (settings.measureOverdraw && fbWidth > 0 && fbHeight > 0) {
+                if (settings.overdrawToggled) overdraw.reset();
+                // Portal clipping is not replayed, so this overestimates outside views
+                RenderGraph::Resource overdrawCount = graph.createTexture("overdraw.count", fbWidth, fbHeight, GL_R32F);
+                RenderGraph::Resource overdrawDepth = graph.createTexture("overdraw.depth", fbWidth, fbHeight, GL_DEPTH_COMPONENT24);
+                RenderGraph::Pass countPass = graph.addPass("overdraw.count",
+                    [&, drawInterior, exteriorJob, interiorJob](const RenderGraph::PassContext&) {
+                    jobs.wait(frameJobs, exteriorJob);
+                    jobs.wait(frameJobs, interiorJob);
+                    frameList.clear();
+                    frameList.append(exteriorList);
+                    if (drawInterior) frameList.append(interiorList);
+                    overdraw.render(frameList, view, projection, settings.depthPrepass);
+                    });
+                graph.write(countPass, overdrawCount);
+                graph.write(countPass, overdrawDepth);
+
+                RenderGraph::Pass reportPass = graph.addPass("overdraw.report",
+                    [&, overdrawCount](const RenderGraph::PassContext& context) {
+                    overdraw.accumulate(context.texture(overdrawCount), fbWidth, fbHeight);
+                    });
+                graph.read(reportPass, overdrawCount);
+                graph.markOutput(reportPass);
+            }
+            settings.overdrawToggled = false;
+        }
+
+        // Overlay on top of every view, after the passes it counts
+        if (hud.isVisible()) {
+            RenderGraph::Pass hudPass = graph.addPass("hud", [&, interiorDrawn](const RenderGraph::PassContext&) {
+                const DrawStats& stats = drawStats();
+                hud.addLine("Draws %u, triangles %u", stats.drawCalls, stats.triangles);
+                if (settings.multiView) {
+                    hud.addLine("Culled %d of %d packet-views", multiView.getCulledPacketViews(), multiView.getPacketViewCandidates());
+                }
+                else if (interiorDrawn) {
+                    hud.addLine("Culled %d of %d interior groups (occlusion)", interior.getOccludedGroupCount(),
+                        interior.getOcclusionGroupCount());
+                }
+                else {
+                    hud.addLine("Culled interior (not drawn or no window on screen)");
+                }
+
+                hud.addLine("GPU");
+                for (const RenderGraph::PassTiming& timing : graph.getGpuTimings()) {
+                    hud.extendLine(" %s %.3f ms", timing.name.c_str(), timing.milliseconds);
+                }
+                hud.addLine("GPU memory: meshes %u KB, detail %u/%u KB, targets %u KB",
+                    static_cast<unsigned int>((bus.getUploadedBytes() + WorldStreamer::getRingBytes()) / 1024),
+                    static_cast<unsigned int>(residency.getResidentBytes() / 1024),
+                    static_cast<unsigned int>(residency.getBudget() / 1024),
+                    static_cast<unsigned int>(graph.getPoolBytes() / 1024));
+                if (fleet.size() > 0) {
+                    hud.addLine("Fleet %u buses, %u drawn, step %.3f ms", static_cast<unsigned int>(fleet.size()),
+                        static_cast<unsigned int>(fleetBuses.size()), fleet.getLastStepMilliseconds());
+                }
+                if (GlTrace::ENABLED) {
+                    const GlFrameStats& gl = GlTrace::getFrameStats();
+                    hud.addLine("GL calls %u, %u redundant, %u sync points", gl.calls, gl.redundant, gl.syncPoints);
+                }
+                hud.render(fbWidth, fbHeight);
+                });
+            graph.write(hudPass, backbuffer);
         }
 
+        drawStats() = DrawStats();
+        if (graph.compile()) graph.execute();
+        jobs.waitAll(frameJobs);     // Jobs of culled passes, before their inputs change
+
+        const DrawStats& frameStats = drawStats();
+        frameTimeMetric.observe(deltaTime);
+        framesRenderedMetric.add();
+        drawCallsMetric.set(frameStats.drawCalls);
+        drawCallsTotalMetric.add(frameStats.drawCalls);
+        trianglesMetric.set(frameStats.triangles);
+        tileUploadsMetric.setTotal(world.getTilesStreamed());
+        tileUploadBytesMetric.setTotal(world.getBytesStreamed());
+        detailUploadsMetric.setTotal(residency.getUploadCount());
+        detailUploadBytesMetric.setTotal(residency.getUploadedBytes());
+        meshMemoryMetric.set(static_cast<double>(bus.getUploadedBytes() + WorldStreamer::getRingBytes()));
+        detailMemoryMetric.set(static_cast<double>(residency.getResidentBytes()));
+        targetMemoryMetric.set(static_cast<double>(graph.getPoolBytes()));
+
+        if (settings.captureToggled) {
+            if (capture.isRecording()) capture.stop();
+            else capture.start(settings.capturePng ? FrameCapture::FORMAT_PNG : FrameCapture::FORMAT_Y4M,
+                fbWidth, fbHeight, captureRate());
+            settings.captureToggled = false;
+        }
+        capture.capture(fbWidth, fbHeight);
+
+        if (settings.infoRequested) {
+            if (settings.multiView) multiView.printInfo();
+            bus.printMeshInfo();
+            if (interiorReady) interior.printMeshInfo();
+            graph.printInfo();
+            frameJobs.printInfo();
+            pacer.printInfo();
+            idle.printInfo();
+            metricsServer.printInfo();
+            GlTrace::printInfo();
+            if (capture.isRecording()) capture.printInfo();
+        }
+        settings.infoRequested = false;
+        pacer.mark(FramePacer::STAGE_RENDER);
+
         glfwSwapBuffers(window);
-        glfwPollEvents();
+        pacer.endFrame();
+        GlTrace::endFrame();
+        if (frameCount > 0 && ++framesRendered >= frameCount) glfwSetWindowShouldClose(window, true);
+
+        if (!startup.hasReported()) {
+            startup.mark("First frame");
+            startup.report();
+        }
     }
 
+    metricsServer.stop();
+    capture.cleanup();
+    pacer.cleanup();
+    graph.cleanup();
+    residency.cleanup();
     bus.cleanup();
     interior.cleanup();
+    portalRenderer.cleanup();
+    world.cleanup();
+    multiView.cleanup();
+    overdraw.cleanup();
+    hud.cleanup();
+    if (animatedShaderReady) animatedShader.cleanup();
+    if (lightingReady) lighting.cleanup();
     shader.cleanup();
     glfwDestroyWindow(window);
     glfwTerminate();
@@ -4,14 +4,87 @@
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
+#include <cmath>
 #include <vector>
 
 // ==================== BusInterior Class ====================
 class BusInterior {
 private:
-    std::vector<Cube> interiorParts;
+    // Contiguous range of interiorParts drawn together. Groups with a proxy
+    // are occlusion-tested; the rest (floor, walls, ...) are the occluders.
+    struct PartGroup {
+        size_t first;
+        size_t count;
+        int proxy;           // -1 = always drawn
+        bool shell;          // Side walls, hidden when looking in through windows
+        const char* name;    // For picking reports
+    };
+
+    // Parts in a pool carved from partArena; their geometry goes to
+    // geometryArena, emptied by every upload()
+    Arena partArena;
+    Arena geometryArena;
+    PartPool<Cube> cubes;
+    PartList<Cube> interiorParts;
+    std::vector<PartGroup> groups;
+    OcclusionCuller occlusion;
+    size_t groupStart;
+    const char* groupName;
+
+    // Part transforms in SoA form; world matrices are rebuilt in one batch per submit
+    mutable TransformBatch partTransforms;
+    mutable std::vector<glm::mat4> worldMatrices;
+
+    MeshBuffer mesh;
+    bool resident;           // GPU objects exist (upload() ran, release() not yet)
+    FaceCuller faceCuller;   // Faces buried in other parts, found once in build()
+    BVH partTree;            // Model-space part boxes (steering parts at rest)
+
+    // Steering wheel rim, hub and spokes turn about the column (x axis)
+    size_t steeringFirst, steeringCount;
+    glm::vec3 steeringCenter;
+    AnimationSystem* animation;
+    AnimationSystem::Channel steeringChannel;
+    float steeringTarget;
+
+    static const uint32_t CUBE_POOL_CHUNK = 256;
+    static const size_t PART_ARENA_BLOCK = 64 * 1024;
+    static const size_t GEOMETRY_ARENA_BLOCK = 128 * 1024;
+
+    static const int CEILING_LIGHT_COUNT = 4;
+    static float ceilingLightX(int i) {
+        static const float positions[CEILING_LIGHT_COUNT] = { -2.0f, -0.5f, 1.0f, 2.5f };
+        return positions[i];
+    }
+
+    void beginGroup(const char* name) {
+        groupStart = interiorParts.size();
+        groupName = name;
+    }
+
+    void endGroup(bool occludable, bool shell = false) {
+        PartGroup group;
+        group.first = groupStart;
+        group.count = interiorParts.size() - groupStart;
+        group.proxy = -1;
+        group.shell = shell;
+        group.name = groupName;
+
+        glm::vec3 minCorner(1e9f), maxCorner(-1e9f);
+        for (size_t i = group.first; i < group.first + group.count; i++) {
+            glm::vec3 half = interiorParts[i].getScale() * 0.5f;
+            minCorner = glm::min(minCorner, interiorParts[i].getPosition() - half);
+            maxCorner = glm::max(maxCorner, interiorParts[i].getPosition() + half);
+        }
+
+        if (occludable) group.proxy = occlusion.addProxy(minCorner, maxCorner);
+        groups.push_back(group);
+    }
+
 
     void createFloor() {
+        beginGroup("floor");
+
         // Main floor - blue with pattern
         // Position floor below the seats (at the actual bus floor level)
         interiorParts.emplace_back(
@@ -19,9 +92,13 @@ private:
             glm::vec3(7.8f, 0.05f, 1.8f),
             glm::vec3(0.2f, 0.3f, 0.6f)  // Blue floor
         );
+
+        endGroup(false);
     }
 
     void createCeiling() {
+        beginGroup("ceiling");
+
         // Ceiling
         interiorParts.emplace_back(
             glm::vec3(0.5f, 0.95f, 0.0f),
@@ -29,18 +106,24 @@ private:
             glm::vec3(0.85f, 0.85f, 0.85f)  // Light gray ceiling
         );
 
+        endGroup(false);
+        beginGroup("ceiling lights");
+
         // Ceiling lights (4 panels)
-        float lightPositions[] = { -2.0f, -0.5f, 1.0f, 2.5f };
-        for (int i = 0; i < 4; i++) {
+        for (int i = 0; i < CEILING_LIGHT_COUNT; i++) {
             interiorParts.emplace_back(
-                glm::vec3(lightPositions[i], 0.92f, 0.0f),
+                glm::vec3(ceilingLightX(i), 0.92f, 0.0f),
                 glm::vec3(0.6f, 0.02f, 0.4f),
                 glm::vec3(1.0f, 1.0f, 0.9f)  // Warm white light
             );
         }
+
+        endGroup(true);
     }
 
     void createWalls() {
+        beginGroup("walls");
+
         // Left wall (interior side)
         interiorParts.emplace_back(
             glm::vec3(0.5f, 0.0f, -0.95f),
@@ -54,9 +137,13 @@ private:
             glm::vec3(7.8f, 1.8f, 0.05f),
             glm::vec3(0.9f, 0.9f, 0.9f)
         );
+
+        endGroup(false, true);
     }
 
     void createHandrails() {
+        beginGroup("handrails");
+
         // Vertical handrail poles (yellow/gold) - 5 poles along the aisle
         float polePositions[] = { -2.5f, -1.0f, 0.5f, 2.0f, 3.5f };
 
@@ -82,6 +169,9 @@ private:
             glm::vec3(7.5f, 0.03f, 0.03f),
             glm::vec3(0.95f, 0.75f, 0.15f)
         );
+
+        // Thin poles make poor occludees, keep them unconditional
+        endGroup(false);
     }
 
     void createSeat(float xPos, float zPos, bool facingForward) {
@@ -175,10 +265,13 @@ private:
 
         for (int i = 0; i < numRows; i++) {
             float xPos = startX + (float)i * actualSpacing;
+            // One occlusion group per row
+            beginGroup("seats");
             // Left column
             createSeat(xPos, leftZ, true);
             // Right column
             createSeat(xPos, rightZ, true);
+            endGroup(true);
         }
     }
 
@@ -191,6 +284,9 @@ private:
 
         float floorY = -0.2f;
 
+        // Whole driver area (seat, dashboard, console, door panel) is one group
+        beginGroup("driver area");
+
         // ===== DRIVER SEAT =====
         float seatX = -3.3f;
         float seatY = floorY + 0.25f;
@@ -302,6 +398,8 @@ private:
         );
 
         // Steering wheel rim
+        steeringFirst = interiorParts.size();
+        steeringCenter = glm::vec3(wheelX, wheelY, wheelZ);
         interiorParts.emplace_back(
             glm::vec3(wheelX, wheelY, wheelZ),
             glm::vec3(0.03f, 0.3f, 0.3f),
@@ -328,6 +426,7 @@ private:
                 darkGray
             );
         }
+        steeringCount = interiorParts.size() - steeringFirst;
 
         // ===== CONTROL PANEL (Right side of dashboard) =====
         float panelX = dashX + 0.05f;
@@ -455,12 +554,32 @@ private:
                 black
             );
         }
+
+        endGroup(true);
+    }
+
+    // Rotates the steering parts about the wheel center by the channel's angle
+    void syncSteering() const {
+        if (!animation) return;
+        float angle = animation->value(steeringChannel);
+        glm::vec3 xAxis(1.0f, 0.0f, 0.0f);
+        float c = std::cos(angle), s = std::sin(angle);
+        for (size_t i = steeringFirst; i < steeringFirst + steeringCount; i++) {
+            glm::vec3 offset = interiorParts[i].getPosition() - steeringCenter;
+            partTransforms.ty[i] = steeringCenter.y + offset.y * c - offset.z * s;
+            partTransforms.tz[i] = steeringCenter.z + offset.y * s + offset.z * c;
+            partTransforms.setRotation(i, angle, xAxis);
+        }
     }
 
 public:
-    BusInterior() {}
+    BusInterior() : partArena(PART_ARENA_BLOCK), geometryArena(GEOMETRY_ARENA_BLOCK),
+        cubes(partArena, CUBE_POOL_CHUNK, &geometryArena), interiorParts(cubes), groupStart(0), groupName(""), resident(false), steeringFirst(0), steeringCount(0), steeringCenter(0.0f),
+        animation(nullptr), steeringChannel(-1), steeringTarget(0.0f) {
+    }
 
-    void initialize() {
+    // CPU only: part list, groups, occlusion proxies and the transform batch
+    void build() {
         createFloor();
         createCeiling();
         createWalls();
@@ -468,10 +587,93 @@ public:
         createSeats();
         createDriverArea();
 
-        // Setup all cubes
+        partTransforms.clear();
+        partTransforms.reserve(interiorParts.size());
+        for (const auto& part : interiorParts) {
+            partTransforms.add(part.getPosition(), part.getScale());
+        }
+        removeHiddenFaces();
+
+        std::vector<BoundingBox> bounds;
+        bounds.reserve(interiorParts.size());
+        for (const auto& part : interiorParts) {
+            glm::vec3 half = part.getScale() * 0.5f;
+            bounds.push_back(BoundingBox(part.getPosition() - half, part.getPosition() + half));
+        }
+        partTree.build(bounds);
+    }
+
+    // The masks stay on the parts, so rebuilds after release() keep them.
+    // Side walls are skipped when looking in through the windows and the
+    // steering parts turn, so neither hides faces; steering parts keep theirs.
+    void removeHiddenFaces() {
+        faceCuller.clear();
+        std::vector<bool> occluder(interiorParts.size(), true);
+        for (const auto& group : groups) {
+            if (!group.shell) continue;
+            for (size_t i = group.first; i < group.first + group.count; i++) occluder[i] = false;
+        }
+        for (size_t i = 0; i < interiorParts.size(); i++) {
+            bool steering = i >= steeringFirst && i < steeringFirst + steeringCount;
+            faceCuller.addBox(interiorParts[i].getPosition(), interiorParts[i].getScale(),
+                occluder[i] && !steering, !steering);
+        }
+        faceCuller.run();
         for (size_t i = 0; i < interiorParts.size(); i++) {
-            interiorParts[i].setup();
+            interiorParts[i].setHiddenFaces(faceCuller.hiddenFacesOf(static_cast<int>(i)));
+        }
+    }
+
+    // CPU only, safe on a worker thread. Returns the bytes upload() will write.
+    size_t createGeometry() {
+        size_t bytes = 0;
+        for (auto& part : interiorParts) {
+            part.createGeometry();
+            bytes += part.getGeometryBytes();
         }
+        return bytes;
+    }
+
+    // GL phase: every part into one shared buffer, written once
+    void upload() {
+        mesh.create();
+        for (auto& part : interiorParts) part.attach(mesh);
+        mesh.upload();
+        geometryArena.reset();     // attach() released every part's geometry
+        occlusion.setup();
+        resident = true;
+    }
+
+    // Frees the GPU objects but keeps the part list, so the interior can be
+    // rebuilt with createGeometry() + upload()
+    void release() {
+        mesh.cleanup();
+        occlusion.cleanup();
+        resident = false;
+    }
+
+    bool isResident() const { return resident; }
+
+    void initialize() {
+        build();
+        upload();
+    }
+
+    size_t getUploadedBytes() const { return mesh.getUploadedBytes(); }
+    const BVH& getPartTree() const { return partTree; }
+
+    const char* getPartGroupName(int part) const {
+        for (const auto& group : groups) {
+            if (static_cast<size_t>(part) >= group.first && static_cast<size_t>(part) < group.first + group.count) return group.name;
+        }
+        return "interior";
+    }
+
+    void printMeshInfo() const {
+        mesh.printInfo("Bus interior");
+        faceCuller.printInfo("Bus interior");
+        partArena.printInfo("Bus interior parts");
+        geometryArena.printInfo("Bus interior geometry");
     }
 
     void draw(const ShaderProgram& shader, const glm::mat4& baseModel) const {
@@ -480,10 +682,77 @@ public:
         }
     }
 
+    // Proxied groups are recorded with last frame's occlusion query, so the
+    // GPU skips them when their proxy box was hidden. Only while resident.
+    void submit(DrawList& list, const glm::mat4& baseModel, bool includeShell = true) const {
+        syncSteering();
+        TransformKernel::computeWorldMatrices(partTransforms, baseModel, worldMatrices);
+        for (const auto& group : groups) {
+            if (group.shell && !includeShell) continue;
+
+            unsigned int query = occlusion.getConditionQuery(group.proxy);
+            for (size_t i = group.first; i < group.first + group.count; i++) {
+                interiorParts[i].submitWorld(list, worldMatrices[i], query);
+            }
+        }
+    }
+
+    // Ceiling panels as point lights, only useful while the interior is drawn
+    void collectLights(ClusteredLighting& lighting, const glm::mat4& baseModel) const {
+        for (int i = 0; i < CEILING_LIGHT_COUNT; i++) {
+            PointLight light;
+            light.position = glm::vec3(baseModel * glm::vec4(ceilingLightX(i), 0.8f, 0.0f, 1.0f));
+            light.radius = 3.5f;
+            light.color = glm::vec3(1.0f, 1.0f, 0.9f);
+            light.intensity = 2.5f;
+            lighting.addLight(light);
+        }
+    }
+
+    void bindAnimation(AnimationSystem& system) {
+        animation = &system;
+        steeringChannel = system.addChannel(0.0f);
+    }
+
+    // -1 = full left, 0 = centered, 1 = full right; eased over a third of a second
+    void setSteering(float target) {
+        if (!animation || target == steeringTarget) return;
+        steeringTarget = target;
+        animation->animateTo(steeringChannel, target * glm::radians(120.0f), 0.35f);
+    }
+
+    // Steering wheel still easing towards its target
+    bool isAnimating() const {
+        return animation && !animation->isSettled(steeringChannel);
+    }
+
+    // Issue this frame's proxy queries; call once the submitted list is drawn
+    void issueOcclusionQueries(const ShaderProgram& shader, const glm::mat4& baseModel, const glm::vec3& viewPos) {
+        if (!resident) return;
+        glm::vec3 localEye = glm::vec3(glm::inverse(baseModel) * glm::vec4(viewPos, 1.0f));
+        occlusion.issueQueries(shader, baseModel, localEye);
+        occlusion.endFrame();
+    }
+
+    void toggleOcclusionCulling() {
+        occlusion.setEnabled(!occlusion.isEnabled());
+        std::cout << "Interior occlusion culling " << (occlusion.isEnabled() ? "ENABLED" : "DISABLED") << std::endl;
+    }
+
+    // Polls last frame's query results; cheap, but still GL calls
+    int getOccludedGroupCount() const { return occlusion.countOccluded(); }
+    int getOcclusionGroupCount() const { return occlusion.getProxyCount(); }
+
+    void printOcclusionInfo() const {
+        std::cout << "Occluded interior groups: " << occlusion.countOccluded()
+            << " / " << occlusion.getProxyCount() << std::endl;
+    }
+
     void cleanup() {
         for (size_t i = 0; i < interiorParts.size(); i++) {
             interiorParts[i].cleanup();
         }
+        release();
     }
 };
 
@@ -5,6 +5,7 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+#include <cmath>
 #include <fstream>
 #include <sstream>
 #include <iostream>
@@ -12,23 +13,89 @@
 
 // ==================== BusModel Class ====================
 class BusModel {
+public:
+    // Part ids in the animated mesh, as in vertex_animated.glsl
+    enum AnimatedPart {
+        PART_STATIC = 0,
+        PART_DOOR_LEFT = 1,
+        PART_DOOR_RIGHT = 2,
+        PART_HEADLIGHT = 3,
+        PART_TAILLIGHT = 4,
+        PART_WHEEL = 8          // 8 + wheel index
+    };
+
 private:
-    std::vector<Cube> bodyCubes;
-    std::vector<Cube> lightCubes;
-    std::vector<Cylinder> wheels;
-    std::vector<WheelSpokes> wheelSpokes;
+    // Parts live in pools carved from partArena, the groups below hold their
+    // handles; part geometry goes to geometryArena, which upload() empties
+    // again. reset() + build() reuses both, so respawning a bus does not
+    // touch the heap once it has been built once.
+    Arena partArena;
+    Arena geometryArena;
+    PartPool<Cube> cubes;
+    PartPool<Cylinder> cylinders;
+    PartPool<WheelSpokes> spokes;
+
+    PartList<Cube> bodyCubes;
+    PartList<Cube> lightCubes;
+    PartList<Cylinder> wheels;
+    PartList<WheelSpokes> wheelSpokes;
 
     // Door system
-    std::vector<Cube> frontDoorLeft;
-    std::vector<Cube> frontDoorRight;
-    std::vector<Cube> rearDoorLeft;
-    std::vector<Cube> rearDoorRight;
-
-    bool lightsOn;
+    PartList<Cube> frontDoorLeft;
+    PartList<Cube> frontDoorRight;
+    PartList<Cube> rearDoorLeft;
+    PartList<Cube> rearDoorRight;
+
+    static const uint32_t CUBE_POOL_CHUNK = 128;        // Body, lights and doors: 87 cubes
+    static const uint32_t WHEEL_POOL_CHUNK = 16;
+    static const size_t PART_ARENA_BLOCK = 32 * 1024;
+    static const size_t GEOMETRY_ARENA_BLOCK = 128 * 1024;
+
+    // Window openings the interior is rendered through
+    std::vector<Portal> portals;
+
+    // Every part's transform in one SoA batch, in the order
+    // body, lights, doors (FL, FR, RL, RR), wheels, spokes
+    mutable TransformBatch partTransforms;
+    std::vector<float> doorBaseX;      // Closed x position per door part
+    std::vector<float> doorSlideSign;  // -1 = slides left, +1 = slides right
+    size_t lightStart, doorStart, wheelStart, spokeStart;
+    mutable std::vector<glm::mat4> worldMatrices;
+
+    // Shared vertex/index storage for all parts (lights rebuilt by
+    // toggleLights() get buffers of their own)
+    MeshBuffer mesh;
+
+    // Body faces buried in other body parts, found once in build()
+    FaceCuller faceCuller;
+
+    // Model-space box per pickable part, in transform batch order up to the
+    // spokes (they stay inside their wheel's box). Refit when the doors move.
+    std::vector<BoundingBox> partBounds;
+    BVH partTree;
+    float boundsDoorOffset;
+
+    bool lightsOn;     // Switch state
+    bool lightsLit;    // Colors currently built into the light cubes
+    mutable int animatedLights;  // Light state in the animated shader's colors, -1 = not set since beginAnimated()
     float doorOffset;  // Current door offset (0.0 = closed, 1.0 = fully open)
-    float doorSpeed;   // Animation speed
-    bool doorsOpening;
-    bool doorsClosing;
+    float doorTarget;
+    bool doorsMoving;
+
+    // Door, wheel and light channels in the shared animation system
+    AnimationSystem* animation;
+    AnimationSystem::Channel doorChannel, wheelChannel, lightChannel;
+
+    static constexpr float DOOR_TRAVEL_TIME = 0.8f;   // Seconds, closed to fully open
+    static constexpr float DOOR_MAX_SLIDE = 0.45f;
+
+    // GPU-animated path: the whole bus in one static buffer, moving parts
+    // displaced in the vertex shader by part id
+    AnimatedMesh animatedMesh;
+    std::vector<glm::vec3> wheelCenters;
+
+    static glm::vec3 headlightColor(bool lit) { return lit ? glm::vec3(1.0f, 1.0f, 0.0f) : glm::vec3(0.1f, 0.1f, 0.1f); }
+    static glm::vec3 taillightColor(bool lit) { return lit ? glm::vec3(1.0f, 0.0f, 0.0f) : glm::vec3(0.1f, 0.0f, 0.0f); }
 
     void createBodyCubes() {
         bodyCubes.emplace_back(glm::vec3(0.5f, 0.0f, 0.0f), glm::vec3(8.0f, 2.0f, 2.0f), glm::vec3(0.96f, 0.95f, 0.92f));
@@ -51,7 +118,19 @@ private:
         addBottomPanels();
     }
 
+    void addPortal(const glm::vec3& center, const glm::vec3& size, const glm::vec3& normal) {
+        Portal portal;
+        portal.center = center;
+        portal.size = size;
+        portal.normal = normal;
+        portals.push_back(portal);
+    }
+
     void addDriverWindows() {
+        // Portals sit just in front of the border layer (front face at |z| = 1.065)
+        addPortal(glm::vec3(-3.2f, 0.3f, 1.066f), glm::vec3(0.4f, 0.6f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f));
+        addPortal(glm::vec3(-3.2f, 0.3f, -1.066f), glm::vec3(0.4f, 0.6f, 0.0f), glm::vec3(0.0f, 0.0f, -1.0f));
+
         bodyCubes.emplace_back(glm::vec3(-3.2f, 0.3f, 1.05f), glm::vec3(0.4f, 0.6f, 0.02f), glm::vec3(0.5f, 0.65f, 0.75f));
         bodyCubes.emplace_back(glm::vec3(-3.2f, 0.3f, 1.06f), glm::vec3(0.42f, 0.62f, 0.01f), glm::vec3(0.1f, 0.1f, 0.1f));
         bodyCubes.emplace_back(glm::vec3(-3.2f, 0.3f, 1.07f), glm::vec3(0.02f, 0.6f, 0.015f), glm::vec3(0.1f, 0.1f, 0.1f));
@@ -77,7 +156,7 @@ private:
         bodyCubes.emplace_back(glm::vec3(2.9f, -0.3f, 1.05f), glm::vec3(0.9f, 1.4f, 0.03f), glm::vec3(0.2f, 0.2f, 0.2f));
     }
 
-    void createDoorPanel(std::vector<Cube>& doorPanel, float xPos, bool isLeft) {
+    void createDoorPanel(PartList<Cube>& doorPanel, float xPos, bool isLeft) {
         doorPanel.clear();
 
         // Main door panel
@@ -99,12 +178,6 @@ private:
         // Create rear door panels (left and right) - positioned to meet in center when closed
         createDoorPanel(rearDoorLeft, 2.675f, true);     // Left panel center
         createDoorPanel(rearDoorRight, 3.125f, false);   // Right panel center
-
-        // Setup all door cubes
-        for (auto& cube : frontDoorLeft) cube.setup();
-        for (auto& cube : frontDoorRight) cube.setup();
-        for (auto& cube : rearDoorLeft) cube.setup();
-        for (auto& cube : rearDoorRight) cube.setup();
     }
 
     void addPassengerWindows() {
@@ -112,6 +185,9 @@ private:
         glm::vec3 borderCol(0.1f, 0.1f, 0.1f);
 
         for (float x : positions) {
+            addPortal(glm::vec3(x, 0.5f, 1.066f), glm::vec3(0.5f, 0.5f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f));
+            addPortal(glm::vec3(x, 0.5f, -1.066f), glm::vec3(0.5f, 0.5f, 0.0f), glm::vec3(0.0f, 0.0f, -1.0f));
+
             bodyCubes.emplace_back(glm::vec3(x, 0.5f, 1.05f), glm::vec3(0.5f, 0.5f, 0.02f), glm::vec3(0.4f, 0.5f, 0.6f));
             bodyCubes.emplace_back(glm::vec3(x, 0.5f, 1.06f), glm::vec3(0.52f, 0.52f, 0.01f), borderCol);
             bodyCubes.emplace_back(glm::vec3(x, 0.5f, 1.07f), glm::vec3(0.02f, 0.5f, 0.015f), borderCol);
@@ -124,12 +200,18 @@ private:
     }
 
     void addWindshield() {
+        // Glass is the frontmost layer (front face at x = -3.675)
+        addPortal(glm::vec3(-3.676f, 0.3f, 0.0f), glm::vec3(0.0f, 0.8f, 1.9f), glm::vec3(-1.0f, 0.0f, 0.0f));
+
         bodyCubes.emplace_back(glm::vec3(-3.6f, 0.3f, 0.0f), glm::vec3(0.15f, 0.8f, 1.9f), glm::vec3(0.5f, 0.65f, 0.75f));
         bodyCubes.emplace_back(glm::vec3(-3.59f, 0.3f, 0.0f), glm::vec3(0.14f, 0.82f, 1.92f), glm::vec3(0.1f, 0.1f, 0.1f));
         bodyCubes.emplace_back(glm::vec3(-3.58f, 0.3f, 0.0f), glm::vec3(0.13f, 0.8f, 0.03f), glm::vec3(0.1f, 0.1f, 0.1f));
     }
 
     void addRearWindows() {
+        addPortal(glm::vec3(4.561f, 0.4f, -0.45f), glm::vec3(0.0f, 0.7f, 0.7f), glm::vec3(1.0f, 0.0f, 0.0f));
+        addPortal(glm::vec3(4.561f, 0.4f, 0.45f), glm::vec3(0.0f, 0.7f, 0.7f), glm::vec3(1.0f, 0.0f, 0.0f));
+
         bodyCubes.emplace_back(glm::vec3(4.55f, 0.4f, -0.45f), glm::vec3(0.02f, 0.7f, 0.7f), glm::vec3(0.4f, 0.5f, 0.6f));
         bodyCubes.emplace_back(glm::vec3(4.55f, 0.4f, 0.45f), glm::vec3(0.02f, 0.7f, 0.7f), glm::vec3(0.4f, 0.5f, 0.6f));
     }
@@ -140,8 +222,8 @@ private:
     }
 
     void createLightCubes() {
-        glm::vec3 headlightCol = lightsOn ? glm::vec3(1.0f, 1.0f, 0.0f) : glm::vec3(0.1f, 0.1f, 0.1f);
-        glm::vec3 taillightCol = lightsOn ? glm::vec3(1.0f, 0.0f, 0.0f) : glm::vec3(0.1f, 0.0f, 0.0f);
+        glm::vec3 headlightCol = headlightColor(lightsLit);
+        glm::vec3 taillightCol = taillightColor(lightsLit);
 
         lightCubes.emplace_back(glm::vec3(-3.82f, -0.6f, 0.7f), glm::vec3(0.02f, 0.2f, 0.4f), headlightCol);
         lightCubes.emplace_back(glm::vec3(-3.82f, -0.6f, -0.7f), glm::vec3(0.02f, 0.2f, 0.4f), headlightCol);
@@ -154,20 +236,137 @@ private:
             wheels.emplace_back(glm::vec3(x, y, z), 0.4f, 0.2f, glm::vec3(0.1f, 0.1f, 0.1f));
             wheels.emplace_back(glm::vec3(x, y, z), 0.25f, 0.22f, glm::vec3(0.5f, 0.5f, 0.5f));
             wheelSpokes.emplace_back(glm::vec3(x, y, z), 0.25f, 0.22f);
+            wheelCenters.push_back(glm::vec3(x, y, z));
             };
 
         addWheel(1.0f);
         addWheel(-1.0f);
     }
 
+    // Light colors are baked into the vertices, so a color change rebuilds
+    // the four cubes (with buffers of their own)
+    void rebuildLightCubes() {
+        for (auto& cube : lightCubes) cube.cleanup();
+        lightCubes.clear();
+        createLightCubes();
+        for (auto& cube : lightCubes) cube.setup();
+        buildTransformBatch();
+    }
+
+    static glm::mat4 cubeRest(const Cube& cube) {
+        return glm::scale(glm::translate(glm::mat4(1.0f), cube.getPosition()), cube.getScale());
+    }
+
+    static glm::mat4 wheelRest(const glm::vec3& position) {
+        return glm::rotate(glm::translate(glm::mat4(1.0f), position), glm::radians(90.0f), glm::vec3(0.0f, 0.0f, 1.0f));
+    }
+
+    static void addDoorToAnimatedMesh(AnimatedMesh& target, PartList<Cube>& door, int partId) {
+        for (auto& cube : door) {
+            if (cube.getVertices().empty()) cube.createGeometry();
+            target.add(cube.getVertices(), cube.getIndices(), cubeRest(cube), partId);
+        }
+    }
+
+    // Rest-pose copy of every part, tagged by part id. Needs the CPU
+    // geometry, so it runs before the parts are attached to the mesh buffer.
+    void buildAnimatedMesh() {
+        for (auto& cube : bodyCubes) {
+            if (cube.getVertices().empty()) cube.createGeometry();
+            animatedMesh.add(cube.getVertices(), cube.getIndices(), cubeRest(cube), PART_STATIC);
+        }
+        for (size_t i = 0; i < lightCubes.size(); i++) {
+            Cube& cube = lightCubes[i];
+            if (cube.getVertices().empty()) cube.createGeometry();
+            animatedMesh.add(cube.getVertices(), cube.getIndices(), cubeRest(cube), i < 2 ? PART_HEADLIGHT : PART_TAILLIGHT);
+        }
+        addDoorToAnimatedMesh(animatedMesh, frontDoorLeft, PART_DOOR_LEFT);
+        addDoorToAnimatedMesh(animatedMesh, frontDoorRight, PART_DOOR_RIGHT);
+        addDoorToAnimatedMesh(animatedMesh, rearDoorLeft, PART_DOOR_LEFT);
+        addDoorToAnimatedMesh(animatedMesh, rearDoorRight, PART_DOOR_RIGHT);
+
+        // Two cylinders and one spoke set per wheel position
+        for (size_t i = 0; i < wheels.size(); i++) {
+            if (wheels[i].getVertices().empty()) wheels[i].createGeometry();
+            animatedMesh.add(wheels[i].getVertices(), wheels[i].getIndices(),
+                wheelRest(wheels[i].getPosition()), PART_WHEEL + static_cast<int>(i / 2));
+        }
+        for (size_t i = 0; i < wheelSpokes.size(); i++) {
+            if (wheelSpokes[i].getVertices().empty()) wheelSpokes[i].createSpokes(6);
+            animatedMesh.addArrays(wheelSpokes[i].getVertices(),
+                wheelRest(wheelSpokes[i].getPosition()), PART_WHEEL + static_cast<int>(i));
+        }
+        animatedMesh.upload();
+    }
+
+    void addDoorTransforms(const PartList<Cube>& door, float slideSign) {
+        for (const auto& cube : door) {
+            partTransforms.add(cube.getPosition(), cube.getScale());
+            doorBaseX.push_back(cube.getPosition().x);
+            doorSlideSign.push_back(slideSign);
+        }
+    }
+
+    void buildTransformBatch() {
+        partTransforms.clear();
+        doorBaseX.clear();
+        doorSlideSign.clear();
+
+        for (const auto& cube : bodyCubes) partTransforms.add(cube.getPosition(), cube.getScale());
+        lightStart = partTransforms.size();
+        for (const auto& cube : lightCubes) partTransforms.add(cube.getPosition(), cube.getScale());
+
+        doorStart = partTransforms.size();
+        addDoorTransforms(frontDoorLeft, -1.0f);
+        addDoorTransforms(frontDoorRight, 1.0f);
+        addDoorTransforms(rearDoorLeft, -1.0f);
+        addDoorTransforms(rearDoorRight, 1.0f);
+
+        // Wheel parts: translate, then rotate (90 + rotation) degrees about Z
+        wheelStart = partTransforms.size();
+        for (const auto& wheel : wheels) partTransforms.add(wheel.getPosition(), glm::vec3(1.0f));
+        spokeStart = partTransforms.size();
+        for (const auto& spoke : wheelSpokes) partTransforms.add(spoke.getPosition(), glm::vec3(1.0f));
+    }
+
+    // Door slide and wheel spin are the only per-frame changes
+    void syncAnimatedTransforms() const {
+        for (size_t i = 0; i < doorBaseX.size(); i++) {
+            partTransforms.tx[doorStart + i] = doorBaseX[i] + doorSlideSign[i] * doorOffset * DOOR_MAX_SLIDE;
+        }
+
+        glm::vec3 zAxis(0.0f, 0.0f, 1.0f);
+        for (size_t i = 0; i < wheels.size(); i++) {
+            partTransforms.setRotation(wheelStart + i, glm::radians(90.0f + wheels[i].rotation), zAxis);
+        }
+        for (size_t i = 0; i < wheelSpokes.size(); i++) {
+            partTransforms.setRotation(spokeStart + i, glm::radians(90.0f + wheelSpokes[i].rotation), zAxis);
+        }
+    }
+
 public:
     float busPosition;
 
-    BusModel() : lightsOn(true), busPosition(0.0f), doorOffset(0.0f),
-        doorSpeed(0.02f), doorsOpening(false), doorsClosing(false) {
+    BusModel() : partArena(PART_ARENA_BLOCK), geometryArena(GEOMETRY_ARENA_BLOCK),
+        cubes(partArena, CUBE_POOL_CHUNK, &geometryArena), cylinders(partArena, WHEEL_POOL_CHUNK, &geometryArena),
+        spokes(partArena, WHEEL_POOL_CHUNK, &geometryArena), bodyCubes(cubes), lightCubes(cubes), wheels(cylinders),
+        wheelSpokes(spokes), frontDoorLeft(cubes), frontDoorRight(cubes), rearDoorLeft(cubes), rearDoorRight(cubes),
+        lightStart(0), doorStart(0), wheelStart(0), spokeStart(0), boundsDoorOffset(0.0f), lightsOn(true), lightsLit(true), animatedLights(-1),
+        doorOffset(0.0f), doorTarget(0.0f), doorsMoving(false),
+        animation(nullptr), doorChannel(-1), wheelChannel(-1), lightChannel(-1), busPosition(0.0f) {
     }
 
-    void initialize() {
+    // Registers this bus's channels; door, wheel and light changes are
+    // animated from then on
+    void bindAnimation(AnimationSystem& system) {
+        animation = &system;
+        doorChannel = system.addChannel(doorOffset);
+        wheelChannel = system.addChannel(wheels.empty() ? 0.0f : wheels.front().rotation);
+        lightChannel = system.addChannel(lightsOn ? 1.0f : 0.0f);
+    }
+
+    // CPU only: part lists, portals and the transform batch
+    void build() {
         createBodyCubes();
         createLightCubes();
         addDoors();
@@ -175,54 +374,217 @@ public:
         createWheels(-0.5f, -1.0f);
         createWheels(2.0f, -1.0f);
         createWheels(3.8f, -1.0f);
+        buildTransformBatch();
+        removeHiddenFaces();
+        updatePartBounds();
+        partTree.build(partBounds);
+    }
 
-        for (auto& cube : bodyCubes) cube.setup();
-        for (auto& cube : lightCubes) cube.setup();
-        for (auto& wheel : wheels) wheel.setup();
-        for (auto& spoke : wheelSpokes) spoke.setup(6);
+    void updatePartBounds() {
+        syncAnimatedTransforms();
+        boundsDoorOffset = doorOffset;
+        partBounds.resize(spokeStart);
+        for (size_t i = 0; i < spokeStart; i++) {
+            glm::vec3 center(partTransforms.tx[i], partTransforms.ty[i], partTransforms.tz[i]);
+            glm::vec3 half = i < wheelStart
+                ? glm::vec3(partTransforms.sx[i], partTransforms.sy[i], partTransforms.sz[i]) * 0.5f
+                : wheels[i - wheelStart].getHalfExtent();     // Spinning about its axis keeps the box
+            partBounds[i] = BoundingBox(center - half, center + half);
+        }
     }
 
+    // Body parts hide each other's faces. Doors slide and light cubes are
+    // rebuilt, so they neither lose faces nor hide any. The shell is an
+    // occluder even though submit() drops it from inside the cabin: from
+    // there the interior walls, floor and ceiling cover what it hid.
+    void removeHiddenFaces() {
+        faceCuller.clear();
+        for (const auto& cube : bodyCubes) faceCuller.addBox(cube.getPosition(), cube.getScale(), true, true);
+        faceCuller.run();
+        for (size_t i = 0; i < bodyCubes.size(); i++) bodyCubes[i].setHiddenFaces(faceCuller.hiddenFacesOf(static_cast<int>(i)));
+    }
+
+    // CPU only: vertex/index data for every part, on the calling thread
+    void createGeometry() {
+        for (auto& cube : bodyCubes) cube.createGeometry();
+        for (auto& cube : lightCubes) cube.createGeometry();
+        for (auto& cube : frontDoorLeft) cube.createGeometry();
+        for (auto& cube : frontDoorRight) cube.createGeometry();
+        for (auto& cube : rearDoorLeft) cube.createGeometry();
+        for (auto& cube : rearDoorRight) cube.createGeometry();
+        for (auto& wheel : wheels) wheel.createGeometry();
+        for (auto& spoke : wheelSpokes) spoke.createSpokes(6);
+    }
+
+    // CPU only: vertex/index data for every part. Part groups are
+    // independent, so each one runs as its own pool task; wait on jobs
+    // before upload().
+    void createGeometry(ThreadPool& pool, std::vector<std::future<void>>& jobs) {
+        jobs.push_back(pool.submit([this] { for (auto& cube : bodyCubes) cube.createGeometry(); }));
+        jobs.push_back(pool.submit([this] { for (auto& cube : lightCubes) cube.createGeometry(); }));
+        jobs.push_back(pool.submit([this] {
+            for (auto& cube : frontDoorLeft) cube.createGeometry();
+            for (auto& cube : frontDoorRight) cube.createGeometry();
+            for (auto& cube : rearDoorLeft) cube.createGeometry();
+            for (auto& cube : rearDoorRight) cube.createGeometry();
+            }));
+        jobs.push_back(pool.submit([this] { for (auto& wheel : wheels) wheel.createGeometry(); }));
+        jobs.push_back(pool.submit([this] { for (auto& spoke : wheelSpokes) spoke.createSpokes(6); }));
+    }
+
+    // GL phase: all parts go into one shared buffer, written once.
+    // Parts without prebuilt geometry generate it here.
+    void upload() {
+        buildAnimatedMesh();
+        mesh.create();
+        for (auto& cube : bodyCubes) cube.attach(mesh);
+        for (auto& cube : lightCubes) cube.attach(mesh);
+        for (auto& cube : frontDoorLeft) cube.attach(mesh);
+        for (auto& cube : frontDoorRight) cube.attach(mesh);
+        for (auto& cube : rearDoorLeft) cube.attach(mesh);
+        for (auto& cube : rearDoorRight) cube.attach(mesh);
+        for (auto& wheel : wheels) wheel.attach(mesh);
+        for (auto& spoke : wheelSpokes) spoke.attach(mesh, 6);
+        mesh.upload();
+        geometryArena.reset();     // attach() released every part's geometry
+    }
+
+    void initialize() {
+        build();
+        upload();
+    }
+
+    // Despawn: destroys every part and rewinds both arenas, keeping their
+    // blocks (and the other containers' capacity) for the next build().
+    // GPU objects must be released first (cleanup()).
+    void reset() {
+        bodyCubes.release();
+        lightCubes.release();
+        frontDoorLeft.release();
+        frontDoorRight.release();
+        rearDoorLeft.release();
+        rearDoorRight.release();
+        wheels.release();
+        wheelSpokes.release();
+        cubes.clear();
+        cylinders.clear();
+        spokes.clear();
+        partArena.reset();
+        geometryArena.reset();
+
+        portals.clear();
+        partTransforms.clear();
+        doorBaseX.clear();
+        doorSlideSign.clear();
+        wheelCenters.clear();
+        lightStart = doorStart = wheelStart = spokeStart = 0;
+        faceCuller.clear();
+        partBounds.clear();
+        partTree.clear();
+    }
+
+    size_t getUploadedBytes() const { return mesh.getUploadedBytes(); }
+    void printMeshInfo() const {
+        mesh.printInfo("Bus exterior");
+        faceCuller.printInfo("Bus exterior");
+        partArena.printInfo("Bus exterior parts");
+        geometryArena.printInfo("Bus exterior geometry");
+    }
+
+    // Switching on flickers like a fluorescent tube, switching off fades out
     void toggleLights() {
         lightsOn = !lightsOn;
-        for (auto& cube : lightCubes) cube.cleanup();
-        lightCubes.clear();
-        createLightCubes();
-        for (auto& cube : lightCubes) cube.setup();
+        if (!animation) {
+            lightsLit = lightsOn;
+            rebuildLightCubes();
+            return;
+        }
+
+        if (lightsOn) {
+            animation->play(lightChannel, {
+                { 0.05f, 1.0f, EASE_LINEAR },
+                { 0.10f, 0.0f, EASE_LINEAR },
+                { 0.18f, 1.0f, EASE_LINEAR },
+                { 0.24f, 0.2f, EASE_LINEAR },
+                { 0.35f, 1.0f, EASE_OUT } });
+        }
+        else {
+            animation->animateTo(lightChannel, 0.0f, 0.15f, EASE_IN);
+        }
     }
 
     void openDoors() {
-        if (!doorsOpening && doorOffset < 1.0f) {
-            doorsOpening = true;
-            doorsClosing = false;
+        if (animation && doorTarget < 1.0f) {
+            doorTarget = 1.0f;
+            doorsMoving = true;
+            animation->animateTo(doorChannel, 1.0f, (1.0f - doorOffset) * DOOR_TRAVEL_TIME);
             std::cout << "Opening doors..." << std::endl;
         }
     }
 
     void closeDoors() {
-        if (!doorsClosing && doorOffset > 0.0f) {
-            doorsClosing = true;
-            doorsOpening = false;
+        if (animation && doorTarget > 0.0f) {
+            doorTarget = 0.0f;
+            doorsMoving = true;
+            animation->animateTo(doorChannel, 0.0f, doorOffset * DOOR_TRAVEL_TIME);
             std::cout << "Closing doors..." << std::endl;
         }
     }
 
-    void updateDoors() {
-        if (doorsOpening) {
-            doorOffset += doorSpeed;
-            if (doorOffset >= 1.0f) {
-                doorOffset = 1.0f;
-                doorsOpening = false;
-                std::cout << "Doors fully open" << std::endl;
-            }
+    // Wheel spin in degrees per second (follows the bus speed)
+    void setWheelSpeed(float degreesPerSecond) {
+        if (!animation || animation->getRate(wheelChannel) == degreesPerSecond) return;
+        // Rebase to one turn so the angle never loses precision
+        animation->setValue(wheelChannel, std::fmod(animation->value(wheelChannel), 360.0f));
+        animation->setRate(wheelChannel, degreesPerSecond);
+    }
+
+    // Doors sliding, wheels turning or lights flickering/fading: the bus will
+    // look different next frame even without input
+    bool isAnimating() const {
+        return animation && !(animation->isSettled(doorChannel) && animation->isSettled(wheelChannel) &&
+            animation->isSettled(lightChannel));
+    }
+
+    // Reads this bus's channels after AnimationSystem::update()
+    void updateAnimation() {
+        if (!animation) return;
+
+        doorOffset = animation->value(doorChannel);
+        if (doorOffset != boundsDoorOffset) {
+            updatePartBounds();
+            partTree.refit(partBounds);
+        }
+        if (doorsMoving && animation->isSettled(doorChannel)) {
+            doorsMoving = false;
+            std::cout << (doorTarget > 0.0f ? "Doors fully open" : "Doors fully closed") << std::endl;
         }
 
-        if (doorsClosing) {
-            doorOffset -= doorSpeed;
-            if (doorOffset <= 0.0f) {
-                doorOffset = 0.0f;
-                doorsClosing = false;
-                std::cout << "Doors fully closed" << std::endl;
-            }
+        updateWheelRotation(animation->value(wheelChannel));
+
+        bool lit = animation->value(lightChannel) > 0.5f;
+        if (lit != lightsLit) {
+            lightsLit = lit;
+            rebuildLightCubes();
+        }
+    }
+
+    // Headlights and taillights as point lights, dimmed with the light channel
+    // so the flicker and fade reach the scene too
+    void collectLights(ClusteredLighting& lighting, const glm::mat4& baseModel) const {
+        float level = animation ? animation->value(lightChannel) : (lightsLit ? 1.0f : 0.0f);
+        if (level <= 0.01f) return;
+
+        for (size_t i = 0; i < lightCubes.size(); i++) {
+            bool head = i < 2;
+            // Just outside the lens: front is -X, rear is +X
+            glm::vec3 local = lightCubes[i].getPosition() + glm::vec3(head ? -0.6f : 0.4f, 0.0f, 0.0f);
+            PointLight light;
+            light.position = glm::vec3(baseModel * glm::vec4(local, 1.0f));
+            light.radius = head ? 14.0f : 4.0f;
+            light.color = head ? glm::vec3(1.0f, 0.95f, 0.8f) : glm::vec3(1.0f, 0.1f, 0.05f);
+            light.intensity = (head ? 8.0f : 2.0f) * level;
+            lighting.addLight(light);
         }
     }
 
@@ -239,7 +601,7 @@ public:
         for (const auto& spoke : wheelSpokes) spoke.draw(shader, baseModel);
 
         // Draw sliding doors with offset
-        float maxSlide = 0.45f;  // Maximum slide distance
+        float maxSlide = DOOR_MAX_SLIDE;
 
         // Front doors
         glm::mat4 frontLeftTransform = glm::translate(baseModel, glm::vec3(-doorOffset * maxSlide, 0.0f, 0.0f));
@@ -256,6 +618,86 @@ public:
         for (const auto& cube : rearDoorRight) cube.draw(shader, rearRightTransform);
     }
 
+    // Same parts and transforms as draw(), recorded for sorted submission.
+    // From inside the cabin, body parts enclosing the eye are left out.
+    // World matrices come from one batched kernel call per frame.
+    void submit(DrawList& list, const glm::mat4& baseModel, const glm::vec3* cabinEye = nullptr) const {
+        syncAnimatedTransforms();
+        TransformKernel::computeWorldMatrices(partTransforms, baseModel, worldMatrices);
+
+        size_t i = 0;
+        for (const auto& cube : bodyCubes) {
+            if (!cabinEye || !cube.contains(*cabinEye)) cube.submitWorld(list, worldMatrices[i]);
+            i++;
+        }
+        for (const auto& cube : lightCubes) cube.submitWorld(list, worldMatrices[i++]);
+        for (const auto& cube : frontDoorLeft) cube.submitWorld(list, worldMatrices[i++]);
+        for (const auto& cube : frontDoorRight) cube.submitWorld(list, worldMatrices[i++]);
+        for (const auto& cube : rearDoorLeft) cube.submitWorld(list, worldMatrices[i++]);
+        for (const auto& cube : rearDoorRight) cube.submitWorld(list, worldMatrices[i++]);
+        for (const auto& wheel : wheels) wheel.submitWorld(list, worldMatrices[i++]);
+        for (const auto& spoke : wheelSpokes) spoke.submitWorld(list, worldMatrices[i++]);
+    }
+
+    // Whole bus in one draw: no per-part matrices, door slide, wheel spin
+    // and light colors come from uniforms. Binds the given shader (built
+    // from vertex_animated.glsl).
+    void drawAnimated(const ShaderProgram& animatedShader, const glm::mat4& baseModel,
+        const glm::mat4& view, const glm::mat4& projection) const {
+        beginAnimated(animatedShader, view, projection);
+        drawAnimated(animatedShader, baseModel, doorOffset, wheels.empty() ? 0.0f : wheels.front().rotation, lightsLit);
+    }
+
+    // Binds the animated shader and sets what every bus drawn from this
+    // one's buffer shares: the camera and the wheel hubs. Once per frame
+    // before drawing the fleet.
+    void beginAnimated(const ShaderProgram& animatedShader, const glm::mat4& view, const glm::mat4& projection) const {
+        static const char* const wheelCenterNames[] = { "wheelCenters[0]", "wheelCenters[1]", "wheelCenters[2]",
+            "wheelCenters[3]", "wheelCenters[4]", "wheelCenters[5]", "wheelCenters[6]", "wheelCenters[7]" };
+        animatedShader.use();
+        animatedShader.setMat4("view", view);
+        animatedShader.setMat4("projection", projection);
+        for (size_t i = 0; i < wheelCenters.size() && i < 8; i++) animatedShader.setVec3(wheelCenterNames[i], wheelCenters[i]);
+        animatedLights = -1;
+    }
+
+    // A bus sharing this one's buffer (the fleet), after beginAnimated(),
+    // with a door offset (0..1), wheel rotation (degrees) and lights of its
+    // own. Light colors are only sent when they change from the last bus.
+    void drawAnimated(const ShaderProgram& animatedShader, const glm::mat4& baseModel,
+        float doors, float wheelRotation, bool lit) const {
+        animatedShader.setMat4("model", baseModel);
+        animatedShader.setFloat("doorSlide", doors * DOOR_MAX_SLIDE);
+        animatedShader.setFloat("wheelAngle", glm::radians(wheelRotation));
+        if (animatedLights != static_cast<int>(lit)) {
+            animatedShader.setVec3("lightColors[0]", headlightColor(lit));
+            animatedShader.setVec3("lightColors[1]", taillightColor(lit));
+            animatedLights = static_cast<int>(lit);
+        }
+        animatedMesh.draw();
+    }
+
+    enum PartKind { PART_KIND_BODY, PART_KIND_LIGHT, PART_KIND_DOOR, PART_KIND_WHEEL };
+
+    // Kind of a part index from getPartTree()
+    PartKind getPartKind(int part) const {
+        size_t i = static_cast<size_t>(part);
+        if (i < lightStart) return PART_KIND_BODY;
+        if (i < doorStart) return PART_KIND_LIGHT;
+        if (i < wheelStart) return PART_KIND_DOOR;
+        return PART_KIND_WHEEL;
+    }
+
+    const BVH& getPartTree() const { return partTree; }
+    bool areDoorsOpening() const { return doorTarget > 0.0f; }
+
+    // bodyCubes[0] is the main shell
+    bool isInsideCabin(const glm::vec3& localPoint) const {
+        return !bodyCubes.empty() && bodyCubes.front().contains(localPoint);
+    }
+
+    const std::vector<Portal>& getPortals() const { return portals; }
+
     void cleanup() {
         for (auto& cube : bodyCubes) cube.cleanup();
         for (auto& cube : lightCubes) cube.cleanup();
@@ -265,6 +707,8 @@ public:
         for (auto& cube : rearDoorRight) cube.cleanup();
         for (auto& wheel : wheels) wheel.cleanup();
         for (auto& spoke : wheelSpokes) spoke.cleanup();
+        mesh.cleanup();
+        animatedMesh.cleanup();
     }
 };
 
@@ -7,6 +7,7 @@
 #include <glm/gtc/type_ptr.hpp>
 
 #include <fstream>
+#include <functional>
 #include <sstream>
 #include <iostream>
 #include <string>
@@ -29,6 +30,8 @@ private:
     float roll;              // Rotation around Z-axis
 
     float fov;               // Field of view for zoom
+    float nearPlane;
+    float farPlane;
     glm::mat4 projection;
     float mouseSensitivity;
 
@@ -69,7 +72,22 @@ private:
     float lookAtDistance;
     float lookAtRotationAngle;  // Current rotation angle around look-at point
 
+    // Free-flight moves go through this when set: (from, to) -> where the camera may go
+    std::function<glm::vec3(const glm::vec3&, const glm::vec3&)> collider;
+
+    unsigned long revision;  // Bumped whenever the view or projection changes
+
+    void moveBy(const glm::vec3& offset) {
+        if (orbitMode) return;  // Only allow movement in free-flight mode
+        glm::vec3 target = position + offset;
+        glm::vec3 moved = collider ? collider(position, target) : target;
+        if (moved == position) return;  // Blocked by collision
+        position = moved;
+        revision++;
+    }
+
     void updateCameraVectors() {
+        revision++;
         if (orbitMode) {
             // In orbit mode, calculate position based on spherical coordinates
             position.x = orbitTarget.x + orbitDistance * cos(glm::radians(orbitPitch)) * cos(glm::radians(orbitYaw));
@@ -102,9 +120,10 @@ private:
     }
 
     void updateProjectionMatrix() {
+        revision++;
         projection = glm::perspective(glm::radians(fov),
             (float)SCR_WIDTH / (float)SCR_HEIGHT,
-            0.1f, 100.0f);
+            nearPlane, farPlane);
     }
 
 public:
@@ -117,6 +136,8 @@ public:
         yaw(-90.0f),
         roll(0.0f),
         fov(45.0f),
+        nearPlane(0.1f),
+        farPlane(100.0f),
         mouseSensitivity(0.15f),
         orbitMode(false),
         orbitTarget(0.0f, 0.0f, 0.0f),
@@ -144,7 +165,8 @@ public:
         lookAtRotationMode(false),
         lookAtPoint(0.0f, 0.0f, 0.0f),
         lookAtDistance(5.0f),
-        lookAtRotationAngle(0.0f) {
+        lookAtRotationAngle(0.0f),
+        revision(0) {
 
         updateProjectionMatrix();
         updateCameraVectors();
@@ -152,39 +174,32 @@ public:
 
     // Movement controls with deltaTime (speed is units per second)
     void moveForward(float speed) {
-        if (!orbitMode) {  // Only allow movement in free-flight mode
-            position += front * speed;
-        }
+        moveBy(front * speed);
     }
 
     void moveBackward(float speed) {
-        if (!orbitMode) {
-            position -= front * speed;
-        }
+        moveBy(-front * speed);
     }
 
     void moveLeft(float speed) {
-        if (!orbitMode) {
-            position -= right * speed;
-        }
+        moveBy(-right * speed);
     }
 
     void moveRight(float speed) {
-        if (!orbitMode) {
-            position += right * speed;
-        }
+        moveBy(right * speed);
     }
 
     void moveUp(float speed) {
-        if (!orbitMode) {
-            position += worldUp * speed;  // Always move along world Y-axis
-        }
+        moveBy(worldUp * speed);  // Always move along world Y-axis
     }
 
     void moveDown(float speed) {
-        if (!orbitMode) {
-            position -= worldUp * speed;  // Always move along world Y-axis
-        }
+        moveBy(-worldUp * speed);  // Always move along world Y-axis
+    }
+
+    // Swept collision for free-flight moves; view switches still teleport
+    void setCollider(const std::function<glm::vec3(const glm::vec3&, const glm::vec3&)>& c) {
+        collider = c;
     }
 
     // Rotation controls with deltaTime (angle is degrees per second already calculated)
@@ -362,6 +377,7 @@ public:
         // Update yaw and pitch based on new direction
         yaw = glm::degrees(atan2(front.z, front.x));
         pitch = glm::degrees(asin(front.y));
+        revision++;
     }
 
     void stopLookAtRotation() {
@@ -435,10 +451,15 @@ public:
 
         // Map mouse position to rotation angles
         // X controls yaw (horizontal rotation around bus)
-        orbitYaw = normalizedX * 180.0f;  // -180 to +180 degrees
+        float newYaw = normalizedX * 180.0f;  // -180 to +180 degrees
 
         // Y controls pitch (vertical angle)
-        orbitPitch = -normalizedY * 89.0f;  // -89 to +89 degrees (inverted for natural feel)
+        float newPitch = -normalizedY * 89.0f;  // -89 to +89 degrees (inverted for natural feel)
+
+        // Called every frame; a still cursor must not count as a camera change
+        if (newYaw == orbitYaw && newPitch == orbitPitch) return;
+        orbitYaw = newYaw;
+        orbitPitch = newPitch;
 
         updateCameraVectors();
     }
@@ -467,6 +488,39 @@ public:
         return glm::lookAt(position, position + front, up);
     }
 
+    glm::vec3 getPosition() const {
+        return position;
+    }
+
+    // Changes with every move, turn or zoom; compare against a saved value to
+    // see whether the view needs redrawing
+    unsigned long getRevision() const { return revision; }
+
+    float getFov() const {
+        return fov;
+    }
+
+    float getNearPlane() const { return nearPlane; }
+    float getFarPlane() const { return farPlane; }
+
+    // Far enough to see the streamed world around the bus
+    void setFarPlane(float distance) {
+        farPlane = distance;
+        updateProjectionMatrix();
+    }
+
+    // Floating origin: the world moved by -shift, so every stored world-space
+    // point moves with it (view toggles restore shifted positions)
+    void shiftOrigin(const glm::vec3& shift) {
+        position -= shift;
+        savedPosition -= shift;
+        interiorSavedPosition -= shift;
+        driverSavedPosition -= shift;
+        orbitTarget -= shift;
+        lookAtPoint -= shift;
+        updateCameraVectors();
+    }
+
     glm::mat4 getProjectionMatrix() const {
         return projection;
     }
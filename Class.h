@@ -16,20 +16,29 @@ const float PI = 3.1415926536f;
 // ==================== Cube Class ====================
 class Cube {
 private:
-    unsigned int VAO, VBO, EBO;
+    MeshRange mesh;
+    unsigned int VBO, EBO;
+    bool ownsBuffers;        // false = lives in a shared MeshBuffer
     glm::vec3 position;
     glm::vec3 scale;
     glm::vec3 color;
-    unsigned int indexCount;
+    unsigned char hiddenFaces;   // FaceCuller::Face bits left out of the geometry
+    ArenaVector<float> vertices;         // In the owner's arena when given one
+    ArenaVector<unsigned int> indices;
 
 public:
-    Cube(const glm::vec3& pos, const glm::vec3& scl, const glm::vec3& col)
-        : VAO(0), VBO(0), EBO(0), position(pos), scale(scl), color(col), indexCount(0) {
+    Cube(const glm::vec3& pos, const glm::vec3& scl, const glm::vec3& col, Arena* arena = nullptr)
+        : VBO(0), EBO(0), ownsBuffers(false), position(pos), scale(scl), color(col), hiddenFaces(0),
+        vertices(ArenaAllocator<float>(arena)), indices(ArenaAllocator<unsigned int>(arena)) {
     }
 
-    void setup() {
+    // Faces found buried in other parts; takes effect at the next createGeometry()
+    void setHiddenFaces(unsigned char faces) { hiddenFaces = faces; }
+
+    // CPU only: fills vertices/indices; setup() or attach() uploads them
+    void createGeometry() {
         // Define 8 unique vertices for a cube
-        std::vector<float> vertices = {
+        vertices = {
             // Position (x, y, z)     Color (r, g, b)
             -0.5f, -0.5f, -0.5f,     color.r, color.g, color.b,  // 0
              0.5f, -0.5f, -0.5f,     color.r, color.g, color.b,  // 1
@@ -41,43 +50,61 @@ public:
             -0.5f,  0.5f,  0.5f,     color.r, color.g, color.b   // 7
         };
 
-        // Define indices for 6 faces (2 triangles per face)
-        std::vector<unsigned int> indices = {
-            // Front face
-            4, 5, 6,  4, 6, 7,
-            // Back face
-            1, 0, 3,  1, 3, 2,
-            // Left face
-            0, 4, 7,  0, 7, 3,
-            // Right face
-            5, 1, 2,  5, 2, 6,
-            // Top face
-            7, 6, 2,  7, 2, 3,
-            // Bottom face
-            0, 1, 5,  0, 5, 4
+        // Define indices for 6 faces (2 triangles per face), same order as FaceCuller::Face
+        static const unsigned int faceIndices[6][6] = {
+            { 4, 5, 6,  4, 6, 7 },   // Front face
+            { 1, 0, 3,  1, 3, 2 },   // Back face
+            { 0, 4, 7,  0, 7, 3 },   // Left face
+            { 5, 1, 2,  5, 2, 6 },   // Right face
+            { 7, 6, 2,  7, 2, 3 },   // Top face
+            { 0, 1, 5,  0, 5, 4 }    // Bottom face
         };
+        indices.clear();
+        indices.reserve(36);
+        for (int face = 0; face < 6; face++) {
+            if (hiddenFaces & (1 << face)) continue;
+            indices.insert(indices.end(), faceIndices[face], faceIndices[face] + 6);
+        }
+    }
 
-        indexCount = indices.size();
+    // Own VAO/VBO/EBO (standalone cubes: proxies, toggled lights, ...)
+    void setup() {
+        if (vertices.empty()) createGeometry();
 
-        glGenVertexArrays(1, &VAO);
+        glGenVertexArrays(1, &mesh.VAO);
         glGenBuffers(1, &VBO);
         glGenBuffers(1, &EBO);
+        uploadVertexData(mesh.VAO, VBO, EBO, vertices, indices);
+
+        mesh.first = 0;
+        mesh.count = static_cast<unsigned int>(indices.size());
+        mesh.baseVertex = 0;
+        mesh.indexed = true;
+        ownsBuffers = true;
+        releaseGeometry();
+    }
 
-        glBindVertexArray(VAO);
-
-        glBindBuffer(GL_ARRAY_BUFFER, VBO);
-        glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
-
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
+    // Appends to a shared buffer; drawable once the buffer is uploaded
+    void attach(MeshBuffer& buffer) {
+        if (vertices.empty()) createGeometry();
+        mesh = indices.empty() ? MeshRange() : buffer.add(vertices, indices);   // Fully buried: nothing to draw
+        ownsBuffers = false;
+        releaseGeometry();
+    }
 
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
-        glEnableVertexAttribArray(0);
+    // Indices first, the reverse of createGeometry(), so an arena takes both back
+    void releaseGeometry() {
+        ArenaVector<unsigned int>(indices.get_allocator()).swap(indices);
+        ArenaVector<float>(vertices.get_allocator()).swap(vertices);
+    }
 
-        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
-        glEnableVertexAttribArray(1);
+    // CPU geometry, valid between createGeometry() and setup()/attach()
+    const ArenaVector<float>& getVertices() const { return vertices; }
+    const ArenaVector<unsigned int>& getIndices() const { return indices; }
 
-        glBindVertexArray(0);
+    // Size of the CPU-built geometry (0 once uploaded)
+    size_t getGeometryBytes() const {
+        return vertices.size() * sizeof(float) + indices.size() * sizeof(unsigned int);
     }
 
     void draw(const ShaderProgram& shader, const glm::mat4& baseModel) const {
@@ -86,33 +113,71 @@ public:
         model = glm::scale(model, scale);
         shader.setMat4("model", model);
 
-        glBindVertexArray(VAO);
-        glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, 0);
+        glBindVertexArray(mesh.VAO);
+        drawMesh(mesh);
         glBindVertexArray(0);
     }
 
+    void submit(DrawList& list, const glm::mat4& baseModel, unsigned int conditionQuery = 0) const {
+        glm::mat4 model = baseModel;
+        model = glm::translate(model, position);
+        model = glm::scale(model, scale);
+        list.add(mesh, model, conditionQuery);
+    }
+
+    // Model matrix already computed (batched transform kernel)
+    void submitWorld(DrawList& list, const glm::mat4& model, unsigned int conditionQuery = 0) const {
+        list.add(mesh, model, conditionQuery);
+    }
+
+    const glm::vec3& getPosition() const { return position; }
+    const glm::vec3& getScale() const { return scale; }
+
+    bool contains(const glm::vec3& point) const {
+        glm::vec3 d = glm::abs(point - position) * 2.0f;
+        return d.x < scale.x && d.y < scale.y && d.z < scale.z;
+    }
+
     void cleanup() {
-        glDeleteVertexArrays(1, &VAO);
+        if (!ownsBuffers) return;
+        glDeleteVertexArrays(1, &mesh.VAO);
         glDeleteBuffers(1, &VBO);
         glDeleteBuffers(1, &EBO);
+        ownsBuffers = false;
     }
 };
 
 // ==================== Cylinder Class (with EBO) ====================
 class Cylinder {
 private:
-    unsigned int VAO, VBO, EBO;
+    MeshRange mesh;
+    unsigned int VBO, EBO;
+    bool ownsBuffers;
     glm::vec3 position;
     float radius;
     float height;
     glm::vec3 color;
-    std::vector<float> vertices;
-    std::vector<unsigned int> indices;
+    ArenaVector<float> vertices;         // In the owner's arena when given one
+    ArenaVector<unsigned int> indices;
+
+    // Local-space bounds (axis along Z)
+    glm::vec3 halfExtent() const { return glm::vec3(radius, radius, height * 0.5f); }
+
+public:
+    float rotation;
+
+    Cylinder(const glm::vec3& pos, float r, float h, const glm::vec3& col, Arena* arena = nullptr)
+        : VBO(0), EBO(0), ownsBuffers(false), position(pos), radius(r), height(h), color(col),
+        vertices(ArenaAllocator<float>(arena)), indices(ArenaAllocator<unsigned int>(arena)), rotation(0.0f) {
+    }
 
+    // CPU only: fills vertices/indices; setup() or attach() uploads them
     void createGeometry() {
         vertices.clear();
         indices.clear();
         int segments = 30;
+        vertices.reserve((2 + 2 * segments) * 6);
+        indices.reserve(segments * 12);
 
         // Generate vertices for top and bottom circles
         // Center vertices for caps
@@ -167,52 +232,71 @@ private:
         }
     }
 
-public:
-    float rotation;
-
-    Cylinder(const glm::vec3& pos, float r, float h, const glm::vec3& col)
-        : VAO(0), VBO(0), EBO(0), position(pos), radius(r), height(h), color(col), rotation(0.0f) {
-    }
-
     void setup() {
-        createGeometry();
+        if (vertices.empty()) createGeometry();
 
-        glGenVertexArrays(1, &VAO);
+        glGenVertexArrays(1, &mesh.VAO);
         glGenBuffers(1, &VBO);
         glGenBuffers(1, &EBO);
+        uploadVertexData(mesh.VAO, VBO, EBO, vertices, indices);
+
+        mesh.first = 0;
+        mesh.count = static_cast<unsigned int>(indices.size());
+        mesh.baseVertex = 0;
+        mesh.indexed = true;
+        ownsBuffers = true;
+        releaseGeometry();
+    }
 
-        glBindVertexArray(VAO);
+    void attach(MeshBuffer& buffer) {
+        if (vertices.empty()) createGeometry();
+        mesh = indices.empty() ? MeshRange() : buffer.add(vertices, indices);   // Fully buried: nothing to draw
+        ownsBuffers = false;
+        releaseGeometry();
+    }
 
-        glBindBuffer(GL_ARRAY_BUFFER, VBO);
-        glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
+    void releaseGeometry() {
+        ArenaVector<unsigned int>(indices.get_allocator()).swap(indices);
+        ArenaVector<float>(vertices.get_allocator()).swap(vertices);
+    }
 
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
+    // CPU geometry, valid between createGeometry() and setup()/attach()
+    const ArenaVector<float>& getVertices() const { return vertices; }
+    const ArenaVector<unsigned int>& getIndices() const { return indices; }
 
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
-        glEnableVertexAttribArray(0);
-        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
-        glEnableVertexAttribArray(1);
+    void draw(const ShaderProgram& shader, const glm::mat4& baseModel) const {
+        glm::mat4 model = baseModel;
+        model = glm::translate(model, position);
+        model = glm::rotate(model, glm::radians(90.0f), glm::vec3(0.0f, 0.0f, 1.0f));
+        model = glm::rotate(model, glm::radians(rotation), glm::vec3(0.0f, 0.0f, 1.0f));
+        shader.setMat4("model", model);
 
+        glBindVertexArray(mesh.VAO);
+        drawMesh(mesh);
         glBindVertexArray(0);
     }
 
-    void draw(const ShaderProgram& shader, const glm::mat4& baseModel) const {
+    void submit(DrawList& list, const glm::mat4& baseModel) const {
         glm::mat4 model = baseModel;
         model = glm::translate(model, position);
         model = glm::rotate(model, glm::radians(90.0f), glm::vec3(0.0f, 0.0f, 1.0f));
         model = glm::rotate(model, glm::radians(rotation), glm::vec3(0.0f, 0.0f, 1.0f));
-        shader.setMat4("model", model);
+        list.add(mesh, model, 0, halfExtent());
+    }
 
-        glBindVertexArray(VAO);
-        glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0);
-        glBindVertexArray(0);
+    void submitWorld(DrawList& list, const glm::mat4& model) const {
+        list.add(mesh, model, 0, halfExtent());
     }
 
+    const glm::vec3& getPosition() const { return position; }
+    glm::vec3 getHalfExtent() const { return halfExtent(); }
+
     void cleanup() {
-        glDeleteVertexArrays(1, &VAO);
+        if (!ownsBuffers) return;
+        glDeleteVertexArrays(1, &mesh.VAO);
         glDeleteBuffers(1, &VBO);
         glDeleteBuffers(1, &EBO);
+        ownsBuffers = false;
     }
 };
 
@@ -220,14 +304,29 @@ public:
 // ==================== WheelSpokes Class ====================
 class WheelSpokes {
 private:
-    unsigned int VAO, VBO;
+    MeshRange mesh;
+    unsigned int VBO;
+    bool ownsBuffers;
     glm::vec3 position;
     float radius;
     float height;
-    std::vector<float> vertices;
+    ArenaVector<float> vertices;
+
+    // Local-space bounds; spoke faces sit 0.01 outside the wheel
+    glm::vec3 halfExtent() const { return glm::vec3(radius, radius, height * 0.5f + 0.01f); }
+
+public:
+    float rotation;
 
+    WheelSpokes(const glm::vec3& pos, float r, float h, Arena* arena = nullptr)
+        : VBO(0), ownsBuffers(false), position(pos), radius(r), height(h), vertices(ArenaAllocator<float>(arena)), rotation(0.0f) {
+    }
+
+    // CPU only: fills vertices; setup() or attach() uploads them
     void createSpokes(int numSpokes) {
+        int segments = 20;
         vertices.clear();
+        vertices.reserve((numSpokes + segments) * 6 * 6);
         glm::vec3 spokeColor(1.0f, 1.0f, 1.0f);
 
         auto addVertex = [this](float x, float y, float z, const glm::vec3& col) {
@@ -252,7 +351,6 @@ private:
             addVertex(radius * 0.7f * cos(angle), radius * 0.7f * sin(angle), -height / 2 - 0.01f, spokeColor);
         }
 
-        int segments = 20;
         float hubRadius = radius * 0.15f;
         glm::vec3 hubColor(0.7f, 0.7f, 0.7f);
 
@@ -270,31 +368,34 @@ private:
         }
     }
 
-public:
-    float rotation;
-
-    WheelSpokes(const glm::vec3& pos, float r, float h)
-        : VAO(0), VBO(0), position(pos), radius(r), height(h), rotation(0.0f) {
-    }
-
     void setup(int numSpokes = 6) {
-        createSpokes(numSpokes);
+        if (vertices.empty()) createSpokes(numSpokes);
 
-        glGenVertexArrays(1, &VAO);
+        glGenVertexArrays(1, &mesh.VAO);
         glGenBuffers(1, &VBO);
+        uploadVertexData(mesh.VAO, VBO, 0, vertices, std::vector<unsigned int>());
 
-        glBindVertexArray(VAO);
-        glBindBuffer(GL_ARRAY_BUFFER, VBO);
-        glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
+        mesh.first = 0;
+        mesh.count = static_cast<unsigned int>(vertices.size() / 6);
+        mesh.indexed = false;
+        ownsBuffers = true;
+        releaseGeometry();
+    }
 
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
-        glEnableVertexAttribArray(0);
-        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
-        glEnableVertexAttribArray(1);
+    void attach(MeshBuffer& buffer, int numSpokes = 6) {
+        if (vertices.empty()) createSpokes(numSpokes);
+        mesh = buffer.addArrays(vertices);
+        ownsBuffers = false;
+        releaseGeometry();
+    }
 
-        glBindVertexArray(0);
+    void releaseGeometry() {
+        ArenaVector<float>(vertices.get_allocator()).swap(vertices);
     }
 
+    // CPU geometry, valid between createSpokes() and setup()/attach()
+    const ArenaVector<float>& getVertices() const { return vertices; }
+
     void draw(const ShaderProgram& shader, const glm::mat4& baseModel) const {
         glm::mat4 model = baseModel;
         model = glm::translate(model, position);
@@ -302,14 +403,30 @@ public:
         model = glm::rotate(model, glm::radians(rotation), glm::vec3(0.0f, 0.0f, 1.0f));
         shader.setMat4("model", model);
 
-        glBindVertexArray(VAO);
-        glDrawArrays(GL_TRIANGLES, 0, vertices.size() / 6);
+        glBindVertexArray(mesh.VAO);
+        drawMesh(mesh);
         glBindVertexArray(0);
     }
 
+    void submit(DrawList& list, const glm::mat4& baseModel) const {
+        glm::mat4 model = baseModel;
+        model = glm::translate(model, position);
+        model = glm::rotate(model, glm::radians(90.0f), glm::vec3(0.0f, 0.0f, 1.0f));
+        model = glm::rotate(model, glm::radians(rotation), glm::vec3(0.0f, 0.0f, 1.0f));
+        list.add(mesh, model, 0, halfExtent());
+    }
+
+    void submitWorld(DrawList& list, const glm::mat4& model) const {
+        list.add(mesh, model, 0, halfExtent());
+    }
+
+    const glm::vec3& getPosition() const { return position; }
+
     void cleanup() {
-        glDeleteVertexArrays(1, &VAO);
+        if (!ownsBuffers) return;
+        glDeleteVertexArrays(1, &mesh.VAO);
         glDeleteBuffers(1, &VBO);
+        ownsBuffers = false;
     }
 };
 
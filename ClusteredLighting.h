@@ -0,0 +1,269 @@
+#ifndef CLUSTEREDLIGHTING_H
+#define CLUSTEREDLIGHTING_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+struct PointLight {
+    glm::vec3 position;      // World space
+    float radius;            // Contribution reaches zero here
+    glm::vec3 color;
+    float intensity;
+};
+
+// ==================== ClusteredLighting Class ====================
+// Clustered forward shading for many point lights. The view frustum is cut
+// into GRID_X x GRID_Y screen tiles and GRID_Z depth slices (exponential in
+// view depth, so near clusters stay small). Every frame each light's sphere
+// is bounded in view space and appended to the clusters it overlaps; the
+// fragment shader (fragment_clustered.glsl) finds its cluster from
+// gl_FragCoord and view depth and shades only that cluster's lights.
+// Light culling costs one bounds test per light plus one write per
+// light/cluster overlap, and shading cost follows the local light density
+// instead of the total light count.
+// GL 3.3 has no storage buffers: lights, cluster ranges and the index list
+// go to the shader as buffer textures.
+class ClusteredLighting {
+public:
+    static const int GRID_X = 16;
+    static const int GRID_Y = 9;
+    static const int GRID_Z = 24;
+    static const int CLUSTER_COUNT = GRID_X * GRID_Y * GRID_Z;
+    static const int MAX_LIGHTS = 1024;
+    static const int MAX_LIGHTS_PER_CLUSTER = 64;   // Further lights in a full cluster are dropped
+
+private:
+    // Texture units used by the buffer textures
+    static const int LIGHT_UNIT = 1;
+    static const int CLUSTER_UNIT = 2;
+    static const int INDEX_UNIT = 3;
+
+    struct ClusterBounds {
+        int x0, x1, y0, y1, z0, z1;   // Inclusive
+    };
+
+    ShaderProgram shader;
+    unsigned int lightBuffer, clusterBuffer, indexBuffer;
+    unsigned int lightTexture, clusterTexture, indexTexture;
+
+    std::vector<PointLight> lights;
+
+    // Per-frame culling output, uploaded as is
+    std::vector<float> lightData;            // View position + radius, color + intensity
+    std::vector<unsigned int> clusterData;   // First index, count
+    std::vector<unsigned int> lightIndices;
+    std::vector<ClusterBounds> bounds;       // Per visible light
+    std::vector<unsigned int> clusterCursor;
+
+    float zNear, zFar;
+    int visibleLights;
+    int droppedEntries;
+    int busiestCluster;
+
+    int sliceFor(float depth) const {
+        float scale = GRID_Z / std::log(zFar / zNear);
+        int slice = static_cast<int>(std::floor(std::log(std::max(depth, zNear) / zNear) * scale));
+        return std::min(std::max(slice, 0), GRID_Z - 1);
+    }
+
+    static int tileFor(float ndc, int tiles) {
+        int tile = static_cast<int>(std::floor((ndc * 0.5f + 0.5f) * tiles));
+        return std::min(std::max(tile, 0), tiles - 1);
+    }
+
+    // Conservative cluster range of a view-space sphere; false if outside the frustum
+    bool boundSphere(const glm::vec3& center, float radius, const glm::mat4& projection, ClusterBounds& out) const {
+        float depth = -center.z;
+        if (depth + radius < zNear || depth - radius > zFar) return false;
+        out.z0 = sliceFor(depth - radius);
+        out.z1 = sliceFor(depth + radius);
+
+        // Crossing the near plane: the projection is unbounded, take every tile
+        if (depth - radius <= zNear) {
+            out.x0 = out.y0 = 0;
+            out.x1 = GRID_X - 1;
+            out.y1 = GRID_Y - 1;
+            return true;
+        }
+
+        // x/w and y/w are monotonic over the box, so its corners bound the sphere on screen
+        float minX = 1e9f, maxX = -1e9f, minY = 1e9f, maxY = -1e9f;
+        for (int i = 0; i < 8; i++) {
+            glm::vec3 corner = center + glm::vec3(i & 1 ? radius : -radius,
+                i & 2 ? radius : -radius, i & 4 ? radius : -radius);
+            glm::vec4 clip = projection * glm::vec4(corner, 1.0f);
+            minX = std::min(minX, clip.x / clip.w);
+            maxX = std::max(maxX, clip.x / clip.w);
+            minY = std::min(minY, clip.y / clip.w);
+            maxY = std::max(maxY, clip.y / clip.w);
+        }
+        if (maxX < -1.0f || minX > 1.0f || maxY < -1.0f || minY > 1.0f) return false;
+
+        out.x0 = tileFor(minX, GRID_X);
+        out.x1 = tileFor(maxX, GRID_X);
+        out.y0 = tileFor(minY, GRID_Y);
+        out.y1 = tileFor(maxY, GRID_Y);
+        return true;
+    }
+
+    static int clusterIndex(int x, int y, int z) {
+        return (z * GRID_Y + y) * GRID_X + x;
+    }
+
+    static void createBufferTexture(unsigned int& buffer, unsigned int& texture, GLenum format) {
+        glGenBuffers(1, &buffer);
+        glBindBuffer(GL_TEXTURE_BUFFER, buffer);
+        glBufferData(GL_TEXTURE_BUFFER, 16, nullptr, GL_STREAM_DRAW);
+        glGenTextures(1, &texture);
+        glBindTexture(GL_TEXTURE_BUFFER, texture);
+        glTexBuffer(GL_TEXTURE_BUFFER, format, buffer);
+        glBindTexture(GL_TEXTURE_BUFFER, 0);
+        glBindBuffer(GL_TEXTURE_BUFFER, 0);
+    }
+
+    // Orphans the previous store, so the upload never waits on last frame's draws
+    template <typename T>
+    static void uploadBuffer(unsigned int buffer, const std::vector<T>& data) {
+        glBindBuffer(GL_TEXTURE_BUFFER, buffer);
+        glBufferData(GL_TEXTURE_BUFFER, data.size() * sizeof(T), data.data(), GL_STREAM_DRAW);
+        glBindBuffer(GL_TEXTURE_BUFFER, 0);
+    }
+
+public:
+    ClusteredLighting()
+        : lightBuffer(0), clusterBuffer(0), indexBuffer(0),
+        lightTexture(0), clusterTexture(0), indexTexture(0),
+        zNear(0.1f), zFar(100.0f), visibleLights(0), droppedEntries(0), busiestCluster(0) {
+    }
+
+    bool setup() {
+        if (!shader.create("vertex.glsl", "fragment_clustered.glsl")) return false;
+        createBufferTexture(lightBuffer, lightTexture, GL_RGBA32F);
+        createBufferTexture(clusterBuffer, clusterTexture, GL_RG32UI);
+        createBufferTexture(indexBuffer, indexTexture, GL_R32UI);
+
+        shader.use();
+        shader.setInt("lightData", LIGHT_UNIT);
+        shader.setInt("clusterData", CLUSTER_UNIT);
+        shader.setInt("lightIndices", INDEX_UNIT);
+        return true;
+    }
+
+    void clearLights() { lights.clear(); }
+
+    void addLight(const PointLight& light) {
+        if (lights.size() < static_cast<size_t>(MAX_LIGHTS)) lights.push_back(light);
+    }
+
+    // CPU culling: bins every light into the clusters its sphere overlaps.
+    // Two passes over the overlaps (count, then fill) build one compact index list.
+    void cull(const glm::mat4& view, const glm::mat4& projection, float nearPlane, float farPlane) {
+        zNear = nearPlane;
+        zFar = farPlane;
+
+        lightData.clear();
+        bounds.clear();
+        clusterData.assign(CLUSTER_COUNT * 2, 0u);
+        for (const PointLight& light : lights) {
+            glm::vec3 center = glm::vec3(view * glm::vec4(light.position, 1.0f));
+            ClusterBounds b;
+            if (!boundSphere(center, light.radius, projection, b)) continue;
+
+            bounds.push_back(b);
+            lightData.insert(lightData.end(), { center.x, center.y, center.z, light.radius,
+                light.color.r, light.color.g, light.color.b, light.intensity });
+            for (int z = b.z0; z <= b.z1; z++)
+                for (int y = b.y0; y <= b.y1; y++)
+                    for (int x = b.x0; x <= b.x1; x++) clusterData[clusterIndex(x, y, z) * 2 + 1]++;
+        }
+        visibleLights = static_cast<int>(bounds.size());
+
+        unsigned int offset = 0;
+        droppedEntries = 0;
+        busiestCluster = 0;
+        for (int c = 0; c < CLUSTER_COUNT; c++) {
+            unsigned int count = clusterData[c * 2 + 1];
+            busiestCluster = std::max(busiestCluster, static_cast<int>(count));
+            if (count > static_cast<unsigned int>(MAX_LIGHTS_PER_CLUSTER)) {
+                droppedEntries += count - MAX_LIGHTS_PER_CLUSTER;
+                count = MAX_LIGHTS_PER_CLUSTER;
+            }
+            clusterData[c * 2] = offset;
+            clusterData[c * 2 + 1] = count;
+            offset += count;
+        }
+
+        lightIndices.resize(std::max(offset, 1u));
+        clusterCursor.assign(CLUSTER_COUNT, 0u);
+        for (size_t i = 0; i < bounds.size(); i++) {
+            const ClusterBounds& b = bounds[i];
+            for (int z = b.z0; z <= b.z1; z++)
+                for (int y = b.y0; y <= b.y1; y++)
+                    for (int x = b.x0; x <= b.x1; x++) {
+                        int c = clusterIndex(x, y, z);
+                        if (clusterCursor[c] == clusterData[c * 2 + 1]) continue;
+                        lightIndices[clusterData[c * 2] + clusterCursor[c]++] = static_cast<unsigned int>(i);
+                    }
+        }
+        if (lightData.empty()) lightData.assign(8, 0.0f);
+    }
+
+    void upload() {
+        uploadBuffer(lightBuffer, lightData);
+        uploadBuffer(clusterBuffer, clusterData);
+        uploadBuffer(indexBuffer, lightIndices);
+    }
+
+    // Binds the lit shader and the cluster data; lights must be culled for the same view
+    void bind(const glm::mat4& view, const glm::mat4& projection, int fbWidth, int fbHeight, const glm::vec3& ambient) const {
+        shader.use();
+        shader.setMat4("view", view);
+        shader.setMat4("projection", projection);
+        shader.setVec3("ambient", ambient);
+        glUniform3i(glGetUniformLocation(shader.getID(), "gridSize"), GRID_X, GRID_Y, GRID_Z);
+        glUniform2f(glGetUniformLocation(shader.getID(), "screenSize"),
+            static_cast<float>(std::max(fbWidth, 1)), static_cast<float>(std::max(fbHeight, 1)));
+        shader.setFloat("zNear", zNear);
+        shader.setFloat("sliceScale", GRID_Z / std::log(zFar / zNear));
+
+        glActiveTexture(GL_TEXTURE0 + LIGHT_UNIT);
+        glBindTexture(GL_TEXTURE_BUFFER, lightTexture);
+        glActiveTexture(GL_TEXTURE0 + CLUSTER_UNIT);
+        glBindTexture(GL_TEXTURE_BUFFER, clusterTexture);
+        glActiveTexture(GL_TEXTURE0 + INDEX_UNIT);
+        glBindTexture(GL_TEXTURE_BUFFER, indexTexture);
+        glActiveTexture(GL_TEXTURE0);
+    }
+
+    const ShaderProgram& getShader() const { return shader; }
+    size_t getLightCount() const { return lights.size(); }
+    int getVisibleLightCount() const { return visibleLights; }
+    size_t getIndexCount() const { return lightIndices.size(); }
+
+    void printInfo() const {
+        std::cout << "Clustered lighting: " << lights.size() << " lights, " << visibleLights << " in view, "
+            << lightIndices.size() << " cluster entries over " << CLUSTER_COUNT << " clusters ("
+            << GRID_X << "x" << GRID_Y << "x" << GRID_Z << "), busiest cluster " << busiestCluster;
+        if (droppedEntries > 0) std::cout << ", " << droppedEntries << " entries dropped";
+        std::cout << std::endl;
+    }
+
+    void cleanup() {
+        if (lightTexture) glDeleteTextures(1, &lightTexture);
+        if (clusterTexture) glDeleteTextures(1, &clusterTexture);
+        if (indexTexture) glDeleteTextures(1, &indexTexture);
+        if (lightBuffer) glDeleteBuffers(1, &lightBuffer);
+        if (clusterBuffer) glDeleteBuffers(1, &clusterBuffer);
+        if (indexBuffer) glDeleteBuffers(1, &indexBuffer);
+        lightTexture = clusterTexture = indexTexture = 0;
+        lightBuffer = clusterBuffer = indexBuffer = 0;
+        shader.cleanup();
+    }
+};
+
+#endif
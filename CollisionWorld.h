@@ -0,0 +1,182 @@
+#ifndef COLLISIONWORLD_H
+#define COLLISIONWORLD_H
+
+#include <glm/glm.hpp>
+
+#include <iostream>
+#include <vector>
+
+// ==================== CollisionWorld Class ====================
+// Two-level BVH for picking and camera collision. Every model (a bus
+// exterior, its interior, ...) keeps its own part tree in model space; the
+// world holds one instance per model with its model matrix, and a top-level
+// tree over the instances' world boxes. Queries walk the top tree, move the
+// ray into each candidate's model space and walk its part tree there, so a
+// fleet of buses sharing one part tree costs one instance each.
+// Boxes containing the query's start point are treated as hollow: from
+// inside the cabin the shell is neither picked nor collided with. A swept
+// sphere is tested as a ray against boxes grown by its radius, slightly
+// conservative at box edges and corners.
+// Model matrices must be rigid (rotation + translation).
+class CollisionWorld {
+public:
+    struct Hit {
+        int instance;
+        int tag;             // Caller's id given to addInstance()
+        int item;            // Part index in that instance's tree
+        float distance;      // Along the ray (unit direction) or fraction of the sweep
+        glm::vec3 point;
+        glm::vec3 normal;    // World space, from the entered box face
+    };
+
+private:
+    struct Instance {
+        const BVH* tree;
+        int tag;
+        bool enabled;
+        glm::mat4 model;
+        glm::mat4 inverseModel;
+    };
+
+    std::vector<Instance> instances;
+    BVH topLevel;
+    std::vector<BoundingBox> instanceBounds;
+    bool structureChanged;
+
+    static const int MAX_SLIDES = 3;
+    static constexpr float SKIN = 1e-3f;     // Kept between the sphere and what it touched
+
+    static BoundingBox transformBox(const BoundingBox& box, const glm::mat4& model) {
+        BoundingBox out;
+        for (int i = 0; i < 8; i++) {
+            glm::vec3 corner((i & 1) ? box.maxCorner.x : box.minCorner.x,
+                (i & 2) ? box.maxCorner.y : box.minCorner.y,
+                (i & 4) ? box.maxCorner.z : box.minCorner.z);
+            out.grow(glm::vec3(model * glm::vec4(corner, 1.0f)));
+        }
+        return out;
+    }
+
+    // Nearest hit of the ray grown by 'inflate' (a sphere sweep when > 0)
+    bool cast(const glm::vec3& origin, const glm::vec3& direction, float tMax, float inflate, Hit& hit) const {
+        Ray worldRay(origin, direction);
+        bool found = false;
+        int topItem;
+        glm::vec3 topNormal;
+
+        topLevel.raycast(worldRay, inflate, tMax, topItem, topNormal,
+            [&](int instanceIndex, float& t, glm::vec3& normalOut) {
+                const Instance& instance = instances[instanceIndex];
+                if (!instance.enabled || !instance.tree) return false;
+
+                glm::vec3 localOrigin = glm::vec3(instance.inverseModel * glm::vec4(origin, 1.0f));
+                Ray localRay(localOrigin, glm::mat3(instance.inverseModel) * direction);
+                float tLocal = tMax;
+                int item;
+                glm::vec3 normal;
+                bool hitPart = instance.tree->raycast(localRay, inflate, tLocal, item, normal,
+                    [&](int part, float&, glm::vec3&) {
+                        return !instance.tree->getItemBounds(part).contains(localOrigin, inflate);
+                    });
+                if (!hitPart) return false;
+
+                t = tLocal;
+                normalOut = glm::mat3(instance.model) * normal;
+                hit.instance = instanceIndex;
+                hit.tag = instance.tag;
+                hit.item = item;
+                hit.distance = tLocal;
+                hit.point = origin + direction * tLocal;
+                hit.normal = normalOut;
+                found = true;
+                return true;
+            });
+        return found;
+    }
+
+public:
+    CollisionWorld() : structureChanged(false) {}
+
+    // The tree is referenced, not copied; refit it in place when parts move
+    int addInstance(const BVH* tree, int tag) {
+        Instance instance;
+        instance.tree = tree;
+        instance.tag = tag;
+        instance.enabled = true;
+        instance.model = instance.inverseModel = glm::mat4(1.0f);
+        instances.push_back(instance);
+        structureChanged = true;
+        return static_cast<int>(instances.size() - 1);
+    }
+
+    void setTransform(int instance, const glm::mat4& model) {
+        instances[instance].model = model;
+        instances[instance].inverseModel = glm::inverse(model);
+    }
+
+    // Disabled instances stay in the top tree but are never hit
+    void setEnabled(int instance, bool enabled) { instances[instance].enabled = enabled; }
+
+    // Once per frame after transforms and part trees are current: refits the
+    // top tree, rebuilding it only when instances were added
+    void update() {
+        instanceBounds.resize(instances.size());
+        for (size_t i = 0; i < instances.size(); i++) {
+            const Instance& instance = instances[i];
+            instanceBounds[i] = instance.tree ? transformBox(instance.tree->getBounds(), instance.model) : BoundingBox();
+        }
+        if (structureChanged) topLevel.build(instanceBounds);
+        else topLevel.refit(instanceBounds);
+        structureChanged = false;
+    }
+
+    // Nearest part along a ray; 'direction' is normalized here
+    bool pick(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, Hit& hit) const {
+        float length = glm::length(direction);
+        if (length <= 0.0f) return false;
+        return cast(origin, direction / length, maxDistance, 0.0f, hit);
+    }
+
+    // Moves a sphere from 'from' towards 'to', stopping at the first part it
+    // touches and sliding the rest of the move along that surface
+    glm::vec3 moveSphere(const glm::vec3& from, const glm::vec3& to, float radius) const {
+        glm::vec3 position = from;
+        glm::vec3 move = to - from;
+        for (int slide = 0; slide < MAX_SLIDES; slide++) {
+            float length = glm::length(move);
+            if (length < 1e-6f) break;
+
+            Hit hit;
+            if (!cast(position, move, 1.0f, radius, hit)) {
+                position += move;
+                break;
+            }
+
+            float travel = std::max(hit.distance - SKIN / length, 0.0f);
+            position += move * travel;
+            glm::vec3 remaining = move * (1.0f - travel);
+            move = remaining - hit.normal * glm::dot(remaining, hit.normal);
+        }
+        return position;
+    }
+
+    size_t getInstanceCount() const { return instances.size(); }
+
+    void printInfo() const {
+        size_t parts = 0;
+        for (const Instance& instance : instances) {
+            if (instance.tree) parts += instance.tree->getItemCount();
+        }
+        std::cout << "Collision: " << instances.size() << " instances (" << topLevel.getNodeCount()
+            << " top-level nodes), " << parts << " parts" << std::endl;
+    }
+
+    void clear() {
+        instances.clear();
+        instanceBounds.clear();
+        topLevel.clear();
+        structureChanged = false;
+    }
+};
+
+#endif
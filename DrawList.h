@@ -0,0 +1,138 @@
+#ifndef DRAWLIST_H
+#define DRAWLIST_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <vector>
+
+// ==================== DrawPacket Struct ====================
+// Everything needed to issue one draw call, recorded ahead of submission so
+// the frame can be sorted and replayed (depth prepass, overdraw pass, ...)
+struct DrawPacket {
+    MeshRange mesh;
+    glm::mat4 model;
+    unsigned int conditionQuery;  // Occlusion query for conditional render (0 = none)
+    glm::vec3 halfExtent;         // Local-space bounds around the origin
+    unsigned int viewMask;        // Multi-view: bit i set = visible in view i
+    float sortKey;
+};
+
+// ==================== DrawList Class ====================
+class DrawList {
+private:
+    std::vector<DrawPacket> packets;
+
+    // Parts sharing a MeshBuffer share a VAO, so consecutive packets rarely rebind
+    static void bindVertexArray(unsigned int VAO, unsigned int& boundVAO) {
+        if (VAO == boundVAO) return;
+        glBindVertexArray(VAO);
+        boundVAO = VAO;
+    }
+
+public:
+    void clear() {
+        packets.clear();
+    }
+
+    void add(const MeshRange& mesh, const glm::mat4& model,
+        unsigned int conditionQuery = 0, const glm::vec3& halfExtent = glm::vec3(0.5f)) {
+        if (mesh.count == 0) return;
+        DrawPacket packet;
+        packet.mesh = mesh;
+        packet.model = model;
+        packet.conditionQuery = conditionQuery;
+        packet.halfExtent = halfExtent;
+        packet.viewMask = ~0u;
+        packet.sortKey = 0.0f;
+        packets.push_back(packet);
+    }
+
+    // Nearest part origin first, so later fragments fail the depth test early
+    void sortFrontToBack(const glm::vec3& viewPos) {
+        for (auto& packet : packets) {
+            glm::vec3 d = glm::vec3(packet.model[3]) - viewPos;
+            packet.sortKey = glm::dot(d, d);
+        }
+        std::sort(packets.begin(), packets.end(), [](const DrawPacket& a, const DrawPacket& b) {
+            return a.sortKey < b.sortKey;
+            });
+    }
+
+    void execute(const ShaderProgram& shader) const {
+        unsigned int boundVAO = 0;
+        for (const auto& packet : packets) {
+            if (packet.conditionQuery) glBeginConditionalRender(packet.conditionQuery, GL_QUERY_NO_WAIT);
+
+            shader.setMat4("model", packet.model);
+            bindVertexArray(packet.mesh.VAO, boundVAO);
+            drawMesh(packet.mesh);
+
+            if (packet.conditionQuery) glEndConditionalRender();
+        }
+        glBindVertexArray(0);
+    }
+
+    // Optional depth-only pass first, then shade each visible pixel once
+    void render(const ShaderProgram& shader, bool depthPrepass) const {
+        if (depthPrepass) {
+            glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+            glDepthFunc(GL_LESS);
+            execute(shader);
+            glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+            glDepthFunc(GL_LEQUAL);
+            glDepthMask(GL_FALSE);
+        }
+        execute(shader);
+        glDepthMask(GL_TRUE);
+    }
+
+    // Multi-view: visibility(packet) returns the packet's view bits
+    template <typename Visibility>
+    void assignViewMasks(Visibility visibility) {
+        for (auto& packet : packets) {
+            packet.viewMask = visibility(packet);
+        }
+    }
+
+    template <typename Fn>
+    void forEachPacket(Fn fn) const {
+        for (const auto& packet : packets) fn(packet);
+    }
+
+    // One view at a time: packets without the view's bit are skipped.
+    // Occlusion results belong to the single-view camera, so no conditional render.
+    void executeView(const ShaderProgram& shader, unsigned int viewBit) const {
+        unsigned int boundVAO = 0;
+        for (const auto& packet : packets) {
+            if (!(packet.viewMask & viewBit)) continue;
+            shader.setMat4("model", packet.model);
+            bindVertexArray(packet.mesh.VAO, boundVAO);
+            drawMesh(packet.mesh);
+        }
+        glBindVertexArray(0);
+    }
+
+    // All views in one draw per packet; the geometry shader replicates
+    // each triangle into the viewports named by "viewMask"
+    void executeViewMasked(const ShaderProgram& shader) const {
+        unsigned int boundVAO = 0;
+        for (const auto& packet : packets) {
+            if (!packet.viewMask) continue;
+            shader.setMat4("model", packet.model);
+            shader.setInt("viewMask", static_cast<int>(packet.viewMask));
+            bindVertexArray(packet.mesh.VAO, boundVAO);
+            drawMesh(packet.mesh);
+        }
+        glBindVertexArray(0);
+    }
+
+    void append(const DrawList& other) {
+        packets.insert(packets.end(), other.packets.begin(), other.packets.end());
+    }
+
+    size_t size() const { return packets.size(); }
+};
+
+#endif
@@ -0,0 +1,152 @@
+#ifndef FACECULLER_H
+#define FACECULLER_H
+
+#include <glm/glm.hpp>
+
+#include <cmath>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+// ==================== FaceCuller Class ====================
+// Bake-time hidden surface removal for models built from axis-aligned boxes.
+// A face is hidden when it lies inside another solid box (closed test, so a
+// face pressed flat against a neighbour with the opposite normal counts too):
+// nothing outside the model can see it, and it only costs vertices, raster
+// and depth tests. Boxes register as occluders (solid and always drawn
+// whenever the faces they hide could be seen) and/or removable (static, so
+// a face hidden now stays hidden).
+// Faces lying on an occluder's face with the same normal are not hidden,
+// they z-fight; they are counted so the model can be fixed.
+// Also checks winding, which back-face culling depends on: orientOutward()
+// makes every triangle of a part counter-clockwise seen from outside.
+class FaceCuller {
+public:
+    // Same order as the face index pairs in Cube::createGeometry()
+    enum Face { FACE_FRONT, FACE_BACK, FACE_LEFT, FACE_RIGHT, FACE_TOP, FACE_BOTTOM, FACE_COUNT };
+
+private:
+    struct Box {
+        glm::vec3 minCorner, maxCorner;
+        bool occluder;
+        bool removable;
+        unsigned char hidden;   // Bit per Face
+    };
+
+    std::vector<Box> boxes;
+    size_t hiddenFaces;
+    size_t coplanarFaces;
+    size_t removableFaces;
+
+    static constexpr float EPSILON = 1e-4f;     // Model units, well below the layer spacing
+
+    static int faceAxis(int face) {
+        static const int axes[FACE_COUNT] = { 2, 2, 0, 0, 1, 1 };
+        return axes[face];
+    }
+
+    static bool facePositive(int face) {
+        return face == FACE_FRONT || face == FACE_RIGHT || face == FACE_TOP;
+    }
+
+    // 0 = visible, 1 = inside the occluder, 2 = on its face with the same normal
+    int classify(const Box& box, int face, const Box& occluder) const {
+        int axis = faceAxis(face);
+        bool positive = facePositive(face);
+        float plane = positive ? box.maxCorner[axis] : box.minCorner[axis];
+        if (plane < occluder.minCorner[axis] - EPSILON || plane > occluder.maxCorner[axis] + EPSILON) return 0;
+
+        for (int other = 0; other < 3; other++) {
+            if (other == axis) continue;
+            if (box.minCorner[other] < occluder.minCorner[other] - EPSILON ||
+                box.maxCorner[other] > occluder.maxCorner[other] + EPSILON) return 0;
+        }
+
+        float sameSide = positive ? occluder.maxCorner[axis] : occluder.minCorner[axis];
+        return std::fabs(plane - sameSide) <= EPSILON ? 2 : 1;
+    }
+
+public:
+    FaceCuller() : hiddenFaces(0), coplanarFaces(0), removableFaces(0) {}
+
+    // Returns the id for hiddenFacesOf()
+    int addBox(const glm::vec3& center, const glm::vec3& size, bool occluder, bool removable) {
+        Box box;
+        box.minCorner = center - size * 0.5f;
+        box.maxCorner = center + size * 0.5f;
+        box.occluder = occluder;
+        box.removable = removable;
+        box.hidden = 0;
+        boxes.push_back(box);
+        return static_cast<int>(boxes.size() - 1);
+    }
+
+    // Every removable face against every occluder; models have a few hundred boxes
+    void run() {
+        hiddenFaces = coplanarFaces = removableFaces = 0;
+        for (size_t i = 0; i < boxes.size(); i++) {
+            Box& box = boxes[i];
+            box.hidden = 0;
+            if (!box.removable) continue;
+
+            for (int face = 0; face < FACE_COUNT; face++) {
+                removableFaces++;
+                bool coplanar = false;
+                for (size_t j = 0; j < boxes.size() && !(box.hidden & (1 << face)); j++) {
+                    if (j == i || !boxes[j].occluder) continue;
+                    int result = classify(box, face, boxes[j]);
+                    if (result == 1) box.hidden |= static_cast<unsigned char>(1 << face);
+                    else if (result == 2) coplanar = true;
+                }
+                if (box.hidden & (1 << face)) hiddenFaces++;
+                else if (coplanar) coplanarFaces++;
+            }
+        }
+    }
+
+    unsigned char hiddenFacesOf(int box) const { return boxes[box].hidden; }
+
+    void clear() {
+        boxes.clear();
+        hiddenFaces = coplanarFaces = removableFaces = 0;
+    }
+
+    // Rewinds triangles that face the part's vertex centroid. Valid for the
+    // parts here (boxes, cylinders, flat spoke fans): each is convex or flat
+    // around its own origin. Returns the number of triangles flipped.
+    static size_t orientOutward(const std::vector<float>& vertices, std::vector<unsigned int>& indices) {
+        const int stride = 6;
+        size_t vertexCount = vertices.size() / stride;
+        if (vertexCount == 0) return 0;
+
+        auto position = [&vertices](unsigned int v) {
+            return glm::vec3(vertices[v * stride], vertices[v * stride + 1], vertices[v * stride + 2]);
+        };
+        glm::vec3 centroid(0.0f);
+        for (size_t v = 0; v < vertexCount; v++) centroid += position(static_cast<unsigned int>(v));
+        centroid /= static_cast<float>(vertexCount);
+
+        size_t flipped = 0;
+        for (size_t t = 0; t + 2 < indices.size(); t += 3) {
+            glm::vec3 p0 = position(indices[t]);
+            glm::vec3 p1 = position(indices[t + 1]);
+            glm::vec3 p2 = position(indices[t + 2]);
+            glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+            if (glm::dot(normal, (p0 + p1 + p2) / 3.0f - centroid) < 0.0f) {
+                std::swap(indices[t + 1], indices[t + 2]);
+                flipped++;
+            }
+        }
+        return flipped;
+    }
+
+    void printInfo(const char* label) const {
+        if (removableFaces == 0) return;
+        std::cout << label << " faces: " << hiddenFaces << " of " << removableFaces
+            << " hidden and removed (" << hiddenFaces * 2 << " triangles)";
+        if (coplanarFaces > 0) std::cout << ", " << coplanarFaces << " coplanar with another part (z-fighting)";
+        std::cout << std::endl;
+    }
+};
+
+#endif
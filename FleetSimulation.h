@@ -0,0 +1,555 @@
+#ifndef FLEETSIMULATION_H
+#define FLEETSIMULATION_H
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+// ==================== FleetRoute Class ====================
+// Closed Catmull-Rom spline through control points on the ground plane
+// (x, z), with stops at route distances. An arc-length table (cumulative
+// length at fine parameter steps) is inverted once at build time into
+// samples every SAMPLE_SPACING units of route, so a route distance maps to
+// a point and heading with one lookup and a lerp.
+class FleetRoute {
+private:
+    std::vector<float> sampleX, sampleZ;     // Sample i is at route distance i * SAMPLE_SPACING (mod length)
+    std::vector<float> tangentX, tangentZ;   // Unit direction of travel
+    std::vector<float> stops;                // Ascending route distances
+    float length;
+
+    static glm::vec2 point(const glm::vec2& p0, const glm::vec2& p1, const glm::vec2& p2, const glm::vec2& p3, float t) {
+        return 0.5f * (2.0f * p1 + (p2 - p0) * t + (2.0f * p0 - 5.0f * p1 + 4.0f * p2 - p3) * t * t +
+            (p3 - p0 + 3.0f * (p1 - p2)) * t * t * t);
+    }
+
+    static glm::vec2 derivative(const glm::vec2& p0, const glm::vec2& p1, const glm::vec2& p2, const glm::vec2& p3, float t) {
+        return 0.5f * ((p2 - p0) + 2.0f * (2.0f * p0 - 5.0f * p1 + 4.0f * p2 - p3) * t +
+            3.0f * (p3 - p0 + 3.0f * (p1 - p2)) * t * t);
+    }
+
+public:
+    static constexpr float SAMPLE_SPACING = 0.5f;
+    static const int STEPS_PER_SEGMENT = 64;     // Arc-length table resolution
+
+    FleetRoute() : length(0.0f) {}
+
+    // At least 3 control points, in driving order; the last joins the first.
+    // Keep neighbouring spacings within a factor of about two: a route that
+    // turns back on itself anywhere is rejected.
+    bool build(const std::vector<glm::vec2>& controlPoints) {
+        size_t n = controlPoints.size();
+        if (n < 3) {
+            std::cerr << "ERROR::FLEETROUTE::TOO_FEW_POINTS\n" << n << " control points" << std::endl;
+            return false;
+        }
+        auto control = [&](size_t segment, int offset) {
+            return controlPoints[(segment + n + offset) % n];
+        };
+
+        // Arc-length table: cumulative chord length at every parameter step
+        size_t tableSize = n * STEPS_PER_SEGMENT + 1;
+        std::vector<float> arcLength(tableSize, 0.0f);
+        glm::vec2 previous = controlPoints[0];
+        for (size_t j = 1; j < tableSize; j++) {
+            size_t segment = (j - 1) / STEPS_PER_SEGMENT;
+            float t = static_cast<float>(j - segment * STEPS_PER_SEGMENT) / STEPS_PER_SEGMENT;
+            glm::vec2 p = point(control(segment, -1), control(segment, 0), control(segment, 1), control(segment, 2), t);
+            arcLength[j] = arcLength[j - 1] + glm::length(p - previous);
+            previous = p;
+        }
+        length = arcLength.back();
+
+        // Inverted: the parameter at each sample distance, found by walking
+        // the table, then the spline itself at that parameter
+        size_t count = static_cast<size_t>(length / SAMPLE_SPACING) + 2;
+        sampleX.resize(count);
+        sampleZ.resize(count);
+        tangentX.resize(count);
+        tangentZ.resize(count);
+        size_t j = 0;
+        for (size_t i = 0; i < count; i++) {
+            float distance = std::fmod(static_cast<float>(i) * SAMPLE_SPACING, length);
+            if (i > 0 && distance < arcLength[j]) j = 0;     // Past the end: around again
+            while (j + 2 < tableSize && arcLength[j + 1] < distance) j++;
+            float span = arcLength[j + 1] - arcLength[j];
+            float f = span > 0.0f ? (distance - arcLength[j]) / span : 0.0f;
+            float u = (static_cast<float>(j) + f) / STEPS_PER_SEGMENT;
+            size_t segment = std::min(static_cast<size_t>(u), n - 1);
+            float t = u - static_cast<float>(segment);
+
+            glm::vec2 p0 = control(segment, -1), p1 = control(segment, 0), p2 = control(segment, 1), p3 = control(segment, 2);
+            glm::vec2 p = point(p0, p1, p2, p3, t);
+            glm::vec2 d = derivative(p0, p1, p2, p3, t);
+            float dLength = glm::length(d);
+            d = dLength > 0.0f ? d / dLength : glm::vec2(1.0f, 0.0f);
+            sampleX[i] = p.x;
+            sampleZ[i] = p.y;
+            tangentX[i] = d.x;
+            tangentZ[i] = d.y;
+        }
+
+        // Uniform Catmull-Rom overshoots into cusps and loops where neighbouring
+        // segments differ a lot in length; the heading then reverses in a sample
+        for (size_t i = 1; i < count; i++) {
+            if (tangentX[i - 1] * tangentX[i] + tangentZ[i - 1] * tangentZ[i] < 0.0f) {
+                std::cerr << "ERROR::FLEETROUTE::SHARP_TURN\nAt route distance " << static_cast<float>(i) * SAMPLE_SPACING << std::endl;
+                sampleX.clear();
+                sampleZ.clear();
+                tangentX.clear();
+                tangentZ.clear();
+                length = 0.0f;
+                return false;
+            }
+        }
+        stops.clear();
+        return true;
+    }
+
+    void addStop(float distance) {
+        distance = std::fmod(distance, length);
+        if (distance < 0.0f) distance += length;
+        stops.insert(std::upper_bound(stops.begin(), stops.end(), distance), distance);
+    }
+
+    // 'distance' in [0, length)
+    void sample(float distance, glm::vec2& position, glm::vec2& direction) const {
+        float u = distance * (1.0f / SAMPLE_SPACING);
+        size_t i = std::min(static_cast<size_t>(u), sampleX.size() - 2);
+        float f = u - static_cast<float>(i);
+        position = glm::vec2(sampleX[i] + (sampleX[i + 1] - sampleX[i]) * f, sampleZ[i] + (sampleZ[i + 1] - sampleZ[i]) * f);
+        glm::vec2 d(tangentX[i] + (tangentX[i + 1] - tangentX[i]) * f, tangentZ[i] + (tangentZ[i + 1] - tangentZ[i]) * f);
+        direction = d / glm::length(d);
+    }
+
+    // Nearest sample, no lerp: for coarse distance tests
+    glm::vec2 approximatePosition(float distance) const {
+        size_t i = std::min(static_cast<size_t>(distance * (1.0f / SAMPLE_SPACING) + 0.5f), sampleX.size() - 1);
+        return glm::vec2(sampleX[i], sampleZ[i]);
+    }
+
+    float getLength() const { return length; }
+    const std::vector<float>& getStops() const { return stops; }
+    size_t getSampleCount() const { return sampleX.size(); }
+};
+
+// ==================== FleetSimulation Class ====================
+// Buses driving one route in order, stepped at a fixed rate whatever the
+// frame rate. Per bus state is structure-of-arrays. A step is one
+// branch-free pass: doors open for the start of a dwell and close over its
+// end; a moving bus accelerates toward its top speed, limited to a speed it
+// can still brake from before its next stop or the bus ahead
+// (v <= sqrt(2 * BRAKING * room)); the wheels turn by distance travelled.
+// Arriving buses only get their next stop in a scalar pass afterwards.
+// A bus reads the position of the bus ahead from the previous step (the
+// distances are double-buffered), so batches of buses step in parallel as
+// jobs and nobody overtakes. The previous distances also let the renderer
+// interpolate between steps.
+class FleetSimulation {
+public:
+    static constexpr float STEP = 1.0f / 60.0f;          // Seconds
+    static const int MAX_CATCH_UP = 30;                  // Steps per advance(); the rest is dropped
+    static const size_t BATCH_SIZE = 4096;               // Buses per job, a multiple of 8
+
+    static constexpr float ACCELERATION = 1.2f;          // Units per second squared
+    static constexpr float BRAKING = 1.6f;
+    static constexpr float MIN_SPEED = 8.0f;             // Range of top speeds, per bus
+    static constexpr float MAX_SPEED = 14.0f;
+    static constexpr float MIN_GAP = 12.0f;              // Centre to centre, a bus length plus margin
+    static constexpr float DWELL_TIME = 10.0f;           // At a stop, door cycle included
+    static constexpr float DOOR_TIME = 0.8f;             // Closed to open, as BusModel's doors
+    static constexpr float WHEEL_RADIUS = 0.4f;          // BusModel's tyres
+    static constexpr float ARRIVAL_DISTANCE = 0.05f;
+
+private:
+    // Shared by the three step kernels
+    struct Lanes {
+        const float* distance;   // Previous step, with the first bus repeated at [count]
+        float* nextDistance;
+        float* speed;
+        const float* topSpeed;
+        float* stopAt;           // Route distance of the next stop, -1 once arrived
+        float* dwell;            // Seconds left at the stop, 0 = driving
+        float* doors;            // 0 = closed, 1 = open (BusModel's door offset)
+        float* wheel;            // Degrees, as BusModel's wheel rotation
+        float length;
+    };
+
+    FleetRoute route;
+    std::vector<float> distance[2];
+    int current;                 // distance[current] holds the latest step
+    std::vector<float> speed, topSpeed, stopAt, dwell, doors, wheel;
+    std::vector<int> nextStop;
+    mutable std::vector<std::pair<float, size_t>> nearScratch;  // findNear() candidates, kept between frames
+
+    TransformKernel::SimdLevel simdLevel;
+    JobGraph stepJobs;           // One job per batch, built by spawn()
+    double accumulator;
+    unsigned long stepCount;
+    unsigned long droppedSteps;
+    double lastStepMilliseconds;
+    double stepMilliseconds;     // Since the last report
+    unsigned long timedSteps;
+
+    static void stepScalar(const Lanes& l, size_t begin, size_t end) {
+        const float wheelDegrees = 180.0f / (3.14159265f * WHEEL_RADIUS);
+        for (size_t i = begin; i < end; i++) {
+            float s = l.distance[i];
+            float dwellLeft = l.dwell[i];
+            float door = l.doors[i] + (dwellLeft > DOOR_TIME ? STEP / DOOR_TIME : -STEP / DOOR_TIME);
+            door = std::min(std::max(door, 0.0f), 1.0f);
+            dwellLeft = std::max(dwellLeft - STEP, 0.0f);
+            bool moving = dwellLeft == 0.0f && door == 0.0f;
+
+            float toStop = l.stopAt[i] - s;
+            if (toStop < 0.0f) toStop += l.length;
+            float toLeader = l.distance[i + 1] - s;
+            if (toLeader <= 0.0f) toLeader += l.length;
+            float room = std::max(std::min(toStop, toLeader - MIN_GAP), 0.0f);
+
+            float v = std::min(std::min(l.speed[i] + ACCELERATION * STEP, l.topSpeed[i]), std::sqrt(2.0f * BRAKING * room));
+            v = moving ? std::min(v, room * (1.0f / STEP)) : 0.0f;
+            float travelled = v * STEP;
+            float next = s + travelled;
+            if (next >= l.length) next -= l.length;
+            bool arrived = moving && toStop - travelled <= ARRIVAL_DISTANCE;
+
+            float angle = l.wheel[i] + travelled * wheelDegrees;
+            if (angle >= 360.0f) angle -= 360.0f;
+
+            l.nextDistance[i] = next;
+            l.speed[i] = arrived ? 0.0f : v;
+            l.dwell[i] = arrived ? DWELL_TIME : dwellLeft;
+            l.doors[i] = door;
+            l.wheel[i] = angle;
+            if (arrived) l.stopAt[i] = -1.0f;
+        }
+    }
+
+#ifdef BUS_SIMD_X86
+    static __m128 select(__m128 mask, __m128 a, __m128 b) {
+        return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+    }
+
+    static size_t stepSSE2(const Lanes& l, size_t begin, size_t end) {
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 step = _mm_set1_ps(STEP);
+        const __m128 invStep = _mm_set1_ps(1.0f / STEP);
+        const __m128 doorOpen = _mm_set1_ps(STEP / DOOR_TIME);
+        const __m128 doorClose = _mm_set1_ps(-STEP / DOOR_TIME);
+        const __m128 doorTime = _mm_set1_ps(DOOR_TIME);
+        const __m128 length = _mm_set1_ps(l.length);
+        const __m128 minGap = _mm_set1_ps(MIN_GAP);
+        const __m128 speedUp = _mm_set1_ps(ACCELERATION * STEP);
+        const __m128 twoBraking = _mm_set1_ps(2.0f * BRAKING);
+        const __m128 arrival = _mm_set1_ps(ARRIVAL_DISTANCE);
+        const __m128 dwellTime = _mm_set1_ps(DWELL_TIME);
+        const __m128 noStop = _mm_set1_ps(-1.0f);
+        const __m128 wheelDegrees = _mm_set1_ps(180.0f / (3.14159265f * WHEEL_RADIUS));
+        const __m128 turn = _mm_set1_ps(360.0f);
+        size_t i = begin;
+        for (; i + 4 <= end; i += 4) {
+            __m128 s = _mm_loadu_ps(&l.distance[i]);
+            __m128 dwellLeft = _mm_loadu_ps(&l.dwell[i]);
+            __m128 door = _mm_add_ps(_mm_loadu_ps(&l.doors[i]), select(_mm_cmpgt_ps(dwellLeft, doorTime), doorOpen, doorClose));
+            door = _mm_min_ps(_mm_max_ps(door, zero), one);
+            dwellLeft = _mm_max_ps(_mm_sub_ps(dwellLeft, step), zero);
+            __m128 moving = _mm_and_ps(_mm_cmpeq_ps(dwellLeft, zero), _mm_cmpeq_ps(door, zero));
+
+            __m128 stopAt = _mm_loadu_ps(&l.stopAt[i]);
+            __m128 toStop = _mm_sub_ps(stopAt, s);
+            toStop = _mm_add_ps(toStop, _mm_and_ps(_mm_cmplt_ps(toStop, zero), length));
+            __m128 toLeader = _mm_sub_ps(_mm_loadu_ps(&l.distance[i + 1]), s);
+            toLeader = _mm_add_ps(toLeader, _mm_and_ps(_mm_cmple_ps(toLeader, zero), length));
+            __m128 room = _mm_max_ps(_mm_min_ps(toStop, _mm_sub_ps(toLeader, minGap)), zero);
+
+            __m128 v = _mm_min_ps(_mm_add_ps(_mm_loadu_ps(&l.speed[i]), speedUp), _mm_loadu_ps(&l.topSpeed[i]));
+            v = _mm_min_ps(v, _mm_sqrt_ps(_mm_mul_ps(twoBraking, room)));
+            v = _mm_and_ps(_mm_min_ps(v, _mm_mul_ps(room, invStep)), moving);
+            __m128 travelled = _mm_mul_ps(v, step);
+            __m128 next = _mm_add_ps(s, travelled);
+            next = _mm_sub_ps(next, _mm_and_ps(_mm_cmpge_ps(next, length), length));
+            __m128 arrived = _mm_and_ps(moving, _mm_cmple_ps(_mm_sub_ps(toStop, travelled), arrival));
+
+            __m128 angle = _mm_add_ps(_mm_loadu_ps(&l.wheel[i]), _mm_mul_ps(travelled, wheelDegrees));
+            angle = _mm_sub_ps(angle, _mm_and_ps(_mm_cmpge_ps(angle, turn), turn));
+
+            _mm_storeu_ps(&l.nextDistance[i], next);
+            _mm_storeu_ps(&l.speed[i], _mm_andnot_ps(arrived, v));
+            _mm_storeu_ps(&l.dwell[i], select(arrived, dwellTime, dwellLeft));
+            _mm_storeu_ps(&l.doors[i], door);
+            _mm_storeu_ps(&l.wheel[i], angle);
+            _mm_storeu_ps(&l.stopAt[i], select(arrived, noStop, stopAt));
+        }
+        return i;
+    }
+
+    BUS_TARGET_AVX2 static size_t stepAVX2(const Lanes& l, size_t begin, size_t end) {
+        const __m256 zero = _mm256_setzero_ps();
+        const __m256 one = _mm256_set1_ps(1.0f);
+        const __m256 step = _mm256_set1_ps(STEP);
+        const __m256 invStep = _mm256_set1_ps(1.0f / STEP);
+        const __m256 doorOpen = _mm256_set1_ps(STEP / DOOR_TIME);
+        const __m256 doorClose = _mm256_set1_ps(-STEP / DOOR_TIME);
+        const __m256 doorTime = _mm256_set1_ps(DOOR_TIME);
+        const __m256 length = _mm256_set1_ps(l.length);
+        const __m256 minGap = _mm256_set1_ps(MIN_GAP);
+        const __m256 speedUp = _mm256_set1_ps(ACCELERATION * STEP);
+        const __m256 twoBraking = _mm256_set1_ps(2.0f * BRAKING);
+        const __m256 arrival = _mm256_set1_ps(ARRIVAL_DISTANCE);
+        const __m256 dwellTime = _mm256_set1_ps(DWELL_TIME);
+        const __m256 noStop = _mm256_set1_ps(-1.0f);
+        const __m256 wheelDegrees = _mm256_set1_ps(180.0f / (3.14159265f * WHEEL_RADIUS));
+        const __m256 turn = _mm256_set1_ps(360.0f);
+        size_t i = begin;
+        for (; i + 8 <= end; i += 8) {
+            __m256 s = _mm256_loadu_ps(&l.distance[i]);
+            __m256 dwellLeft = _mm256_loadu_ps(&l.dwell[i]);
+            __m256 door = _mm256_add_ps(_mm256_loadu_ps(&l.doors[i]),
+                _mm256_blendv_ps(doorClose, doorOpen, _mm256_cmp_ps(dwellLeft, doorTime, _CMP_GT_OQ)));
+            door = _mm256_min_ps(_mm256_max_ps(door, zero), one);
+            dwellLeft = _mm256_max_ps(_mm256_sub_ps(dwellLeft, step), zero);
+            __m256 moving = _mm256_and_ps(_mm256_cmp_ps(dwellLeft, zero, _CMP_EQ_OQ), _mm256_cmp_ps(door, zero, _CMP_EQ_OQ));
+
+            __m256 stopAt = _mm256_loadu_ps(&l.stopAt[i]);
+            __m256 toStop = _mm256_sub_ps(stopAt, s);
+            toStop = _mm256_add_ps(toStop, _mm256_and_ps(_mm256_cmp_ps(toStop, zero, _CMP_LT_OQ), length));
+            __m256 toLeader = _mm256_sub_ps(_mm256_loadu_ps(&l.distance[i + 1]), s);
+            toLeader = _mm256_add_ps(toLeader, _mm256_and_ps(_mm256_cmp_ps(toLeader, zero, _CMP_LE_OQ), length));
+            __m256 room = _mm256_max_ps(_mm256_min_ps(toStop, _mm256_sub_ps(toLeader, minGap)), zero);
+
+            __m256 v = _mm256_min_ps(_mm256_add_ps(_mm256_loadu_ps(&l.speed[i]), speedUp), _mm256_loadu_ps(&l.topSpeed[i]));
+            v = _mm256_min_ps(v, _mm256_sqrt_ps(_mm256_mul_ps(twoBraking, room)));
+            v = _mm256_and_ps(_mm256_min_ps(v, _mm256_mul_ps(room, invStep)), moving);
+            __m256 travelled = _mm256_mul_ps(v, step);
+            __m256 next = _mm256_add_ps(s, travelled);
+            next = _mm256_sub_ps(next, _mm256_and_ps(_mm256_cmp_ps(next, length, _CMP_GE_OQ), length));
+            __m256 arrived = _mm256_and_ps(moving, _mm256_cmp_ps(_mm256_sub_ps(toStop, travelled), arrival, _CMP_LE_OQ));
+
+            __m256 angle = _mm256_add_ps(_mm256_loadu_ps(&l.wheel[i]), _mm256_mul_ps(travelled, wheelDegrees));
+            angle = _mm256_sub_ps(angle, _mm256_and_ps(_mm256_cmp_ps(angle, turn, _CMP_GE_OQ), turn));
+
+            _mm256_storeu_ps(&l.nextDistance[i], next);
+            _mm256_storeu_ps(&l.speed[i], _mm256_andnot_ps(arrived, v));
+            _mm256_storeu_ps(&l.dwell[i], _mm256_blendv_ps(dwellLeft, dwellTime, arrived));
+            _mm256_storeu_ps(&l.doors[i], door);
+            _mm256_storeu_ps(&l.wheel[i], angle);
+            _mm256_storeu_ps(&l.stopAt[i], _mm256_blendv_ps(stopAt, noStop, arrived));
+        }
+        _mm256_zeroupper();
+        return i;
+    }
+#endif
+
+    Lanes lanes() {
+        Lanes l;
+        l.distance = distance[current].data();
+        l.nextDistance = distance[current ^ 1].data();
+        l.speed = speed.data();
+        l.topSpeed = topSpeed.data();
+        l.stopAt = stopAt.data();
+        l.dwell = dwell.data();
+        l.doors = doors.data();
+        l.wheel = wheel.data();
+        l.length = route.getLength();
+        return l;
+    }
+
+    // Batches only write their own buses, so they can run side by side
+    void stepBatch(size_t begin, size_t end) {
+        Lanes l = lanes();
+        size_t done = begin;
+#ifdef BUS_SIMD_X86
+        if (simdLevel == TransformKernel::SIMD_AVX2) done = stepAVX2(l, begin, end);
+        else if (simdLevel == TransformKernel::SIMD_SSE2) done = stepSSE2(l, begin, end);
+#endif
+        stepScalar(l, done, end);
+
+        // Arrived buses head for the stop after
+        const std::vector<float>& stops = route.getStops();
+        int stopCount = static_cast<int>(stops.size());
+        for (size_t i = begin; i < end; i++) {
+            if (stopAt[i] >= 0.0f) continue;
+            if (++nextStop[i] == stopCount) nextStop[i] = 0;
+            stopAt[i] = stops[nextStop[i]];
+        }
+    }
+
+    template <typename RunBatches>
+    void runStep(RunBatches runBatches) {
+        if (size() == 0) return;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        distance[current][size()] = distance[current][0];   // The first bus leads the last
+        runBatches();
+        current ^= 1;
+        stepCount++;
+        lastStepMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        stepMilliseconds += lastStepMilliseconds;
+        timedSteps++;
+    }
+
+public:
+    FleetSimulation() : current(0), simdLevel(TransformKernel::activeSimdLevel()), accumulator(0.0),
+        stepCount(0), droppedSteps(0), lastStepMilliseconds(0.0), stepMilliseconds(0.0), timedSteps(0) {
+    }
+
+    FleetSimulation(const FleetSimulation&) = delete;
+    FleetSimulation& operator=(const FleetSimulation&) = delete;
+
+    // Build the route and add at least two stops before spawn()
+    FleetRoute& getRoute() { return route; }
+    const FleetRoute& getRoute() const { return route; }
+
+    // 'count' buses spread evenly along the route in driving order, each
+    // with a top speed of its own. Replaces any previous fleet.
+    bool spawn(size_t count, uint32_t seed = 1) {
+        // A bus leaving its only stop would arrive straight back at it
+        if (route.getStops().size() < 2) {
+            std::cerr << "ERROR::FLEET::TOO_FEW_STOPS\n" << route.getStops().size() << " stops, at least 2 needed" << std::endl;
+            return false;
+        }
+        // Closer than MIN_GAP all round, nobody could ever move
+        size_t slots = static_cast<size_t>(route.getLength() / MIN_GAP);
+        size_t capacity = slots > 0 ? slots - 1 : 0;
+        if (count > capacity) {
+            std::cerr << "ERROR::FLEET::ROUTE_FULL\n" << count << " buses, room for " << capacity << std::endl;
+            count = capacity;
+        }
+
+        // One extra slot: the last bus's leader, a copy of the first
+        for (auto& d : distance) d.assign(count + 1, 0.0f);
+        speed.assign(count, 0.0f);
+        topSpeed.resize(count);
+        stopAt.resize(count);
+        dwell.assign(count, 0.0f);
+        doors.assign(count, 0.0f);
+        wheel.assign(count, 0.0f);
+        nextStop.resize(count);
+
+        const std::vector<float>& stops = route.getStops();
+        float spacing = route.getLength() / static_cast<float>(std::max<size_t>(count, 1));
+        for (size_t i = 0; i < count; i++) {
+            seed = seed * 1664525u + 1013904223u;
+            float random01 = static_cast<float>(seed >> 8) / static_cast<float>(1u << 24);
+            float s = spacing * static_cast<float>(i);
+            distance[0][i] = distance[1][i] = s;
+            topSpeed[i] = MIN_SPEED + (MAX_SPEED - MIN_SPEED) * random01;
+            size_t stop = std::upper_bound(stops.begin(), stops.end(), s) - stops.begin();
+            nextStop[i] = static_cast<int>(stop == stops.size() ? 0 : stop);
+            stopAt[i] = stops[nextStop[i]];
+        }
+        current = 0;
+        accumulator = 0.0;
+
+        stepJobs.reset();
+        for (size_t begin = 0; begin < count; begin += BATCH_SIZE) {
+            size_t end = std::min(begin + BATCH_SIZE, count);
+            stepJobs.add("fleet.step", [this, begin, end] { stepBatch(begin, end); });
+        }
+        return true;
+    }
+
+    // Benchmarks compare the kernels; otherwise the widest available is used
+    void setSimdLevel(TransformKernel::SimdLevel level) { simdLevel = level; }
+
+    // One step on the calling thread
+    void step() {
+        runStep([this] {
+            for (size_t begin = 0; begin < size(); begin += BATCH_SIZE) stepBatch(begin, std::min(begin + BATCH_SIZE, size()));
+            });
+    }
+
+    // One step, the batches spread over the job system's workers
+    void step(JobSystem& jobs) {
+        runStep([this, &jobs] {
+            jobs.run(stepJobs);
+            jobs.waitAll(stepJobs);
+            });
+    }
+
+    // Runs the whole steps that fit in the time passed; the remainder waits
+    // for the next call. Returns the steps run.
+    int advance(double seconds, JobSystem& jobs) {
+        accumulator += seconds;
+        int steps = 0;
+        while (accumulator >= STEP && steps < MAX_CATCH_UP) {
+            step(jobs);
+            accumulator -= STEP;
+            steps++;
+        }
+        // After a stall, fall behind rather than spend the next frames catching up
+        if (accumulator >= STEP) {
+            droppedSteps += static_cast<unsigned long>(accumulator / STEP);
+            accumulator = std::fmod(accumulator, static_cast<double>(STEP));
+        }
+        return steps;
+    }
+
+    // Fraction of a step since the last one, for interpolated poses
+    float getBlend() const { return static_cast<float>(accumulator / STEP); }
+
+    // Route distance between the last two steps
+    float getDistance(size_t bus, float blend) const {
+        float from = distance[current ^ 1][bus];
+        float travelled = distance[current][bus] - from;
+        if (travelled < 0.0f) travelled += route.getLength();
+        float s = from + travelled * blend;
+        return s >= route.getLength() ? s - route.getLength() : s;
+    }
+
+    float getDoorOffset(size_t bus) const { return doors[bus]; }
+    float getWheelRotation(size_t bus) const { return wheel[bus]; }
+    float getSpeed(size_t bus) const { return speed[bus]; }
+
+    // Buses within 'radius' of a ground point, nearest first, at most 'maxCount'
+    void findNear(const glm::vec2& center, float radius, size_t maxCount, std::vector<size_t>& out) const {
+        std::vector<std::pair<float, size_t>>& found = nearScratch;
+        found.clear();
+        const std::vector<float>& latest = distance[current];
+        float radiusSquared = radius * radius;
+        for (size_t i = 0; i < size(); i++) {
+            glm::vec2 d = route.approximatePosition(latest[i]) - center;
+            float distanceSquared = glm::dot(d, d);
+            if (distanceSquared < radiusSquared) found.push_back(std::make_pair(distanceSquared, i));
+        }
+        size_t kept = std::min(found.size(), maxCount);
+        std::partial_sort(found.begin(), found.begin() + kept, found.end());
+        out.clear();
+        for (size_t i = 0; i < kept; i++) out.push_back(found[i].second);
+    }
+
+    size_t size() const { return speed.size(); }
+    unsigned long getStepCount() const { return stepCount; }
+    double getLastStepMilliseconds() const { return lastStepMilliseconds; }
+
+    double getAverageStepMilliseconds() const {
+        return timedSteps > 0 ? stepMilliseconds / timedSteps : 0.0;
+    }
+
+    void printInfo() {
+        size_t dwelling = 0, moving = 0;
+        for (size_t i = 0; i < size(); i++) {
+            if (dwell[i] > 0.0f) dwelling++;
+            else if (speed[i] > 0.0f) moving++;
+        }
+        double milliseconds = getAverageStepMilliseconds();
+        std::cout << "Fleet: " << size() << " buses on a " << route.getLength() / 1000.0f << " km route with "
+            << route.getStops().size() << " stops, " << moving << " moving, " << dwelling << " at stops, "
+            << size() - moving - dwelling << " waiting" << std::endl;
+        std::cout << "  " << stepCount << " steps at " << 1.0f / STEP << " Hz (" << TransformKernel::simdLevelName(simdLevel)
+            << ", " << stepJobs.size() << " jobs), " << milliseconds << " ms per step";
+        if (milliseconds > 0.0) std::cout << " (" << static_cast<size_t>(size() / milliseconds) << " buses/ms)";
+        std::cout << ", " << droppedSteps << " dropped" << std::endl;
+        stepMilliseconds = 0.0;
+        timedSteps = 0;
+    }
+};
+
+#endif
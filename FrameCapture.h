@@ -0,0 +1,483 @@
+#ifndef FRAMECAPTURE_H
+#define FRAMECAPTURE_H
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// ==================== FrameCapture Class ====================
+// Records the backbuffer to disk without stalling the render thread.
+//   capture() - once per frame, after drawing and before the swap: maps and
+//               copies out every ring slot whose fence has signalled (oldest
+//               first), then glReadPixels into the next pixel buffer object
+//               with a fence behind it. The readback is a GPU copy queued
+//               behind the frame; nothing waits on it. With every slot still
+//               in flight the frame is dropped, never waited for.
+//   encoding  - one ThreadPool task per frame (RGBA -> I420 for Y4M, a whole
+//               PNG file otherwise), so frames encode in parallel
+//   writer    - one thread takes frames in order, waits for their encode and
+//               writes them. A full queue drops frames instead of blocking.
+// Y4M is raw video in one file (ffmpeg and most players read it); PNG is one
+// file per frame, stored without compression (no zlib in the tree).
+// Dropped frames are counted and printed: PNG numbers show the gaps.
+// Lossless mode (headless runs, where frame time is not real time) waits
+// instead of dropping.
+class FrameCapture {
+public:
+    enum Format { FORMAT_Y4M, FORMAT_PNG };
+
+    static const int RING_SIZE = 3;              // Frames the readback may trail the render
+    static const size_t MAX_QUEUED_FRAMES = 8;   // Frames waiting for encode + write
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    struct Slot {
+        unsigned int buffer;
+        GLsync fence;
+        long long frame;
+    };
+
+    struct Frame {
+        long long number;
+        int width, height;
+        std::vector<unsigned char> pixels;     // RGBA, bottom row first (GL order)
+        std::vector<unsigned char> encoded;
+        std::vector<unsigned char> scratch;
+        std::future<void> done;
+    };
+
+    ThreadPool& pool;
+    Slot slots[RING_SIZE];
+    int nextSlot;
+    int slotsInFlight;
+    int bufferWidth, bufferHeight;     // Size the slots were allocated for
+
+    Format format;
+    bool recording;
+    bool lossless;
+    int width, height, framesPerSecond;
+    std::string outputName;
+    std::ofstream video;
+    long long frameNumber;
+
+    // Shared with the writer thread
+    std::thread writer;
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::condition_variable queueSpace;
+    std::deque<std::unique_ptr<Frame>> queue;
+    std::vector<std::unique_ptr<Frame>> spareFrames;
+    bool finishing;
+    long long framesWritten;
+    bool writeFailed;
+
+    long long droppedGpuBusy;
+    long long droppedQueueFull;
+    double captureMilliseconds;        // Render thread time spent in capture()
+    long long captureCalls;
+
+    static uint32_t crc32(const unsigned char* data, size_t length, uint32_t crc = 0) {
+        static const std::vector<uint32_t> table = [] {
+            std::vector<uint32_t> t(256);
+            for (uint32_t n = 0; n < 256; n++) {
+                uint32_t c = n;
+                for (int k = 0; k < 8; k++) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                t[n] = c;
+            }
+            return t;
+        }();
+        crc = ~crc;
+        for (size_t i = 0; i < length; i++) crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+        return ~crc;
+    }
+
+    static void putBigEndian(std::vector<unsigned char>& out, uint32_t value) {
+        out.push_back(static_cast<unsigned char>(value >> 24));
+        out.push_back(static_cast<unsigned char>(value >> 16));
+        out.push_back(static_cast<unsigned char>(value >> 8));
+        out.push_back(static_cast<unsigned char>(value));
+    }
+
+    static void putChunk(std::vector<unsigned char>& out, const char* type, const unsigned char* data, size_t length) {
+        putBigEndian(out, static_cast<uint32_t>(length));
+        size_t start = out.size();
+        out.insert(out.end(), type, type + 4);
+        out.insert(out.end(), data, data + length);
+        putBigEndian(out, crc32(&out[start], length + 4));
+    }
+
+    // Full-range BT.601 (what C420jpeg means), chroma from each 2x2 block's
+    // average. Odd sizes lose their last row/column; rows are flipped.
+    static void encodeY4M(Frame& frame) {
+        int w = frame.width & ~1, h = frame.height & ~1;
+        size_t stride = static_cast<size_t>(frame.width) * 4;
+        frame.encoded.resize(static_cast<size_t>(w) * h * 3 / 2);
+        unsigned char* yPlane = frame.encoded.data();
+        unsigned char* uPlane = yPlane + static_cast<size_t>(w) * h;
+        unsigned char* vPlane = uPlane + static_cast<size_t>(w / 2) * (h / 2);
+
+        for (int y = 0; y < h; y += 2) {
+            const unsigned char* rows[2] = {
+                &frame.pixels[(frame.height - 1 - y) * stride],
+                &frame.pixels[(frame.height - 2 - y) * stride] };
+            for (int x = 0; x < w; x += 2) {
+                int r = 0, g = 0, b = 0;
+                for (int dy = 0; dy < 2; dy++) {
+                    for (int dx = 0; dx < 2; dx++) {
+                        const unsigned char* p = rows[dy] + (x + dx) * 4;
+                        yPlane[static_cast<size_t>(y + dy) * w + x + dx] =
+                            static_cast<unsigned char>((77 * p[0] + 150 * p[1] + 29 * p[2] + 128) >> 8);
+                        r += p[0];
+                        g += p[1];
+                        b += p[2];
+                    }
+                }
+                // Sums of four pixels: >> 10 is the average's >> 8, the offset keeps it non-negative
+                size_t c = static_cast<size_t>(y / 2) * (w / 2) + x / 2;
+                uPlane[c] = static_cast<unsigned char>(std::min((-43 * r - 85 * g + 128 * b + 131072 + 512) >> 10, 255));
+                vPlane[c] = static_cast<unsigned char>(std::min((128 * r - 107 * g - 21 * b + 131072 + 512) >> 10, 255));
+            }
+        }
+    }
+
+    // 8-bit RGB, filter 0 on every row, zlib stream of stored deflate blocks
+    static void encodePNG(Frame& frame) {
+        size_t stride = static_cast<size_t>(frame.width) * 4;
+        size_t rowBytes = static_cast<size_t>(frame.width) * 3 + 1;
+        std::vector<unsigned char>& raw = frame.scratch;
+        raw.resize(rowBytes * frame.height);
+        for (int y = 0; y < frame.height; y++) {
+            const unsigned char* src = &frame.pixels[(frame.height - 1 - y) * stride];
+            unsigned char* dst = &raw[y * rowBytes];
+            *dst++ = 0;
+            for (int x = 0; x < frame.width; x++, src += 4) {
+                *dst++ = src[0];
+                *dst++ = src[1];
+                *dst++ = src[2];
+            }
+        }
+
+        std::vector<unsigned char> idat;
+        idat.reserve(raw.size() + raw.size() / 65535 * 5 + 16);
+        idat.push_back(0x78);
+        idat.push_back(0x01);
+        uint32_t adlerA = 1, adlerB = 0;
+        for (size_t offset = 0; ; ) {
+            size_t length = std::min<size_t>(raw.size() - offset, 65535);
+            bool last = offset + length == raw.size();
+            idat.push_back(last ? 1 : 0);
+            idat.push_back(static_cast<unsigned char>(length));
+            idat.push_back(static_cast<unsigned char>(length >> 8));
+            idat.push_back(static_cast<unsigned char>(~length));
+            idat.push_back(static_cast<unsigned char>(~length >> 8));
+            idat.insert(idat.end(), raw.begin() + offset, raw.begin() + offset + length);
+            for (size_t i = offset; i < offset + length; i++) {
+                adlerA = (adlerA + raw[i]) % 65521;
+                adlerB = (adlerB + adlerA) % 65521;
+            }
+            if (last) break;
+            offset += length;
+        }
+        putBigEndian(idat, (adlerB << 16) | adlerA);
+
+        std::vector<unsigned char> header;
+        putBigEndian(header, static_cast<uint32_t>(frame.width));
+        putBigEndian(header, static_cast<uint32_t>(frame.height));
+        const unsigned char rest[] = { 8, 2, 0, 0, 0 };     // Depth, RGB, deflate, filter set 0, no interlace
+        header.insert(header.end(), rest, rest + 5);
+
+        static const unsigned char signature[] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+        std::vector<unsigned char>& out = frame.encoded;
+        out.assign(signature, signature + 8);
+        putChunk(out, "IHDR", header.data(), header.size());
+        putChunk(out, "IDAT", idat.data(), idat.size());
+        putChunk(out, "IEND", nullptr, 0);
+    }
+
+    std::string pngName(long long number) const {
+        char suffix[32];
+        std::snprintf(suffix, sizeof(suffix), "_%05lld.png", number);
+        return outputName + suffix;
+    }
+
+    void writerLoop() {
+        while (true) {
+            std::unique_ptr<Frame> frame;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                condition.wait(lock, [this] { return finishing || !queue.empty(); });
+                if (queue.empty()) return;
+                frame = std::move(queue.front());
+                queue.pop_front();
+            }
+            queueSpace.notify_one();
+
+            bool ok = true;
+            try {
+                frame->done.get();
+            }
+            catch (const std::exception& e) {
+                std::cerr << "ERROR::FRAMECAPTURE::ENCODE_FAILED\n" << e.what() << std::endl;
+                ok = false;
+            }
+            if (ok && format == FORMAT_Y4M) {
+                video << "FRAME\n";
+                video.write(reinterpret_cast<const char*>(frame->encoded.data()), frame->encoded.size());
+                ok = video.good();
+            }
+            else if (ok) {
+                std::ofstream file(pngName(frame->number), std::ios::binary);
+                file.write(reinterpret_cast<const char*>(frame->encoded.data()), frame->encoded.size());
+                ok = file.good();
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if (ok) framesWritten++;
+            else if (!writeFailed) {
+                std::cerr << "ERROR::FRAMECAPTURE::WRITE_FAILED\n" << outputName << std::endl;
+                writeFailed = true;
+            }
+            spareFrames.push_back(std::move(frame));
+        }
+    }
+
+    // Hands a signalled slot to the encoder; the copy is the only CPU work
+    // on the render thread
+    void harvestSlot(Slot& slot) {
+        glDeleteSync(slot.fence);
+        slot.fence = nullptr;
+
+        std::unique_ptr<Frame> frame;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            if (lossless) queueSpace.wait(lock, [this] { return queue.size() < MAX_QUEUED_FRAMES; });
+            if (queue.size() >= MAX_QUEUED_FRAMES) {
+                droppedQueueFull++;
+                return;
+            }
+            if (!spareFrames.empty()) {
+                frame = std::move(spareFrames.back());
+                spareFrames.pop_back();
+            }
+        }
+        if (!frame) frame.reset(new Frame());
+
+        size_t size = static_cast<size_t>(width) * height * 4;
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+        const void* data = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, size, GL_MAP_READ_BIT);
+        if (data) {
+            frame->pixels.resize(size);
+            std::memcpy(frame->pixels.data(), data, size);
+            glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        if (!data) {
+            droppedGpuBusy++;
+            return;
+        }
+
+        frame->number = slot.frame;
+        frame->width = width;
+        frame->height = height;
+        Frame* job = frame.get();
+        if (format == FORMAT_Y4M) frame->done = pool.submit([job] { encodeY4M(*job); });
+        else frame->done = pool.submit([job] { encodePNG(*job); });
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            queue.push_back(std::move(frame));
+        }
+        condition.notify_one();
+    }
+
+    // Oldest slots first, so frames reach the writer in order. Without
+    // 'wait' stops at the first slot the GPU has not finished.
+    void harvest(bool wait) {
+        while (slotsInFlight > 0) {
+            Slot& slot = slots[(nextSlot - slotsInFlight + RING_SIZE) % RING_SIZE];
+            GLenum status = glClientWaitSync(slot.fence, wait ? GL_SYNC_FLUSH_COMMANDS_BIT : 0,
+                wait ? 1000000000ull : 0);
+            if (status == GL_TIMEOUT_EXPIRED && !wait) break;
+            if (status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED) harvestSlot(slot);
+            else {
+                glDeleteSync(slot.fence);
+                slot.fence = nullptr;
+                droppedGpuBusy++;
+            }
+            slotsInFlight--;
+        }
+    }
+
+    void allocateSlots(int w, int h) {
+        if (w == bufferWidth && h == bufferHeight) return;
+        for (Slot& slot : slots) {
+            if (!slot.buffer) glGenBuffers(1, &slot.buffer);
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+            glBufferData(GL_PIXEL_PACK_BUFFER, static_cast<GLsizeiptr>(w) * h * 4, nullptr, GL_STREAM_READ);
+        }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        bufferWidth = w;
+        bufferHeight = h;
+    }
+
+    void finishWriter() {
+        if (!writer.joinable()) return;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            finishing = true;
+        }
+        condition.notify_all();
+        writer.join();
+    }
+
+public:
+    explicit FrameCapture(ThreadPool& threadPool)
+        : pool(threadPool), nextSlot(0), slotsInFlight(0), bufferWidth(0), bufferHeight(0),
+        format(FORMAT_Y4M), recording(false), lossless(false), width(0), height(0), framesPerSecond(60), frameNumber(0),
+        finishing(false), framesWritten(0), writeFailed(false),
+        droppedGpuBusy(0), droppedQueueFull(0), captureMilliseconds(0.0), captureCalls(0) {
+        for (Slot& slot : slots) {
+            slot.buffer = 0;
+            slot.fence = nullptr;
+            slot.frame = 0;
+        }
+    }
+
+    ~FrameCapture() { finishWriter(); }
+
+    FrameCapture(const FrameCapture&) = delete;
+    FrameCapture& operator=(const FrameCapture&) = delete;
+
+    // Needs the current GL context. Output goes to the first free
+    // capture_N.y4m / capture_N_00000.png in the working directory.
+    bool start(Format captureFormat, int fbWidth, int fbHeight, int fps) {
+        if (recording) return true;
+        if (fbWidth < 2 || fbHeight < 2) {
+            std::cerr << "ERROR::FRAMECAPTURE::EMPTY_FRAMEBUFFER" << std::endl;
+            return false;
+        }
+
+        format = captureFormat;
+        width = fbWidth;
+        height = fbHeight;
+        framesPerSecond = std::max(fps, 1);
+        for (int n = 1; ; n++) {
+            outputName = "capture_" + std::to_string(n);
+            if (!std::ifstream(format == FORMAT_Y4M ? outputName + ".y4m" : pngName(0))) break;
+        }
+
+        if (format == FORMAT_Y4M) {
+            video.open(outputName + ".y4m", std::ios::binary);
+            if (!video) {
+                std::cerr << "ERROR::FRAMECAPTURE::OPEN_FAILED\n" << outputName << ".y4m" << std::endl;
+                return false;
+            }
+            video << "YUV4MPEG2 W" << (width & ~1) << " H" << (height & ~1) << " F" << framesPerSecond
+                << ":1 Ip A1:1 C420jpeg\n";
+        }
+
+        allocateSlots(width, height);
+        nextSlot = slotsInFlight = 0;
+        frameNumber = framesWritten = droppedGpuBusy = droppedQueueFull = captureCalls = 0;
+        captureMilliseconds = 0.0;
+        finishing = writeFailed = false;
+        writer = std::thread(&FrameCapture::writerLoop, this);
+        recording = true;
+
+        std::cout << "Recording " << width << "x" << height << " @ " << framesPerSecond << " fps to "
+            << (format == FORMAT_Y4M ? outputName + ".y4m" : outputName + "_*.png") << std::endl;
+        return true;
+    }
+
+    // After the frame is drawn, before the swap; reads the default framebuffer's back buffer
+    void capture(int fbWidth, int fbHeight) {
+        if (!recording) return;
+        if (fbWidth != width || fbHeight != height) {
+            std::cout << "Framebuffer resized, capture stopped" << std::endl;
+            stop();
+            return;
+        }
+        Clock::time_point begin = Clock::now();
+
+        harvest(false);
+        if (slotsInFlight == RING_SIZE && lossless) harvest(true);
+        if (slotsInFlight == RING_SIZE) droppedGpuBusy++;
+        else {
+            Slot& slot = slots[nextSlot];
+            glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+            glReadBuffer(GL_BACK);
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+            glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+            slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            slot.frame = frameNumber;
+            nextSlot = (nextSlot + 1) % RING_SIZE;
+            slotsInFlight++;
+        }
+        frameNumber++;
+
+        captureMilliseconds += std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+        captureCalls++;
+    }
+
+    // Waits for the frames still in flight and the writer, so the output is complete
+    void stop() {
+        if (!recording) return;
+        harvest(true);
+        finishWriter();
+        if (video.is_open()) video.close();
+        recording = false;
+        std::cout << "Capture stopped (" << outputName << ")" << std::endl;
+        printInfo();
+    }
+
+    bool isRecording() const { return recording; }
+
+    // Wait for the GPU and the encoder rather than drop frames
+    void setLossless(bool enabled) { lossless = enabled; }
+
+    void printInfo() {
+        long long written;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            written = framesWritten;
+        }
+        std::cout << "Frame capture: " << frameNumber << " frames, " << written << " written";
+        if (droppedGpuBusy + droppedQueueFull > 0) {
+            std::cout << ", dropped " << droppedGpuBusy << " (readback behind) + "
+                << droppedQueueFull << " (encoder behind)";
+        }
+        if (captureCalls > 0) {
+            std::cout << ", " << captureMilliseconds / captureCalls << " ms/frame on the render thread";
+        }
+        std::cout << std::endl;
+    }
+
+    void cleanup() {
+        stop();
+        for (Slot& slot : slots) {
+            if (slot.fence) glDeleteSync(slot.fence);
+            if (slot.buffer) glDeleteBuffers(1, &slot.buffer);
+            slot.fence = nullptr;
+            slot.buffer = 0;
+        }
+        bufferWidth = bufferHeight = 0;
+    }
+};
+
+#endif
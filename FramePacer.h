@@ -0,0 +1,161 @@
+#ifndef FRAMEPACER_H
+#define FRAMEPACER_H
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+// ==================== FramePacer Class ====================
+// Swap interval, frame limiter and low-latency mode for the main loop, plus
+// per-stage timing. Loop shape:
+//   beginFrame()  - limiter sleep, then (low latency) wait on last frame's fence
+//   poll events + sample input as late as possible, update, render
+//   swap, endFrame() - fence after the swap
+// With the fence the CPU never starts a frame while the GPU is still
+// working on the previous one, so at most one frame is queued and input
+// reaches the screen one frame sooner than with a deep driver queue.
+class FramePacer {
+public:
+    enum Stage { STAGE_WAIT, STAGE_INPUT, STAGE_UPDATE, STAGE_RENDER, STAGE_SWAP, STAGE_COUNT };
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    bool vsync;
+    int frameLimit;              // Frames per second, 0 = unlimited
+    bool lowLatency;
+    GLsync frameFence;
+
+    Clock::time_point nextFrameTime;
+    Clock::time_point stageStart;
+    double frameStages[STAGE_COUNT];   // This frame's milliseconds so far
+    double stageTotals[STAGE_COUNT];   // Milliseconds since the last report
+    int framesMeasured;
+
+    static const char* stageName(int stage) {
+        static const char* names[STAGE_COUNT] = { "wait", "input", "update", "render", "swap" };
+        return names[stage];
+    }
+
+    // Sleep is coarse (up to a scheduler tick), so sleep to just short of
+    // the target and spin the rest
+    static void waitUntil(Clock::time_point target) {
+        const auto spinMargin = std::chrono::microseconds(2000);
+        auto now = Clock::now();
+        if (target - now > spinMargin) std::this_thread::sleep_for(target - now - spinMargin);
+        while (Clock::now() < target) std::this_thread::yield();
+    }
+
+public:
+    FramePacer() : vsync(true), frameLimit(0), lowLatency(false), frameFence(nullptr), framesMeasured(0) {
+        for (double& stage : frameStages) stage = 0.0;
+        for (double& total : stageTotals) total = 0.0;
+        nextFrameTime = stageStart = Clock::now();
+    }
+
+    // Needs the current GL context
+    void setVsync(bool enabled) {
+        vsync = enabled;
+        glfwSwapInterval(vsync ? 1 : 0);
+    }
+
+    void setFrameLimit(int framesPerSecond) {
+        frameLimit = framesPerSecond > 0 ? framesPerSecond : 0;
+        nextFrameTime = Clock::now();
+    }
+
+    void setLowLatency(bool enabled) {
+        lowLatency = enabled;
+        if (!lowLatency && frameFence) {
+            glDeleteSync(frameFence);
+            frameFence = nullptr;
+        }
+    }
+
+    bool isVsync() const { return vsync; }
+    int getFrameLimit() const { return frameLimit; }
+    bool isLowLatency() const { return lowLatency; }
+
+    void beginFrame() {
+        stageStart = Clock::now();
+
+        if (frameLimit > 0) {
+            // Fixed cadence; after a long hitch restart it instead of bursting to catch up
+            auto period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / frameLimit));
+            nextFrameTime += period;
+            if (nextFrameTime < stageStart) nextFrameTime = stageStart;
+            waitUntil(nextFrameTime);
+        }
+
+        if (lowLatency && frameFence) {
+            // 100 ms cap so a lost context cannot hang the loop
+            glClientWaitSync(frameFence, GL_SYNC_FLUSH_COMMANDS_BIT, 100000000ull);
+            glDeleteSync(frameFence);
+            frameFence = nullptr;
+        }
+
+        mark(STAGE_WAIT);
+    }
+
+    // Ends the running stage: time since the previous mark is charged to it
+    void mark(Stage stage) {
+        auto now = Clock::now();
+        frameStages[stage] += std::chrono::duration<double, std::milli>(now - stageStart).count();
+        stageStart = now;
+    }
+
+    // Call right after glfwSwapBuffers
+    void endFrame() {
+        mark(STAGE_SWAP);
+        if (lowLatency) {
+            if (frameFence) glDeleteSync(frameFence);
+            frameFence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        }
+        for (int i = 0; i < STAGE_COUNT; i++) {
+            stageTotals[i] += frameStages[i];
+            frameStages[i] = 0.0;
+        }
+        framesMeasured++;
+    }
+
+    // Instead of endFrame() when the loop decided not to render: the
+    // iteration's stage times are dropped so idle wakeups do not skew the
+    // averages
+    void skipFrame() {
+        for (double& stage : frameStages) stage = 0.0;
+    }
+
+    // Averages since the last report; input-to-swap is the latency the
+    // sampled input sees before its frame is handed to the display
+    void printInfo() {
+        if (framesMeasured == 0) return;
+
+        std::cout << "Frame pacing: vsync " << (vsync ? "ON" : "OFF") << ", limit ";
+        if (frameLimit > 0) std::cout << frameLimit << " fps"; else std::cout << "OFF";
+        std::cout << ", low latency " << (lowLatency ? "ON" : "OFF") << std::endl;
+
+        double frame = 0.0;
+        std::cout << "  Stages (avg over " << framesMeasured << " frames):";
+        for (int i = 0; i < STAGE_COUNT; i++) {
+            double ms = stageTotals[i] / framesMeasured;
+            frame += ms;
+            std::cout << " " << stageName(i) << " " << ms << " ms";
+        }
+        std::cout << std::endl;
+        std::cout << "  Frame " << frame << " ms, input-to-swap "
+            << frame - stageTotals[STAGE_WAIT] / framesMeasured << " ms" << std::endl;
+
+        for (double& total : stageTotals) total = 0.0;
+        framesMeasured = 0;
+    }
+
+    void cleanup() {
+        if (frameFence) glDeleteSync(frameFence);
+        frameFence = nullptr;
+    }
+};
+
+#endif
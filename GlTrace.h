@@ -0,0 +1,617 @@
+#ifndef GLTRACE_H
+#define GLTRACE_H
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <algorithm>
+#include <iostream>
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Tracing is compiled in only for debug builds that define BUS_GL_TRACE;
+// everywhere else GlTrace is the empty class at the end of this file
+#if defined(BUS_GL_TRACE) && !defined(NDEBUG)
+#define BUS_GL_TRACING 1
+#endif
+
+// Totals of one frame's traced GL calls
+struct GlFrameStats {
+    unsigned int calls;
+    unsigned int redundant;      // Binds and state changes that changed nothing
+    unsigned int syncPoints;     // Calls that can make the CPU wait for the GPU
+    unsigned int debugMessages;  // KHR_debug messages raised
+
+    GlFrameStats() : calls(0), redundant(0), syncPoints(0), debugMessages(0) {}
+};
+
+#ifdef BUS_GL_TRACING
+
+// ==================== GlTrace Class ====================
+// Debug layer between the program and the driver. Every gl* call goes through
+// one of GLAD's glad_gl* function pointers; install() points them at wrappers
+// that count the call for its entry point, check it, then call the driver.
+// Binds and state changes are checked against a shadow copy of the state
+// (from the context's defaults on) and flagged redundant when they change
+// nothing; vertex array and program binds are also redundant when replaced
+// before anything used them (the unbind after a draw). glGet*, readbacks into
+// client memory, blocking query reads, waits and synchronized maps are
+// flagged as sync points. KHR_debug messages are counted, and each distinct
+// one is printed once with the entry point that raised it.
+// GL is only called from the context's thread, so nothing here is locked.
+class GlTrace {
+public:
+    static constexpr bool ENABLED = true;
+
+    enum Verdict { CALL, REDUNDANT, SYNC_POINT };
+
+    static const GLuint UNKNOWN = 0xFFFFFFFFu;
+
+    // What the traced calls have bound; a missing binding is still 0
+    struct ShadowState {
+        GLuint vertexArray;
+        bool vertexArrayUsed;    // By a draw or a vertex format call since it was bound
+        GLuint program;
+        bool programUsed;        // By a draw or a uniform write
+        GLenum activeTexture;
+        GLuint drawFramebuffer;
+        GLuint readFramebuffer;
+        GLboolean depthMask;
+        GLenum depthFunc;
+        std::map<GLenum, GLuint> buffers;                      // Target -> buffer
+        std::map<std::pair<GLenum, GLenum>, GLuint> textures;  // (unit, target) -> texture
+        std::map<GLenum, bool> capabilities;                   // Only those set since install()
+        std::set<std::pair<GLuint, std::string>> uniformLookups;  // This frame
+
+        ShadowState() : vertexArray(0), vertexArrayUsed(true), program(0), programUsed(true),
+            activeTexture(GL_TEXTURE0), drawFramebuffer(0), readFramebuffer(0), depthMask(GL_TRUE), depthFunc(GL_LESS) {
+        }
+
+        GLuint buffer(GLenum target) const {
+            auto it = buffers.find(target);
+            return it == buffers.end() ? 0 : it->second;
+        }
+    };
+
+private:
+    // KHR_debug is not part of GL 3.3, so GLAD does not load it
+    typedef void (APIENTRYP DebugProc)(GLenum source, GLenum type, GLuint id, GLenum severity,
+        GLsizei length, const GLchar* message, const void* userParam);
+    typedef void (APIENTRYP DebugMessageCallbackProc)(DebugProc callback, const void* userParam);
+    typedef void (APIENTRYP DebugMessageControlProc)(GLenum source, GLenum type, GLenum severity,
+        GLsizei count, const GLuint* ids, GLboolean enabled);
+
+    static const GLenum DEBUG_OUTPUT = 0x92E0;
+    static const GLenum DEBUG_OUTPUT_SYNCHRONOUS = 0x8242;
+    static const GLenum DEBUG_TYPE_ERROR = 0x824C;
+    static const GLenum DEBUG_TYPE_PERFORMANCE = 0x8250;
+    static const GLenum DEBUG_SEVERITY_NOTIFICATION = 0x826B;
+
+    struct EntryStats {
+        const char* name;
+        GlFrameStats frame;      // Calls this frame
+        GlFrameStats last;       // Calls in the last finished frame
+    };
+
+    struct State {
+        std::vector<EntryStats> entries;
+        ShadowState shadow;
+        GlFrameStats frame;
+        GlFrameStats lastFrame;
+        int currentEntry;        // Entry point being called, -1 = none yet
+        bool debugOutput;
+        std::set<std::pair<GLenum, GLuint>> reportedMessages;   // (source, id)
+
+        State() : currentEntry(-1), debugOutput(false) {}
+    };
+
+    static State& state() {
+        static State s;
+        return s;
+    }
+
+    static void APIENTRY debugMessage(GLenum source, GLenum type, GLuint id, GLenum severity,
+        GLsizei length, const GLchar* message, const void* userParam) {
+        State& s = state();
+        s.frame.debugMessages++;
+        if (s.currentEntry >= 0) s.entries[s.currentEntry].frame.debugMessages++;
+        if (!s.reportedMessages.insert(std::make_pair(source, id)).second) return;
+
+        const char* entry = s.currentEntry >= 0 ? s.entries[s.currentEntry].name : "(startup)";
+        if (type == DEBUG_TYPE_ERROR) {
+            std::cerr << "ERROR::GLTRACE::DEBUG_OUTPUT\n" << entry << ": " << message << std::endl;
+        }
+        else {
+            std::cout << "GL debug (" << (type == DEBUG_TYPE_PERFORMANCE ? "performance" : "other") << ") in "
+                << entry << ": " << message << std::endl;
+        }
+    }
+
+    // Synchronous output, so a message arrives inside the call that raised it
+    static bool setupDebugOutput() {
+        if (!glfwExtensionSupported("GL_KHR_debug")) return false;
+        DebugMessageCallbackProc messageCallback =
+            reinterpret_cast<DebugMessageCallbackProc>(glfwGetProcAddress("glDebugMessageCallback"));
+        DebugMessageControlProc messageControl =
+            reinterpret_cast<DebugMessageControlProc>(glfwGetProcAddress("glDebugMessageControl"));
+        if (!messageCallback || !messageControl) return false;
+
+        glEnable(DEBUG_OUTPUT);
+        glEnable(DEBUG_OUTPUT_SYNCHRONOUS);
+        messageControl(GL_DONT_CARE, GL_DONT_CARE, DEBUG_SEVERITY_NOTIFICATION, 0, nullptr, GL_FALSE);
+        messageCallback(&GlTrace::debugMessage, nullptr);
+        return true;
+    }
+
+public:
+    // Right after GLAD has loaded, before any other GL call
+    static void install();
+
+    // For the wrappers
+    static ShadowState& shadow() { return state().shadow; }
+
+    static int addEntry(const char* name) {
+        State& s = state();
+        s.entries.push_back(EntryStats{ name, GlFrameStats(), GlFrameStats() });
+        return static_cast<int>(s.entries.size()) - 1;
+    }
+
+    static void record(int entry, Verdict verdict) {
+        State& s = state();
+        EntryStats& e = s.entries[entry];
+        s.currentEntry = entry;
+        e.frame.calls++;
+        s.frame.calls++;
+        if (verdict == REDUNDANT) {
+            e.frame.redundant++;
+            s.frame.redundant++;
+        }
+        else if (verdict == SYNC_POINT) {
+            e.frame.syncPoints++;
+            s.frame.syncPoints++;
+        }
+    }
+
+    // Once per frame, after the swap
+    static void endFrame() {
+        State& s = state();
+        for (EntryStats& e : s.entries) {
+            e.last = e.frame;
+            e.frame = GlFrameStats();
+        }
+        s.lastFrame = s.frame;
+        s.frame = GlFrameStats();
+        s.shadow.uniformLookups.clear();
+    }
+
+    // Last finished frame
+    static const GlFrameStats& getFrameStats() { return state().lastFrame; }
+
+    // Last finished frame, busiest entry points first
+    static void printInfo() {
+        const State& s = state();
+        std::cout << "GL trace: " << s.lastFrame.calls << " calls, " << s.lastFrame.redundant << " redundant, "
+            << s.lastFrame.syncPoints << " sync points, " << s.lastFrame.debugMessages << " debug messages"
+            << (s.debugOutput ? "" : " (no KHR_debug)") << std::endl;
+
+        std::vector<const EntryStats*> called;
+        for (const EntryStats& e : s.entries) {
+            if (e.last.calls > 0) called.push_back(&e);
+        }
+        std::sort(called.begin(), called.end(), [](const EntryStats* a, const EntryStats* b) {
+            return a->last.calls > b->last.calls;
+            });
+        for (const EntryStats* e : called) {
+            std::cout << "  " << e->name << ": " << e->last.calls;
+            if (e->last.redundant > 0) std::cout << ", " << e->last.redundant << " redundant";
+            if (e->last.syncPoints > 0) std::cout << ", " << e->last.syncPoints << " sync points";
+            if (e->last.debugMessages > 0) std::cout << ", " << e->last.debugMessages << " debug messages";
+            std::cout << std::endl;
+        }
+    }
+};
+
+// ==================== GlTracedEntry Class ====================
+// Wrapper for one GLAD entry point: 'Entry' is the glad_gl* pointer, 'Check'
+// a class whose static check() sees the call's arguments first and returns
+// its GlTrace::Verdict.
+template <typename Proc, Proc* Entry, typename Check>
+struct GlTracedEntry {
+    typedef Check Checker;
+    static Proc original;
+    static int slot;
+
+    static void install(const char* name);
+};
+
+template <typename Traced, typename Proc>
+struct GlTraceThunk;
+
+template <typename Traced, typename R, typename... Args>
+struct GlTraceThunk<Traced, R (APIENTRYP)(Args...)> {
+    static R APIENTRY call(Args... args) {
+        GlTrace::record(Traced::slot, Traced::Checker::check(args...));
+        return Traced::original(args...);
+    }
+};
+
+template <typename Proc, Proc* Entry, typename Check>
+Proc GlTracedEntry<Proc, Entry, Check>::original = nullptr;
+
+template <typename Proc, Proc* Entry, typename Check>
+int GlTracedEntry<Proc, Entry, Check>::slot = -1;
+
+template <typename Proc, Proc* Entry, typename Check>
+void GlTracedEntry<Proc, Entry, Check>::install(const char* name) {
+    if (original || !*Entry) return;     // Already wrapped, or not loaded
+    original = *Entry;
+    slot = GlTrace::addEntry(name);
+    *Entry = &GlTraceThunk<GlTracedEntry, Proc>::call;
+}
+
+// Checks for the wrapped entry points
+namespace GlTraceCheck {
+    typedef GlTrace::Verdict Verdict;
+    typedef GlTrace::ShadowState Shadow;
+
+    struct Call {
+        template <typename... Args>
+        static Verdict check(Args...) { return GlTrace::CALL; }
+    };
+
+    struct SyncPoint {
+        template <typename... Args>
+        static Verdict check(Args...) { return GlTrace::SYNC_POINT; }
+    };
+
+    struct Draw {
+        template <typename... Args>
+        static Verdict check(Args...) {
+            Shadow& s = GlTrace::shadow();
+            s.vertexArrayUsed = true;
+            s.programUsed = true;
+            return GlTrace::CALL;
+        }
+    };
+
+    // Vertex format calls write the bound vertex array
+    struct VertexFormat {
+        template <typename... Args>
+        static Verdict check(Args...) {
+            GlTrace::shadow().vertexArrayUsed = true;
+            return GlTrace::CALL;
+        }
+    };
+
+    struct UniformWrite {
+        template <typename... Args>
+        static Verdict check(Args...) {
+            GlTrace::shadow().programUsed = true;
+            return GlTrace::CALL;
+        }
+    };
+
+    // A location looked up twice in one frame should have been kept
+    struct UniformLookup {
+        static Verdict check(GLuint program, const GLchar* name) {
+            bool repeated = !GlTrace::shadow().uniformLookups.insert(std::make_pair(program, std::string(name))).second;
+            return repeated ? GlTrace::REDUNDANT : GlTrace::CALL;
+        }
+    };
+
+    struct BindVertexArray {
+        static Verdict check(GLuint array) {
+            Shadow& s = GlTrace::shadow();
+            if (array == s.vertexArray) return GlTrace::REDUNDANT;
+            bool unused = !s.vertexArrayUsed;
+            s.vertexArray = array;
+            s.vertexArrayUsed = false;
+            s.buffers[GL_ELEMENT_ARRAY_BUFFER] = GlTrace::UNKNOWN;    // Part of the vertex array
+            return unused ? GlTrace::REDUNDANT : GlTrace::CALL;
+        }
+    };
+
+    struct UseProgram {
+        static Verdict check(GLuint program) {
+            Shadow& s = GlTrace::shadow();
+            if (program == s.program) return GlTrace::REDUNDANT;
+            bool unused = !s.programUsed;
+            s.program = program;
+            s.programUsed = false;
+            return unused ? GlTrace::REDUNDANT : GlTrace::CALL;
+        }
+    };
+
+    struct BindBuffer {
+        static Verdict check(GLenum target, GLuint buffer) {
+            Shadow& s = GlTrace::shadow();
+            if (target == GL_ELEMENT_ARRAY_BUFFER) s.vertexArrayUsed = true;
+            if (s.buffer(target) == buffer) return GlTrace::REDUNDANT;
+            s.buffers[target] = buffer;
+            return GlTrace::CALL;
+        }
+    };
+
+    struct ActiveTexture {
+        static Verdict check(GLenum unit) {
+            Shadow& s = GlTrace::shadow();
+            if (unit == s.activeTexture) return GlTrace::REDUNDANT;
+            s.activeTexture = unit;
+            return GlTrace::CALL;
+        }
+    };
+
+    struct BindTexture {
+        static Verdict check(GLenum target, GLuint texture) {
+            Shadow& s = GlTrace::shadow();
+            std::pair<GLenum, GLenum> key(s.activeTexture, target);
+            auto it = s.textures.find(key);
+            if (texture == (it == s.textures.end() ? 0 : it->second)) return GlTrace::REDUNDANT;
+            s.textures[key] = texture;
+            return GlTrace::CALL;
+        }
+    };
+
+    struct BindFramebuffer {
+        static Verdict check(GLenum target, GLuint framebuffer) {
+            Shadow& s = GlTrace::shadow();
+            bool draw = target != GL_READ_FRAMEBUFFER;
+            bool read = target != GL_DRAW_FRAMEBUFFER;
+            if ((!draw || s.drawFramebuffer == framebuffer) && (!read || s.readFramebuffer == framebuffer)) {
+                return GlTrace::REDUNDANT;
+            }
+            if (draw) s.drawFramebuffer = framebuffer;
+            if (read) s.readFramebuffer = framebuffer;
+            return GlTrace::CALL;
+        }
+    };
+
+    template <bool Enable>
+    struct Capability {
+        static Verdict check(GLenum capability) {
+            Shadow& s = GlTrace::shadow();
+            auto it = s.capabilities.find(capability);
+            if (it != s.capabilities.end() && it->second == Enable) return GlTrace::REDUNDANT;
+            s.capabilities[capability] = Enable;
+            return GlTrace::CALL;
+        }
+    };
+
+    struct DepthMask {
+        static Verdict check(GLboolean mask) {
+            Shadow& s = GlTrace::shadow();
+            if (mask == s.depthMask) return GlTrace::REDUNDANT;
+            s.depthMask = mask;
+            return GlTrace::CALL;
+        }
+    };
+
+    struct DepthFunc {
+        static Verdict check(GLenum func) {
+            Shadow& s = GlTrace::shadow();
+            if (func == s.depthFunc) return GlTrace::REDUNDANT;
+            s.depthFunc = func;
+            return GlTrace::CALL;
+        }
+    };
+
+    // Deleting a bound object binds 0 in its place
+    struct DeleteVertexArrays {
+        static Verdict check(GLsizei count, const GLuint* arrays) {
+            Shadow& s = GlTrace::shadow();
+            for (GLsizei i = 0; i < count; i++) {
+                if (arrays[i] != 0 && arrays[i] == s.vertexArray) {
+                    s.vertexArray = 0;
+                    s.buffers[GL_ELEMENT_ARRAY_BUFFER] = GlTrace::UNKNOWN;
+                }
+            }
+            return GlTrace::CALL;
+        }
+    };
+
+    struct DeleteBuffers {
+        static Verdict check(GLsizei count, const GLuint* names) {
+            Shadow& s = GlTrace::shadow();
+            for (GLsizei i = 0; i < count; i++) {
+                for (auto& binding : s.buffers) {
+                    if (names[i] != 0 && binding.second == names[i]) binding.second = 0;
+                }
+            }
+            return GlTrace::CALL;
+        }
+    };
+
+    struct DeleteTextures {
+        static Verdict check(GLsizei count, const GLuint* names) {
+            Shadow& s = GlTrace::shadow();
+            for (GLsizei i = 0; i < count; i++) {
+                for (auto& binding : s.textures) {
+                    if (names[i] != 0 && binding.second == names[i]) binding.second = 0;
+                }
+            }
+            return GlTrace::CALL;
+        }
+    };
+
+    struct DeleteFramebuffers {
+        static Verdict check(GLsizei count, const GLuint* names) {
+            Shadow& s = GlTrace::shadow();
+            for (GLsizei i = 0; i < count; i++) {
+                if (names[i] == 0) continue;
+                if (s.drawFramebuffer == names[i]) s.drawFramebuffer = 0;
+                if (s.readFramebuffer == names[i]) s.readFramebuffer = 0;
+            }
+            return GlTrace::CALL;
+        }
+    };
+
+    // A program in use stays in use after glDeleteProgram, but its name may come back
+    struct DeleteProgram {
+        static Verdict check(GLuint program) {
+            Shadow& s = GlTrace::shadow();
+            if (program != 0 && program == s.program) s.program = GlTrace::UNKNOWN;
+            return GlTrace::CALL;
+        }
+    };
+
+    // Into client memory the driver has to wait for the GPU; into a pixel
+    // pack buffer the copy is queued
+    struct PixelRead {
+        template <typename... Args>
+        static Verdict check(Args...) {
+            return GlTrace::shadow().buffer(GL_PIXEL_PACK_BUFFER) == 0 ? GlTrace::SYNC_POINT : GlTrace::CALL;
+        }
+    };
+
+    // GL_QUERY_RESULT blocks until the result is in; GL_QUERY_RESULT_AVAILABLE does not
+    struct QueryRead {
+        template <typename T>
+        static Verdict check(GLuint, GLenum name, T*) {
+            return name == GL_QUERY_RESULT ? GlTrace::SYNC_POINT : GlTrace::CALL;
+        }
+    };
+
+    struct ClientWaitSync {
+        static Verdict check(GLsync, GLbitfield, GLuint64 timeout) {
+            return timeout > 0 ? GlTrace::SYNC_POINT : GlTrace::CALL;
+        }
+    };
+
+    // Unless unsynchronized or invalidating, a map waits for the GPU to be
+    // done with the buffer (even when a fence says it is, for a readback)
+    struct MapBufferRange {
+        static Verdict check(GLenum, GLintptr, GLsizeiptr, GLbitfield access) {
+            const GLbitfield noWait = GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_BUFFER_BIT;
+            return (access & noWait) ? GlTrace::CALL : GlTrace::SYNC_POINT;
+        }
+    };
+}
+
+#define GL_TRACE_ENTRY(name, Check) \
+    GlTracedEntry<decltype(glad_##name), &glad_##name, GlTraceCheck::Check>::install(#name)
+
+inline void GlTrace::install() {
+    State& s = state();
+    s.debugOutput = setupDebugOutput();
+
+    // Binds and state
+    GL_TRACE_ENTRY(glBindVertexArray, BindVertexArray);
+    GL_TRACE_ENTRY(glBindBuffer, BindBuffer);
+    GL_TRACE_ENTRY(glActiveTexture, ActiveTexture);
+    GL_TRACE_ENTRY(glBindTexture, BindTexture);
+    GL_TRACE_ENTRY(glBindFramebuffer, BindFramebuffer);
+    GL_TRACE_ENTRY(glUseProgram, UseProgram);
+    GL_TRACE_ENTRY(glEnable, Capability<true>);
+    GL_TRACE_ENTRY(glDisable, Capability<false>);
+    GL_TRACE_ENTRY(glDepthMask, DepthMask);
+    GL_TRACE_ENTRY(glDepthFunc, DepthFunc);
+    GL_TRACE_ENTRY(glColorMask, Call);
+    GL_TRACE_ENTRY(glCullFace, Call);
+    GL_TRACE_ENTRY(glFrontFace, Call);
+    GL_TRACE_ENTRY(glPolygonMode, Call);
+    GL_TRACE_ENTRY(glBlendFunc, Call);
+    GL_TRACE_ENTRY(glStencilFunc, Call);
+    GL_TRACE_ENTRY(glStencilOp, Call);
+    GL_TRACE_ENTRY(glStencilMask, Call);
+    GL_TRACE_ENTRY(glViewport, Call);
+    GL_TRACE_ENTRY(glScissor, Call);
+    GL_TRACE_ENTRY(glPixelStorei, Call);
+    GL_TRACE_ENTRY(glDrawBuffer, Call);
+    GL_TRACE_ENTRY(glDrawBuffers, Call);
+    GL_TRACE_ENTRY(glReadBuffer, Call);
+
+    // Draws and what they use
+    GL_TRACE_ENTRY(glDrawArrays, Draw);
+    GL_TRACE_ENTRY(glDrawElements, Draw);
+    GL_TRACE_ENTRY(glDrawElementsBaseVertex, Draw);
+    GL_TRACE_ENTRY(glClear, Call);
+    GL_TRACE_ENTRY(glClearColor, Call);
+    GL_TRACE_ENTRY(glVertexAttribPointer, VertexFormat);
+    GL_TRACE_ENTRY(glEnableVertexAttribArray, VertexFormat);
+    GL_TRACE_ENTRY(glGetUniformLocation, UniformLookup);
+    GL_TRACE_ENTRY(glUniform1i, UniformWrite);
+    GL_TRACE_ENTRY(glUniform1f, UniformWrite);
+    GL_TRACE_ENTRY(glUniform2f, UniformWrite);
+    GL_TRACE_ENTRY(glUniform3i, UniformWrite);
+    GL_TRACE_ENTRY(glUniform3fv, UniformWrite);
+    GL_TRACE_ENTRY(glUniformMatrix4fv, UniformWrite);
+
+    // Objects and uploads
+    GL_TRACE_ENTRY(glGenVertexArrays, Call);
+    GL_TRACE_ENTRY(glDeleteVertexArrays, DeleteVertexArrays);
+    GL_TRACE_ENTRY(glGenBuffers, Call);
+    GL_TRACE_ENTRY(glDeleteBuffers, DeleteBuffers);
+    GL_TRACE_ENTRY(glBufferData, Call);
+    GL_TRACE_ENTRY(glBufferSubData, Call);
+    GL_TRACE_ENTRY(glMapBufferRange, MapBufferRange);
+    GL_TRACE_ENTRY(glMapBuffer, SyncPoint);
+    GL_TRACE_ENTRY(glUnmapBuffer, Call);
+    GL_TRACE_ENTRY(glGenTextures, Call);
+    GL_TRACE_ENTRY(glDeleteTextures, DeleteTextures);
+    GL_TRACE_ENTRY(glTexImage2D, Call);
+    GL_TRACE_ENTRY(glTexParameteri, Call);
+    GL_TRACE_ENTRY(glTexBuffer, Call);
+    GL_TRACE_ENTRY(glGenFramebuffers, Call);
+    GL_TRACE_ENTRY(glDeleteFramebuffers, DeleteFramebuffers);
+    GL_TRACE_ENTRY(glFramebufferTexture2D, Call);
+    GL_TRACE_ENTRY(glCheckFramebufferStatus, Call);
+    GL_TRACE_ENTRY(glCreateShader, Call);
+    GL_TRACE_ENTRY(glShaderSource, Call);
+    GL_TRACE_ENTRY(glCompileShader, Call);
+    GL_TRACE_ENTRY(glDeleteShader, Call);
+    GL_TRACE_ENTRY(glCreateProgram, Call);
+    GL_TRACE_ENTRY(glAttachShader, Call);
+    GL_TRACE_ENTRY(glLinkProgram, Call);
+    GL_TRACE_ENTRY(glDeleteProgram, DeleteProgram);
+
+    // Queries, fences and readbacks
+    GL_TRACE_ENTRY(glGenQueries, Call);
+    GL_TRACE_ENTRY(glDeleteQueries, Call);
+    GL_TRACE_ENTRY(glBeginQuery, Call);
+    GL_TRACE_ENTRY(glEndQuery, Call);
+    GL_TRACE_ENTRY(glBeginConditionalRender, Call);
+    GL_TRACE_ENTRY(glEndConditionalRender, Call);
+    GL_TRACE_ENTRY(glGetQueryObjectiv, QueryRead);
+    GL_TRACE_ENTRY(glGetQueryObjectuiv, QueryRead);
+    GL_TRACE_ENTRY(glGetQueryObjectui64v, QueryRead);
+    GL_TRACE_ENTRY(glFenceSync, Call);
+    GL_TRACE_ENTRY(glDeleteSync, Call);
+    GL_TRACE_ENTRY(glClientWaitSync, ClientWaitSync);
+    GL_TRACE_ENTRY(glReadPixels, PixelRead);
+    GL_TRACE_ENTRY(glGetTexImage, PixelRead);
+    GL_TRACE_ENTRY(glGetBufferSubData, SyncPoint);
+    GL_TRACE_ENTRY(glFinish, SyncPoint);
+    GL_TRACE_ENTRY(glGetError, SyncPoint);
+    GL_TRACE_ENTRY(glGetIntegerv, SyncPoint);
+    GL_TRACE_ENTRY(glGetFloatv, SyncPoint);
+    GL_TRACE_ENTRY(glGetBooleanv, SyncPoint);
+    GL_TRACE_ENTRY(glGetShaderiv, SyncPoint);
+    GL_TRACE_ENTRY(glGetShaderInfoLog, SyncPoint);
+    GL_TRACE_ENTRY(glGetProgramiv, SyncPoint);
+    GL_TRACE_ENTRY(glGetProgramInfoLog, SyncPoint);
+
+    std::cout << "GL trace: " << s.entries.size() << " entry points wrapped, KHR_debug "
+        << (s.debugOutput ? "ON" : "not available") << std::endl;
+}
+
+#undef GL_TRACE_ENTRY
+
+#else
+
+// Tracing compiled out: every call below is empty
+class GlTrace {
+public:
+    static constexpr bool ENABLED = false;
+
+    static void install() {}
+    static void endFrame() {}
+    static GlFrameStats getFrameStats() { return GlFrameStats(); }
+    static void printInfo() {}
+};
+
+#endif
+
+#endif
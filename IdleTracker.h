@@ -0,0 +1,95 @@
+#ifndef IDLETRACKER_H
+#define IDLETRACKER_H
+
+#include <GLFW/glfw3.h>
+
+#include <chrono>
+#include <iostream>
+
+// ==================== IdleTracker Class ====================
+// Lets the main loop stop drawing frames that would look like the last one.
+// Every iteration the loop reports what could change the picture: input and
+// window events (markChanged), the camera's revision, the framebuffer size,
+// models still animating, assets still loading. After SETTLE_FRAMES quiet
+// frames (occlusion results lag a frame or two behind the view) the loop
+// skips rendering and the swap, so the last presented frame stays on screen,
+// and sleeps in glfwWaitEventsTimeout until the next event. The timeout only
+// bounds how late a change that arrives without an event is noticed.
+class IdleTracker {
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    bool enabled;
+    bool changed;            // Something changed since the last decision
+    bool idle;               // The last iteration skipped rendering
+    int quietFrames;         // Frames rendered since the last change
+    unsigned long cameraRevision;
+    int framebufferWidth;
+    int framebufferHeight;
+
+    size_t framesRendered;   // Since the last report
+    size_t framesSkipped;
+    double secondsWaiting;
+
+public:
+    static const int SETTLE_FRAMES = 3;
+    static constexpr double WAIT_TIMEOUT = 0.25;     // Seconds
+
+    IdleTracker() : enabled(true), changed(true), idle(false), quietFrames(0), cameraRevision(0),
+        framebufferWidth(0), framebufferHeight(0), framesRendered(0), framesSkipped(0), secondsWaiting(0.0) {
+    }
+
+    // Disabled, every iteration renders
+    void setEnabled(bool on) { enabled = on; }
+    bool isEnabled() const { return enabled; }
+
+    void markChanged() { changed = true; }
+
+    void trackCamera(unsigned long revision) {
+        if (revision == cameraRevision) return;
+        cameraRevision = revision;
+        changed = true;
+    }
+
+    void trackFramebuffer(int width, int height) {
+        if (width == framebufferWidth && height == framebufferHeight) return;
+        framebufferWidth = width;
+        framebufferHeight = height;
+        changed = true;
+    }
+
+    // Once per iteration after the update; false = skip rendering and the swap
+    bool shouldRender() {
+        if (changed || !enabled) quietFrames = 0;
+        changed = false;
+
+        idle = quietFrames >= SETTLE_FRAMES;
+        if (idle) {
+            framesSkipped++;
+            return false;
+        }
+        quietFrames++;
+        framesRendered++;
+        return true;
+    }
+
+    bool isIdle() const { return idle; }
+
+    // Call at the top of the loop while idle; pending events are dispatched to
+    // their callbacks before this returns
+    void waitForEvents() {
+        Clock::time_point start = Clock::now();
+        glfwWaitEventsTimeout(WAIT_TIMEOUT);
+        secondsWaiting += std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    void printInfo() {
+        std::cout << "Idle rendering: " << (enabled ? "ON" : "OFF") << ", " << framesRendered << " frames rendered, "
+            << framesSkipped << " skipped, " << secondsWaiting << " s waiting for events" << std::endl;
+        framesRendered = 0;
+        framesSkipped = 0;
+        secondsWaiting = 0.0;
+    }
+};
+
+#endif
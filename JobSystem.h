@@ -0,0 +1,323 @@
+#ifndef JOBSYSTEM_H
+#define JOBSYSTEM_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <initializer_list>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class JobSystem;
+
+// ==================== JobGraph Class ====================
+// One frame's jobs and the dependencies between them. Build it, hand it to
+// JobSystem::run(), wait for the jobs whose results are needed next, and
+// waitAll() before reset(). A job can only depend on jobs added before it,
+// so the graph is acyclic by construction. Nodes are kept across reset(),
+// so a graph rebuilt every frame stops allocating after the first.
+class JobGraph {
+public:
+    typedef int Job;
+
+    struct Timing {
+        const char* name;
+        int worker;          // 0 = a thread outside the system (the main loop)
+        double beginMs;      // Relative to run()
+        double endMs;
+    };
+
+private:
+    friend class JobSystem;
+    typedef std::chrono::steady_clock Clock;
+
+    struct Node {
+        const char* name;
+        std::function<void()> function;
+        std::vector<Job> successors;
+        int dependencyCount;
+        std::atomic<int> pending;      // Dependencies not finished yet
+        std::atomic<bool> done;
+        JobGraph* graph;
+        Timing timing;
+    };
+
+    std::deque<Node> nodes;            // Stable addresses; only [0, nodeCount) are live
+    size_t nodeCount;
+    std::atomic<size_t> remaining;
+    bool running;
+    Clock::time_point startTime;
+
+public:
+    JobGraph() : nodeCount(0), remaining(0), running(false) {}
+
+    JobGraph(const JobGraph&) = delete;
+    JobGraph& operator=(const JobGraph&) = delete;
+
+    // 'name' must outlive the graph (string literals)
+    Job add(const char* name, std::function<void()> function, std::initializer_list<Job> dependencies = {}) {
+        if (nodeCount == nodes.size()) nodes.emplace_back();
+        Node& node = nodes[nodeCount];
+        node.name = name;
+        node.function = std::move(function);
+        node.successors.clear();
+        node.dependencyCount = 0;
+        node.graph = this;
+        node.timing = Timing{ name, -1, 0.0, 0.0 };
+
+        Job job = static_cast<Job>(nodeCount++);
+        for (Job dependency : dependencies) addDependency(job, dependency);
+        return job;
+    }
+
+    // For dependency sets only known at run time; negative ids (no job) are ignored
+    void addDependency(Job job, Job before) {
+        if (before < 0 || before >= job) return;
+        nodes[before].successors.push_back(job);
+        nodes[job].dependencyCount++;
+    }
+
+    // Only once every job has finished (JobSystem::waitAll)
+    void reset() {
+        for (size_t i = 0; i < nodeCount; i++) nodes[i].function = nullptr;   // Drop captured state
+        nodeCount = 0;
+    }
+
+    size_t size() const { return nodeCount; }
+    bool isRunning() const { return running; }
+    const Timing& getTiming(Job job) const { return nodes[job].timing; }
+
+    // Last run's jobs, in the order they were added
+    void printInfo() const {
+        double span = 0.0, busy = 0.0;
+        for (size_t i = 0; i < nodeCount; i++) {
+            span = std::max(span, nodes[i].timing.endMs);
+            busy += nodes[i].timing.endMs - nodes[i].timing.beginMs;
+        }
+        std::cout << "Job graph: " << nodeCount << " jobs, " << busy << " ms of work in " << span << " ms" << std::endl;
+        for (size_t i = 0; i < nodeCount; i++) {
+            const Timing& t = nodes[i].timing;
+            std::cout << "  " << t.name << ": " << t.beginMs << " - " << t.endMs << " ms on "
+                << (t.worker == 0 ? std::string("main") : "worker " + std::to_string(t.worker)) << std::endl;
+        }
+    }
+};
+
+// ==================== JobSystem Class ====================
+// Work-stealing scheduler for short per-frame jobs. Every worker owns a
+// deque: it pushes the jobs it makes ready (successors of the job it just
+// ran) and pops its next job at the back, so a chain of dependent jobs stays
+// on one core with warm caches. A worker whose deque is empty steals from
+// the front of another's, where the oldest jobs are. Threads outside the
+// system (the main loop) share deque 0 and help run jobs while they wait,
+// so waiting for one job never idles the waiting core.
+// Deques are short and mutex-guarded; a lock-free deque would only pay off
+// with thousands of jobs per frame.
+// Long-running work (asset loads, encoding) belongs on the ThreadPool, where
+// it cannot hold up a frame's jobs.
+class JobSystem {
+public:
+    // Called on the thread that ran the job, right after it; must be thread-safe
+    typedef std::function<void(const JobGraph::Timing&)> TimingHook;
+
+private:
+    typedef JobGraph::Node Node;
+    typedef std::chrono::steady_clock Clock;
+
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<Node*> jobs;
+    };
+
+    std::vector<std::thread> threads;
+    std::deque<WorkerQueue> queues;        // [0] = threads outside the system
+    std::atomic<int> queuedJobs;
+    std::atomic<int> sleepingWorkers;
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+    bool stopping;
+    TimingHook timingHook;
+
+    static const int SPIN_ATTEMPTS = 64;   // Steal attempts before a worker sleeps
+
+    struct ThreadSlot {
+        const JobSystem* system;
+        int index;
+    };
+
+    static ThreadSlot& threadSlot() {
+        static thread_local ThreadSlot slot = { nullptr, 0 };
+        return slot;
+    }
+
+    int currentQueue() const {
+        const ThreadSlot& slot = threadSlot();
+        return slot.system == this ? slot.index : 0;
+    }
+
+    void push(int queue, Node* node) {
+        {
+            std::lock_guard<std::mutex> lock(queues[queue].mutex);
+            queues[queue].jobs.push_back(node);
+        }
+        queuedJobs.fetch_add(1);
+        // Pairs with the sleeper's check under sleepMutex: either it sees the
+        // job, or this sees it sleeping and wakes it
+        if (sleepingWorkers.load() > 0) {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            wake.notify_one();
+        }
+    }
+
+    Node* popOwn(int queue) {
+        WorkerQueue& q = queues[queue];
+        std::lock_guard<std::mutex> lock(q.mutex);
+        if (q.jobs.empty()) return nullptr;
+        Node* node = q.jobs.back();
+        q.jobs.pop_back();
+        queuedJobs.fetch_sub(1);
+        return node;
+    }
+
+    Node* steal(int thief) {
+        size_t count = queues.size();
+        for (size_t k = 1; k < count; k++) {
+            WorkerQueue& q = queues[(thief + k) % count];
+            std::lock_guard<std::mutex> lock(q.mutex);
+            if (q.jobs.empty()) continue;
+            Node* node = q.jobs.front();
+            q.jobs.pop_front();
+            queuedJobs.fetch_sub(1);
+            return node;
+        }
+        return nullptr;
+    }
+
+    void execute(Node* node, int queue) {
+        JobGraph& graph = *node->graph;
+        Clock::time_point begin = Clock::now();
+        try {
+            node->function();
+        }
+        catch (const std::exception& e) {
+            std::cerr << "ERROR::JOBSYSTEM::JOB_FAILED\n" << node->name << ": " << e.what() << std::endl;
+        }
+        Clock::time_point end = Clock::now();
+
+        node->timing.worker = queue;
+        node->timing.beginMs = std::chrono::duration<double, std::milli>(begin - graph.startTime).count();
+        node->timing.endMs = std::chrono::duration<double, std::milli>(end - graph.startTime).count();
+        if (timingHook) timingHook(node->timing);
+
+        node->done.store(true, std::memory_order_release);
+        for (JobGraph::Job successor : node->successors) {
+            Node& next = graph.nodes[successor];
+            if (next.pending.fetch_sub(1, std::memory_order_acq_rel) == 1) push(queue, &next);
+        }
+        // Last touch of the graph: the owner may reset it once this reaches 0
+        graph.remaining.fetch_sub(1, std::memory_order_acq_rel);
+    }
+
+    bool runOne(int queue) {
+        Node* node = popOwn(queue);
+        if (!node) node = steal(queue);
+        if (!node) return false;
+        execute(node, queue);
+        return true;
+    }
+
+    void workerLoop(int index) {
+        threadSlot() = ThreadSlot{ this, index };
+        while (true) {
+            bool ran = false;
+            for (int attempt = 0; attempt < SPIN_ATTEMPTS && !ran; attempt++) {
+                ran = runOne(index);
+                if (!ran) std::this_thread::yield();
+            }
+            if (ran) continue;
+
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            sleepingWorkers.fetch_add(1);
+            wake.wait(lock, [this] { return stopping || queuedJobs.load() > 0; });
+            sleepingWorkers.fetch_sub(1);
+            if (stopping) return;
+        }
+    }
+
+public:
+    // 0 = one worker per hardware thread, leaving one for the main loop
+    explicit JobSystem(size_t workerCount = 0) : queuedJobs(0), sleepingWorkers(0), stopping(false) {
+        if (workerCount == 0) {
+            unsigned int hardware = std::thread::hardware_concurrency();
+            workerCount = hardware > 1 ? hardware - 1 : 1;
+        }
+        for (size_t i = 0; i <= workerCount; i++) queues.emplace_back();
+        for (size_t i = 0; i < workerCount; i++) {
+            threads.emplace_back(&JobSystem::workerLoop, this, static_cast<int>(i + 1));
+        }
+    }
+
+    // No graph may be running
+    ~JobSystem() {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& thread : threads) thread.join();
+    }
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    void setTimingHook(TimingHook hook) { timingHook = std::move(hook); }
+
+    // Starts every job without dependencies; the rest start as their last
+    // dependency finishes
+    void run(JobGraph& graph) {
+        if (graph.nodeCount == 0) return;
+        graph.running = true;
+        graph.startTime = Clock::now();
+        // Every count is set before any job can finish and decrement one
+        for (size_t i = 0; i < graph.nodeCount; i++) {
+            Node& node = graph.nodes[i];
+            node.pending.store(node.dependencyCount, std::memory_order_relaxed);
+            node.done.store(false, std::memory_order_relaxed);
+        }
+        graph.remaining.store(graph.nodeCount, std::memory_order_release);
+
+        int queue = currentQueue();
+        for (size_t i = 0; i < graph.nodeCount; i++) {
+            if (graph.nodes[i].dependencyCount == 0) push(queue, &graph.nodes[i]);
+        }
+    }
+
+    // Runs other jobs until 'job' has finished
+    void wait(JobGraph& graph, JobGraph::Job job) {
+        if (!graph.running) return;
+        const Node& node = graph.nodes[job];
+        int queue = currentQueue();
+        while (!node.done.load(std::memory_order_acquire)) {
+            if (!runOne(queue)) std::this_thread::yield();
+        }
+    }
+
+    void waitAll(JobGraph& graph) {
+        if (!graph.running) return;
+        int queue = currentQueue();
+        while (graph.remaining.load(std::memory_order_acquire) > 0) {
+            if (!runOne(queue)) std::this_thread::yield();
+        }
+        graph.running = false;
+    }
+
+    size_t getWorkerCount() const { return threads.size(); }
+};
+
+#endif
@@ -0,0 +1,225 @@
+#ifndef MESHBUFFER_H
+#define MESHBUFFER_H
+
+#include <glad/glad.h>
+
+#include <cstring>
+#include <iostream>
+#include <unordered_map>
+#include <vector>
+
+// ==================== MeshRange Struct ====================
+// Where one part's geometry lives: a VAO and an index (or vertex) range in it
+struct MeshRange {
+    unsigned int VAO;
+    unsigned int first;      // First index (indexed) or first vertex (arrays)
+    unsigned int count;
+    int baseVertex;          // Added to every index (indexed only)
+    bool indexed;
+
+    MeshRange() : VAO(0), first(0), count(0), baseVertex(0), indexed(true) {}
+};
+
+// ==================== DrawStats Struct ====================
+// Draw calls and triangles issued since the frame started; the main loop
+// resets them before rendering and the HUD reads them (GL thread only)
+struct DrawStats {
+    unsigned int drawCalls;
+    unsigned int triangles;
+
+    DrawStats() : drawCalls(0), triangles(0) {}
+
+    void count(unsigned int vertexCount) {
+        drawCalls++;
+        triangles += vertexCount / 3;
+    }
+};
+
+inline DrawStats& drawStats() {
+    static DrawStats stats;
+    return stats;
+}
+
+// Expects mesh.VAO to be bound
+inline void drawMesh(const MeshRange& mesh) {
+    drawStats().count(mesh.count);
+    if (mesh.indexed)
+        glDrawElementsBaseVertex(GL_TRIANGLES, mesh.count, GL_UNSIGNED_INT,
+            (void*)(mesh.first * sizeof(unsigned int)), mesh.baseVertex);
+    else
+        glDrawArrays(GL_TRIANGLES, mesh.first, mesh.count);
+}
+
+// Uploads interleaved position/color vertices (6 floats each) and sets up the
+// VAO the way every shader here expects. EBO = 0 for vertex-only meshes.
+// Any contiguous float / unsigned int vectors (std::vector, ArenaVector).
+template <typename VertexVector, typename IndexVector>
+inline void uploadVertexData(unsigned int VAO, unsigned int VBO, unsigned int EBO,
+    const VertexVector& vertices, const IndexVector& indices) {
+    glBindVertexArray(VAO);
+
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
+
+    if (EBO) {
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
+    }
+
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+
+    glBindVertexArray(0);
+}
+
+// ==================== MeshBuffer Class ====================
+// One VAO/VBO/EBO shared by many parts. Parts append their CPU-built geometry
+// (add/addArrays), then everything reaches the GPU in one glBufferData per
+// buffer instead of one pair of buffers per part.
+// Every part goes through MeshOptimizer on the way in (welded, cache and
+// overdraw ordered, always indexed) and FaceCuller::orientOutward() (so back-face
+// culling never drops an outer face), and a part identical to one already in
+// the buffer (e.g. same-colored cubes) gets the existing range instead of a copy.
+class MeshBuffer {
+private:
+    struct UniquePart {
+        MeshRange range;
+        size_t vertexFloats;
+    };
+
+    unsigned int VAO, VBO, EBO;
+    std::vector<float> vertices;
+    std::vector<unsigned int> indices;
+    size_t uploadedBytes;
+
+    // Content hash -> parts already stored (CPU side, until upload)
+    std::unordered_multimap<uint64_t, UniquePart> uniqueParts;
+
+    // Optimizer report
+    size_t partCount, sharedParts;
+    size_t inputVertices, inputTriangles;
+    size_t missesBefore, missesAfter;
+    size_t rewoundTriangles;
+
+    static uint64_t hashBytes(const void* data, size_t size, uint64_t h) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; i++) h = (h ^ bytes[i]) * 1099511628211ull;
+        return h;
+    }
+
+    MeshRange addOptimized(std::vector<float>& partVertices, std::vector<unsigned int>& partIndices) {
+        size_t inputVertexCount = partVertices.size() / 6;
+        if (partIndices.empty()) {
+            // Triangle list: every vertex is transformed once per use
+            missesBefore += inputVertexCount;
+        }
+        else {
+            missesBefore += MeshOptimizer::countCacheMisses(partIndices, inputVertexCount);
+        }
+        inputVertices += inputVertexCount;
+        partCount++;
+
+        // Winding is checked against the full vertex set: optimize() drops unused vertices
+        MeshOptimizer::weldVertices(partVertices, partIndices);
+        rewoundTriangles += FaceCuller::orientOutward(partVertices, partIndices);
+        MeshOptimizer::optimize(partVertices, partIndices);
+        inputTriangles += partIndices.size() / 3;
+        missesAfter += MeshOptimizer::countCacheMisses(partIndices, partVertices.size() / 6);
+
+        uint64_t h = hashBytes(partVertices.data(), partVertices.size() * sizeof(float), 1469598103934665603ull);
+        h = hashBytes(partIndices.data(), partIndices.size() * sizeof(unsigned int), h);
+        auto candidates = uniqueParts.equal_range(h);
+        for (auto it = candidates.first; it != candidates.second; ++it) {
+            const UniquePart& part = it->second;
+            if (part.vertexFloats == partVertices.size() && part.range.count == partIndices.size() &&
+                std::memcmp(&vertices[part.range.baseVertex * 6], partVertices.data(), partVertices.size() * sizeof(float)) == 0 &&
+                std::memcmp(&indices[part.range.first], partIndices.data(), partIndices.size() * sizeof(unsigned int)) == 0) {
+                sharedParts++;
+                return part.range;
+            }
+        }
+
+        MeshRange range;
+        range.VAO = VAO;
+        range.first = static_cast<unsigned int>(indices.size());
+        range.count = static_cast<unsigned int>(partIndices.size());
+        range.baseVertex = static_cast<int>(vertices.size() / 6);
+        range.indexed = true;
+
+        vertices.insert(vertices.end(), partVertices.begin(), partVertices.end());
+        indices.insert(indices.end(), partIndices.begin(), partIndices.end());
+        uniqueParts.emplace(h, UniquePart{ range, partVertices.size() });
+        return range;
+    }
+
+public:
+    MeshBuffer()
+        : VAO(0), VBO(0), EBO(0), uploadedBytes(0), partCount(0), sharedParts(0),
+        inputVertices(0), inputTriangles(0), missesBefore(0), missesAfter(0), rewoundTriangles(0) {
+    }
+
+    // Names are generated up front so parts can record the VAO while appending
+    void create() {
+        glGenVertexArrays(1, &VAO);
+        glGenBuffers(1, &VBO);
+        glGenBuffers(1, &EBO);
+    }
+
+    template <typename VertexVector, typename IndexVector>
+    MeshRange add(const VertexVector& partVertices, const IndexVector& partIndices) {
+        std::vector<float> optimizedVertices(partVertices.begin(), partVertices.end());
+        std::vector<unsigned int> optimizedIndices(partIndices.begin(), partIndices.end());
+        return addOptimized(optimizedVertices, optimizedIndices);
+    }
+
+    // Triangle list; stored welded and indexed like every other part
+    template <typename VertexVector>
+    MeshRange addArrays(const VertexVector& partVertices) {
+        std::vector<float> optimizedVertices(partVertices.begin(), partVertices.end());
+        std::vector<unsigned int> optimizedIndices;
+        return addOptimized(optimizedVertices, optimizedIndices);
+    }
+
+    // Single write per buffer; the CPU copy is released afterwards
+    void upload() {
+        uploadVertexData(VAO, VBO, EBO, vertices, indices);
+        uploadedBytes = vertices.size() * sizeof(float) + indices.size() * sizeof(unsigned int);
+
+        std::vector<float>().swap(vertices);
+        std::vector<unsigned int>().swap(indices);
+        uniqueParts.clear();
+    }
+
+    size_t getUploadedBytes() const { return uploadedBytes; }
+
+    // ACMR before/after over all parts added, with the FIFO model of MeshOptimizer
+    void printInfo(const char* label) const {
+        if (inputTriangles == 0) return;
+        std::cout << label << " mesh: " << partCount << " parts (" << sharedParts << " shared), "
+            << inputVertices << " input vertices, " << inputTriangles << " triangles, ACMR "
+            << static_cast<float>(missesBefore) / inputTriangles << " -> "
+            << static_cast<float>(missesAfter) / inputTriangles
+            << ", " << uploadedBytes / 1024 << " KB" << std::endl;
+        if (rewoundTriangles > 0) {
+            std::cout << "  " << rewoundTriangles << " triangles were wound inward and have been flipped" << std::endl;
+        }
+    }
+    bool isCreated() const { return VAO != 0; }
+
+    void cleanup() {
+        if (VAO) glDeleteVertexArrays(1, &VAO);
+        if (VBO) glDeleteBuffers(1, &VBO);
+        if (EBO) glDeleteBuffers(1, &EBO);
+        VAO = VBO = EBO = 0;
+        uploadedBytes = 0;
+        partCount = sharedParts = 0;
+        inputVertices = inputTriangles = 0;
+        missesBefore = missesAfter = 0;
+        rewoundTriangles = 0;
+    }
+};
+
+#endif
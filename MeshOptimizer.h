@@ -0,0 +1,246 @@
+#ifndef MESHOPTIMIZER_H
+#define MESHOPTIMIZER_H
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+// ==================== MeshOptimizer Class ====================
+// Load-time index and vertex optimization for the 6-float (position, color)
+// vertices used everywhere. Run once per part before it reaches the GPU:
+//   weldVertices()        - merge bit-identical vertices (non-indexed input allowed)
+//   optimizeVertexCache() - Tipsify (Sander et al. 2007): triangle order that
+//                           keeps recently transformed vertices in the
+//                           post-transform cache, split into clusters
+//   optimizeOverdraw()    - clusters facing away from the mesh center first,
+//                           so outer surfaces fill depth before inner ones
+//   optimizeVertexFetch() - vertices renumbered in first-use order
+// ACMR (average cache miss ratio: transformed vertices per triangle, 0.5 is
+// ideal for large grids, 3.0 is no reuse) is measured with a FIFO cache model.
+class MeshOptimizer {
+public:
+    static const int VERTEX_FLOATS = 6;
+    static const int CACHE_SIZE = 16;        // Conservative model of the post-transform cache
+
+    // Vertex misses per triangle through a FIFO cache of cacheSize entries
+    static size_t countCacheMisses(const std::vector<unsigned int>& indices, size_t vertexCount, int cacheSize = CACHE_SIZE) {
+        std::vector<size_t> insertedAt(vertexCount, 0);   // FIFO position + 1, 0 = never loaded
+        size_t misses = 0;
+        for (unsigned int v : indices) {
+            if (insertedAt[v] == 0 || misses - (insertedAt[v] - 1) >= static_cast<size_t>(cacheSize)) {
+                insertedAt[v] = ++misses;
+            }
+        }
+        return misses;
+    }
+
+    static float computeACMR(const std::vector<unsigned int>& indices, size_t vertexCount, int cacheSize = CACHE_SIZE) {
+        if (indices.size() < 3) return 0.0f;
+        return static_cast<float>(countCacheMisses(indices, vertexCount, cacheSize)) / (indices.size() / 3);
+    }
+
+    // Merges vertices with identical bits. Empty 'indices' means the input is
+    // a plain triangle list (glDrawArrays); it comes back indexed.
+    static void weldVertices(std::vector<float>& vertices, std::vector<unsigned int>& indices) {
+        size_t vertexCount = vertices.size() / VERTEX_FLOATS;
+        if (indices.empty()) {
+            indices.resize(vertexCount);
+            for (size_t i = 0; i < vertexCount; i++) indices[i] = static_cast<unsigned int>(i);
+        }
+
+        auto vertexAt = [&vertices](size_t v) { return &vertices[v * VERTEX_FLOATS]; };
+        auto hashVertex = [&vertexAt](size_t v) {
+            uint64_t h = 1469598103934665603ull;
+            const unsigned char* bytes = reinterpret_cast<const unsigned char*>(vertexAt(v));
+            for (size_t i = 0; i < VERTEX_FLOATS * sizeof(float); i++) h = (h ^ bytes[i]) * 1099511628211ull;
+            return h;
+        };
+
+        std::unordered_multimap<uint64_t, unsigned int> seen;
+        std::vector<unsigned int> remap(vertexCount);
+        std::vector<float> welded;
+        welded.reserve(vertices.size());
+        for (size_t v = 0; v < vertexCount; v++) {
+            uint64_t h = hashVertex(v);
+            auto range = seen.equal_range(h);
+            unsigned int found = static_cast<unsigned int>(-1);
+            for (auto it = range.first; it != range.second; ++it) {
+                if (std::memcmp(&welded[it->second * VERTEX_FLOATS], vertexAt(v), VERTEX_FLOATS * sizeof(float)) == 0) {
+                    found = it->second;
+                    break;
+                }
+            }
+            if (found == static_cast<unsigned int>(-1)) {
+                found = static_cast<unsigned int>(welded.size() / VERTEX_FLOATS);
+                welded.insert(welded.end(), vertexAt(v), vertexAt(v) + VERTEX_FLOATS);
+                seen.emplace(h, found);
+            }
+            remap[v] = found;
+        }
+
+        for (unsigned int& index : indices) index = remap[index];
+        vertices.swap(welded);
+    }
+
+    // Tipsify. Fans around the most recently used vertex that will still be
+    // in the cache; on a dead end falls back to the stack of recent vertices,
+    // then to the next unfinished vertex in input order. Each fallback is a
+    // likely cache flush and starts a new cluster (used by optimizeOverdraw).
+    static void optimizeVertexCache(std::vector<unsigned int>& indices, size_t vertexCount,
+        std::vector<size_t>* clusterStarts = nullptr, int cacheSize = CACHE_SIZE) {
+        size_t triangleCount = indices.size() / 3;
+        if (triangleCount == 0) return;
+
+        // Vertex -> triangles adjacency (CSR)
+        std::vector<unsigned int> liveTriangles(vertexCount, 0);
+        for (unsigned int v : indices) liveTriangles[v]++;
+        std::vector<size_t> adjacencyStart(vertexCount + 1, 0);
+        for (size_t v = 0; v < vertexCount; v++) adjacencyStart[v + 1] = adjacencyStart[v] + liveTriangles[v];
+        std::vector<unsigned int> adjacency(indices.size());
+        std::vector<size_t> fill(adjacencyStart.begin(), adjacencyStart.end() - 1);
+        for (size_t i = 0; i < indices.size(); i++) adjacency[fill[indices[i]]++] = static_cast<unsigned int>(i / 3);
+
+        std::vector<int> cacheTime(vertexCount, 0);
+        std::vector<bool> emitted(triangleCount, false);
+        std::vector<unsigned int> deadEnds;
+        std::vector<unsigned int> candidates;
+        std::vector<unsigned int> output;
+        output.reserve(indices.size());
+        if (clusterStarts) {
+            clusterStarts->clear();
+            clusterStarts->push_back(0);
+        }
+
+        int timestamp = cacheSize + 1;
+        size_t cursor = 0;
+        int fan = 0;
+        while (fan >= 0) {
+            candidates.clear();
+            for (size_t a = adjacencyStart[fan]; a < adjacencyStart[fan + 1]; a++) {
+                unsigned int t = adjacency[a];
+                if (emitted[t]) continue;
+                for (int k = 0; k < 3; k++) {
+                    unsigned int v = indices[t * 3 + k];
+                    output.push_back(v);
+                    deadEnds.push_back(v);
+                    candidates.push_back(v);
+                    liveTriangles[v]--;
+                    if (timestamp - cacheTime[v] > cacheSize) cacheTime[v] = timestamp++;
+                }
+                emitted[t] = true;
+            }
+
+            // Next fan: the candidate that is still cached after its own triangles, oldest first
+            int next = -1, best = -1;
+            for (unsigned int v : candidates) {
+                if (liveTriangles[v] == 0) continue;
+                int priority = 0;
+                if (timestamp - cacheTime[v] + 2 * static_cast<int>(liveTriangles[v]) <= cacheSize) priority = timestamp - cacheTime[v];
+                if (priority > best) {
+                    best = priority;
+                    next = static_cast<int>(v);
+                }
+            }
+            if (next < 0) {
+                while (!deadEnds.empty() && next < 0) {
+                    unsigned int d = deadEnds.back();
+                    deadEnds.pop_back();
+                    if (liveTriangles[d] > 0) next = static_cast<int>(d);
+                }
+                while (next < 0 && cursor < vertexCount) {
+                    if (liveTriangles[cursor] > 0) next = static_cast<int>(cursor);
+                    else cursor++;
+                }
+                if (next >= 0 && clusterStarts && output.size() < indices.size()) clusterStarts->push_back(output.size() / 3);
+            }
+            fan = next;
+        }
+
+        indices.swap(output);
+    }
+
+    // Orders the clusters from optimizeVertexCache() by how much they face
+    // outward: dot(cluster centroid - mesh centroid, cluster normal), largest
+    // first. Triangles inside a cluster keep their cache-friendly order.
+    static void optimizeOverdraw(std::vector<unsigned int>& indices, const std::vector<float>& vertices,
+        const std::vector<size_t>& clusterStarts) {
+        size_t triangleCount = indices.size() / 3;
+        if (clusterStarts.size() < 2) return;
+
+        auto position = [&vertices](unsigned int v) {
+            return glm::vec3(vertices[v * VERTEX_FLOATS], vertices[v * VERTEX_FLOATS + 1], vertices[v * VERTEX_FLOATS + 2]);
+        };
+
+        glm::vec3 meshCentroid(0.0f);
+        float meshArea = 0.0f;
+        struct Cluster { size_t first, last; glm::vec3 centroid, normal; float area; float sortKey; };
+        std::vector<Cluster> clusters(clusterStarts.size());
+        for (size_t c = 0; c < clusters.size(); c++) {
+            Cluster& cluster = clusters[c];
+            cluster.first = clusterStarts[c];
+            cluster.last = c + 1 < clusters.size() ? clusterStarts[c + 1] : triangleCount;
+            cluster.centroid = glm::vec3(0.0f);
+            cluster.normal = glm::vec3(0.0f);
+            cluster.area = 0.0f;
+            for (size_t t = cluster.first; t < cluster.last; t++) {
+                glm::vec3 p0 = position(indices[t * 3]);
+                glm::vec3 p1 = position(indices[t * 3 + 1]);
+                glm::vec3 p2 = position(indices[t * 3 + 2]);
+                glm::vec3 n = glm::cross(p1 - p0, p2 - p0);     // Length = twice the area
+                float area = glm::length(n) * 0.5f;
+                cluster.centroid += (p0 + p1 + p2) * (area / 3.0f);
+                cluster.normal += n;
+                cluster.area += area;
+            }
+            meshCentroid += cluster.centroid;
+            meshArea += cluster.area;
+            if (cluster.area > 0.0f) cluster.centroid /= cluster.area;
+            float normalLength = glm::length(cluster.normal);
+            if (normalLength > 0.0f) cluster.normal /= normalLength;
+        }
+        if (meshArea > 0.0f) meshCentroid /= meshArea;
+
+        for (Cluster& cluster : clusters) cluster.sortKey = glm::dot(cluster.centroid - meshCentroid, cluster.normal);
+        std::stable_sort(clusters.begin(), clusters.end(),
+            [](const Cluster& a, const Cluster& b) { return a.sortKey > b.sortKey; });
+
+        std::vector<unsigned int> sorted;
+        sorted.reserve(indices.size());
+        for (const Cluster& cluster : clusters) {
+            sorted.insert(sorted.end(), indices.begin() + cluster.first * 3, indices.begin() + cluster.last * 3);
+        }
+        indices.swap(sorted);
+    }
+
+    // Vertices in first-use order, so the index stream walks the vertex buffer forward
+    static void optimizeVertexFetch(std::vector<float>& vertices, std::vector<unsigned int>& indices) {
+        size_t vertexCount = vertices.size() / VERTEX_FLOATS;
+        const unsigned int unused = static_cast<unsigned int>(-1);
+        std::vector<unsigned int> remap(vertexCount, unused);
+        std::vector<float> ordered;
+        ordered.reserve(vertices.size());
+        for (unsigned int& index : indices) {
+            if (remap[index] == unused) {
+                remap[index] = static_cast<unsigned int>(ordered.size() / VERTEX_FLOATS);
+                ordered.insert(ordered.end(), vertices.begin() + index * VERTEX_FLOATS,
+                    vertices.begin() + (index + 1) * VERTEX_FLOATS);
+            }
+            index = remap[index];
+        }
+        vertices.swap(ordered);      // Vertices no triangle uses are dropped
+    }
+
+    // Full pass for one part: weld, cache order, overdraw order, fetch order
+    static void optimize(std::vector<float>& vertices, std::vector<unsigned int>& indices) {
+        weldVertices(vertices, indices);
+        std::vector<size_t> clusterStarts;
+        optimizeVertexCache(indices, vertices.size() / VERTEX_FLOATS, &clusterStarts);
+        optimizeOverdraw(indices, vertices, clusterStarts);
+        optimizeVertexFetch(vertices, indices);
+    }
+};
+
+#endif
@@ -0,0 +1,368 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "ws2_32.lib")
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// ==================== MetricsRegistry Class ====================
+// Counters, gauges and histograms for external monitoring, exported in the
+// Prometheus text format. Metrics are registered once at startup (under a
+// lock) and live as long as the registry; recording is a relaxed atomic
+// update, so the render thread and job workers never wait on the exporter.
+// Metrics sharing a name (one per label set) must be registered one after
+// another so the export groups them under one HELP/TYPE header.
+class MetricsRegistry {
+public:
+    class Counter {
+    private:
+        std::atomic<uint64_t> value;
+
+    public:
+        Counter() : value(0) {}
+        void add(uint64_t amount = 1) { value.fetch_add(amount, std::memory_order_relaxed); }
+        // For totals already kept elsewhere; must never go down
+        void setTotal(uint64_t total) { value.store(total, std::memory_order_relaxed); }
+        uint64_t get() const { return value.load(std::memory_order_relaxed); }
+    };
+
+    class Gauge {
+    private:
+        std::atomic<double> value;
+
+    public:
+        Gauge() : value(0.0) {}
+        void set(double v) { value.store(v, std::memory_order_relaxed); }
+        double get() const { return value.load(std::memory_order_relaxed); }
+    };
+
+    // Fixed upper bounds, ascending; observations above the last land in +Inf
+    class Histogram {
+    private:
+        std::vector<double> bounds;
+        std::unique_ptr<std::atomic<uint64_t>[]> buckets;   // Not cumulative; summed on export
+        std::atomic<uint64_t> count;
+        std::atomic<double> sum;
+
+    public:
+        explicit Histogram(const std::vector<double>& upperBounds)
+            : bounds(upperBounds), buckets(new std::atomic<uint64_t>[upperBounds.size() + 1]), count(0), sum(0.0) {
+            for (size_t i = 0; i <= bounds.size(); i++) buckets[i].store(0);
+        }
+
+        void observe(double v) {
+            size_t bucket = 0;
+            while (bucket < bounds.size() && v > bounds[bucket]) bucket++;
+            buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+            count.fetch_add(1, std::memory_order_relaxed);
+            double expected = sum.load(std::memory_order_relaxed);
+            while (!sum.compare_exchange_weak(expected, expected + v, std::memory_order_relaxed)) {}
+        }
+
+        size_t getBucketCount() const { return bounds.size() + 1; }
+        double getBound(size_t i) const { return bounds[i]; }
+        uint64_t getBucket(size_t i) const { return buckets[i].load(std::memory_order_relaxed); }
+        uint64_t getCount() const { return count.load(std::memory_order_relaxed); }
+        double getSum() const { return sum.load(std::memory_order_relaxed); }
+    };
+
+private:
+    enum Type { TYPE_COUNTER, TYPE_GAUGE, TYPE_HISTOGRAM };
+
+    struct Entry {
+        Type type;
+        std::string name;
+        std::string help;
+        std::string labels;      // 'key="value",...' without braces, may be empty
+        const void* metric;
+    };
+
+    std::deque<Counter> counters;        // Deques: registering never moves a metric
+    std::deque<Gauge> gauges;
+    std::deque<Histogram> histograms;
+    std::vector<Entry> entries;          // Registration order
+    mutable std::mutex mutex;
+
+    static const char* typeName(Type type) {
+        static const char* names[] = { "counter", "gauge", "histogram" };
+        return names[type];
+    }
+
+    static std::string labelSet(const std::string& labels, const std::string& extra = std::string()) {
+        if (labels.empty() && extra.empty()) return std::string();
+        if (labels.empty()) return "{" + extra + "}";
+        if (extra.empty()) return "{" + labels + "}";
+        return "{" + labels + "," + extra + "}";
+    }
+
+    void add(Type type, const char* name, const char* help, const char* labels, const void* metric) {
+        entries.push_back(Entry{ type, name, help, labels, metric });
+    }
+
+public:
+    MetricsRegistry() = default;
+    MetricsRegistry(const MetricsRegistry&) = delete;
+    MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+
+    Counter& counter(const char* name, const char* help, const char* labels = "") {
+        std::lock_guard<std::mutex> lock(mutex);
+        counters.emplace_back();
+        add(TYPE_COUNTER, name, help, labels, &counters.back());
+        return counters.back();
+    }
+
+    Gauge& gauge(const char* name, const char* help, const char* labels = "") {
+        std::lock_guard<std::mutex> lock(mutex);
+        gauges.emplace_back();
+        add(TYPE_GAUGE, name, help, labels, &gauges.back());
+        return gauges.back();
+    }
+
+    Histogram& histogram(const char* name, const char* help, const std::vector<double>& upperBounds, const char* labels = "") {
+        std::lock_guard<std::mutex> lock(mutex);
+        histograms.emplace_back(upperBounds);
+        add(TYPE_HISTOGRAM, name, help, labels, &histograms.back());
+        return histograms.back();
+    }
+
+    // Prometheus text exposition format 0.0.4
+    std::string format() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::ostringstream out;
+        out << std::setprecision(10);
+        const std::string* previousName = nullptr;
+        for (const Entry& entry : entries) {
+            if (!previousName || *previousName != entry.name) {
+                out << "# HELP " << entry.name << " " << entry.help << "\n";
+                out << "# TYPE " << entry.name << " " << typeName(entry.type) << "\n";
+            }
+            previousName = &entry.name;
+
+            if (entry.type == TYPE_COUNTER) {
+                out << entry.name << labelSet(entry.labels) << " " << static_cast<const Counter*>(entry.metric)->get() << "\n";
+            }
+            else if (entry.type == TYPE_GAUGE) {
+                out << entry.name << labelSet(entry.labels) << " " << static_cast<const Gauge*>(entry.metric)->get() << "\n";
+            }
+            else {
+                const Histogram& histogram = *static_cast<const Histogram*>(entry.metric);
+                // Recording goes on while this reads; the larger total keeps
+                // +Inf and _count equal and never below a finite bucket
+                uint64_t count = histogram.getCount();
+                uint64_t cumulative = 0;
+                for (size_t i = 0; i + 1 < histogram.getBucketCount(); i++) {
+                    cumulative += histogram.getBucket(i);
+                    std::ostringstream bound;
+                    bound << std::setprecision(10) << histogram.getBound(i);
+                    out << entry.name << "_bucket" << labelSet(entry.labels, "le=\"" + bound.str() + "\"") << " " << cumulative << "\n";
+                }
+                cumulative += histogram.getBucket(histogram.getBucketCount() - 1);
+                out << entry.name << "_bucket" << labelSet(entry.labels, "le=\"+Inf\"") << " " << std::max(cumulative, count) << "\n";
+                out << entry.name << "_sum" << labelSet(entry.labels) << " " << histogram.getSum() << "\n";
+                out << entry.name << "_count" << labelSet(entry.labels) << " " << std::max(cumulative, count) << "\n";
+            }
+        }
+        return out.str();
+    }
+};
+
+// ==================== MetricsServer Class ====================
+// Minimal HTTP/1.0 endpoint on 127.0.0.1 serving the registry at /metrics
+// for a local scraping agent. One background thread accepts one connection
+// at a time; formatting only reads atomics, so a scrape never touches the
+// frame. Loopback only: nothing is reachable from the network.
+class MetricsServer {
+private:
+#ifdef _WIN32
+    typedef SOCKET Socket;
+    static const Socket NO_SOCKET = INVALID_SOCKET;
+    static void closeSocket(Socket s) { closesocket(s); }
+#else
+    typedef int Socket;
+    static const Socket NO_SOCKET = -1;
+    static void closeSocket(Socket s) { close(s); }
+#endif
+
+    static const int POLL_MILLISECONDS = 200;    // How quickly stop() is noticed
+    static const int REQUEST_TIMEOUT_MS = 1000;  // A silent client cannot hold the thread
+    static const size_t MAX_REQUEST = 4096;
+
+    const MetricsRegistry& registry;
+    bool networkReady;                           // WSAStartup done (Windows)
+    Socket listenSocket;
+    std::thread thread;
+    std::atomic<bool> stopping;
+    std::atomic<uint64_t> scrapes;
+    int port;
+
+    static void sendAll(Socket client, const std::string& data) {
+#ifdef MSG_NOSIGNAL
+        const int flags = MSG_NOSIGNAL;          // A client that hung up must not raise SIGPIPE
+#else
+        const int flags = 0;
+#endif
+        size_t sent = 0;
+        while (sent < data.size()) {
+            int n = static_cast<int>(send(client, data.data() + sent, static_cast<int>(data.size() - sent), flags));
+            if (n <= 0) return;
+            sent += static_cast<size_t>(n);
+        }
+    }
+
+    void serve(Socket client) {
+#ifdef _WIN32
+        DWORD timeout = REQUEST_TIMEOUT_MS;
+#else
+        timeval timeout = { REQUEST_TIMEOUT_MS / 1000, (REQUEST_TIMEOUT_MS % 1000) * 1000 };
+#endif
+        setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, reinterpret_cast<const char*>(&timeout), sizeof(timeout));
+
+        // The request line is all that matters; read up to the end of the headers
+        std::string request;
+        char buffer[1024];
+        while (request.size() < MAX_REQUEST && request.find("\r\n\r\n") == std::string::npos) {
+            int n = static_cast<int>(recv(client, buffer, sizeof(buffer), 0));
+            if (n <= 0) break;
+            request.append(buffer, static_cast<size_t>(n));
+        }
+
+        std::string status = "200 OK";
+        std::string body;
+        if (request.compare(0, 13, "GET /metrics ") == 0 || request.compare(0, 6, "GET / ") == 0) {
+            body = registry.format();
+            scrapes.fetch_add(1, std::memory_order_relaxed);
+        }
+        else if (request.compare(0, 4, "GET ") == 0) {
+            status = "404 Not Found";
+            body = "Metrics are served at /metrics\n";
+        }
+        else {
+            status = "405 Method Not Allowed";
+        }
+
+        std::ostringstream response;
+        response << "HTTP/1.0 " << status << "\r\n"
+            << "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+            << "Content-Length: " << body.size() << "\r\n"
+            << "Connection: close\r\n\r\n" << body;
+        sendAll(client, response.str());
+    }
+
+    void run() {
+        while (!stopping.load()) {
+            fd_set readable;
+            FD_ZERO(&readable);
+            FD_SET(listenSocket, &readable);
+            timeval timeout = { 0, POLL_MILLISECONDS * 1000 };
+            // The first argument is ignored on Windows
+            int ready = select(static_cast<int>(listenSocket) + 1, &readable, nullptr, nullptr, &timeout);
+            if (ready <= 0) continue;
+
+            Socket client = accept(listenSocket, nullptr, nullptr);
+            if (client == NO_SOCKET) continue;
+            serve(client);
+            closeSocket(client);
+        }
+    }
+
+public:
+    explicit MetricsServer(const MetricsRegistry& metrics)
+        : registry(metrics), networkReady(false), listenSocket(NO_SOCKET), stopping(false), scrapes(0), port(0) {
+    }
+
+    ~MetricsServer() { stop(); }
+
+    MetricsServer(const MetricsServer&) = delete;
+    MetricsServer& operator=(const MetricsServer&) = delete;
+
+    // Binds 127.0.0.1:listenPort and starts serving; false if the port is taken
+    bool start(int listenPort) {
+        if (thread.joinable()) return true;
+#ifdef _WIN32
+        WSADATA wsaData;
+        if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
+            std::cerr << "ERROR::METRICS::WINSOCK_INIT_FAILED" << std::endl;
+            return false;
+        }
+#endif
+        networkReady = true;
+        listenSocket = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+        if (listenSocket == NO_SOCKET) {
+            std::cerr << "ERROR::METRICS::SOCKET_FAILED" << std::endl;
+            stop();
+            return false;
+        }
+#ifndef _WIN32
+        // Restarting the app must not wait for the old socket's TIME_WAIT
+        int reuse = 1;
+        setsockopt(listenSocket, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+#endif
+
+        sockaddr_in address;
+        std::memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = htons(static_cast<unsigned short>(listenPort));
+        if (bind(listenSocket, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 ||
+            listen(listenSocket, 4) != 0) {
+            std::cerr << "ERROR::METRICS::BIND_FAILED\n127.0.0.1:" << listenPort << std::endl;
+            stop();
+            return false;
+        }
+
+        port = listenPort;
+        stopping.store(false);
+        thread = std::thread(&MetricsServer::run, this);
+        std::cout << "Metrics: http://127.0.0.1:" << port << "/metrics" << std::endl;
+        return true;
+    }
+
+    void stop() {
+        stopping.store(true);
+        if (thread.joinable()) thread.join();
+        if (listenSocket != NO_SOCKET) closeSocket(listenSocket);
+        listenSocket = NO_SOCKET;
+#ifdef _WIN32
+        if (networkReady) WSACleanup();
+#endif
+        networkReady = false;
+    }
+
+    bool isRunning() const { return thread.joinable(); }
+    int getPort() const { return port; }
+
+    void printInfo() const {
+        if (!isRunning()) return;
+        std::cout << "Metrics: 127.0.0.1:" << port << ", " << scrapes.load() << " scrapes served" << std::endl;
+    }
+};
+
+#endif
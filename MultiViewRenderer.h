@@ -0,0 +1,197 @@
+#ifndef MULTIVIEWRENDERER_H
+#define MULTIVIEWRENDERER_H
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// ==================== MultiViewRenderer Class ====================
+// Several cameras side by side in one frame. The scene is submitted once;
+// each packet is frustum-tested against every view and tagged with a view
+// mask. With GL_ARB_viewport_array a geometry shader replicates each draw
+// into all of its views (one draw call per packet for the whole layout),
+// otherwise the list is replayed per viewport, skipping untagged packets.
+class MultiViewRenderer {
+public:
+    static const int MAX_VIEWS = 4;    // Matches MAX_VIEWS in geometry_multiview.glsl
+
+    struct View {
+        glm::mat4 view;
+        glm::mat4 projection;
+        glm::vec3 eye;
+        int x, y, width, height;       // Viewport in framebuffer pixels
+        glm::vec4 planes[6];           // World-space frustum planes, normals inward
+    };
+
+private:
+    typedef void (APIENTRYP ViewportIndexedfProc)(GLuint index, GLfloat x, GLfloat y, GLfloat w, GLfloat h);
+
+    std::vector<View> views;
+    ShaderProgram viewArrayShader;
+    ViewportIndexedfProc viewportIndexedf;
+    bool viewArraySupported;
+
+    int lastDrawCalls;
+    int lastPacketViews;               // Sum over packets of views they appear in
+    int lastPacketCount;
+
+    static void extractPlanes(View& v) {
+        glm::mat4 m = v.projection * v.view;
+        glm::vec4 rows[4];
+        for (int i = 0; i < 4; i++) rows[i] = glm::vec4(m[0][i], m[1][i], m[2][i], m[3][i]);
+
+        v.planes[0] = rows[3] + rows[0];
+        v.planes[1] = rows[3] - rows[0];
+        v.planes[2] = rows[3] + rows[1];
+        v.planes[3] = rows[3] - rows[1];
+        v.planes[4] = rows[3] + rows[2];
+        v.planes[5] = rows[3] - rows[2];
+        for (auto& plane : v.planes) {
+            plane /= glm::length(glm::vec3(plane));
+        }
+    }
+
+    static bool sphereVisible(const View& v, const glm::vec3& center, float radius) {
+        for (const auto& plane : v.planes) {
+            if (glm::dot(glm::vec3(plane), center) + plane.w < -radius) return false;
+        }
+        return true;
+    }
+
+    // Box of the packet (unit-cube local space scaled by halfExtent) contains the eye
+    static bool enclosesEye(const DrawPacket& packet, const glm::vec3& eye) {
+        glm::vec3 local = glm::vec3(glm::inverse(packet.model) * glm::vec4(eye, 1.0f));
+        glm::vec3 d = glm::abs(local);
+        return d.x < packet.halfExtent.x && d.y < packet.halfExtent.y && d.z < packet.halfExtent.z;
+    }
+
+public:
+    MultiViewRenderer()
+        : viewportIndexedf(nullptr), viewArraySupported(false),
+        lastDrawCalls(0), lastPacketViews(0), lastPacketCount(0) {
+    }
+
+    // The viewport-array path is optional; without it every view is a separate pass
+    void setup() {
+        if (glfwExtensionSupported("GL_ARB_viewport_array")) {
+            viewportIndexedf = reinterpret_cast<ViewportIndexedfProc>(glfwGetProcAddress("glViewportIndexedf"));
+        }
+        viewArraySupported = viewportIndexedf != nullptr &&
+            viewArrayShader.create("vertex_multiview.glsl", "fragment.glsl", "geometry_multiview.glsl");
+
+        std::cout << "Multi-view: " << (viewArraySupported ? "viewport array (single pass)" : "per-view passes")
+            << std::endl;
+    }
+
+    void clearViews() {
+        views.clear();
+    }
+
+    // Returns the view's index, or -1 when MAX_VIEWS are already in use
+    int addView(const glm::mat4& view, const glm::mat4& projection, const glm::vec3& eye,
+        int x, int y, int width, int height) {
+        if (static_cast<int>(views.size()) >= MAX_VIEWS) return -1;
+
+        View v;
+        v.view = view;
+        v.projection = projection;
+        v.eye = eye;
+        v.x = x;
+        v.y = y;
+        v.width = width;
+        v.height = height;
+        extractPlanes(v);
+        views.push_back(v);
+        return static_cast<int>(views.size()) - 1;
+    }
+
+    const View& getView(int index) const { return views[index]; }
+    int getViewCount() const { return static_cast<int>(views.size()); }
+    unsigned int allViews() const { return (1u << views.size()) - 1u; }
+
+    // Shared culling for every view in one pass over the list. A packet keeps
+    // the bits of the allowed views whose frustum its bounding sphere touches;
+    // a box enclosing a view's eye (the bus shell seen from inside) is dropped
+    // for that view.
+    void cull(DrawList& list, unsigned int allowedViews) const {
+        list.assignViewMasks([this, allowedViews](const DrawPacket& packet) {
+            glm::vec3 center(packet.model[3]);
+            glm::vec3 e = packet.halfExtent;
+            float radius = std::sqrt(
+                glm::dot(glm::vec3(packet.model[0]), glm::vec3(packet.model[0])) * e.x * e.x +
+                glm::dot(glm::vec3(packet.model[1]), glm::vec3(packet.model[1])) * e.y * e.y +
+                glm::dot(glm::vec3(packet.model[2]), glm::vec3(packet.model[2])) * e.z * e.z);
+
+            unsigned int mask = 0;
+            for (size_t i = 0; i < views.size(); i++) {
+                unsigned int bit = 1u << i;
+                if (!(allowedViews & bit)) continue;
+                if (!sphereVisible(views[i], center, radius)) continue;
+                if (glm::length(views[i].eye - center) < radius && enclosesEye(packet, views[i].eye)) continue;
+                mask |= bit;
+            }
+            return mask;
+            });
+    }
+
+    // Draws the culled list into every view; leaves the full-framebuffer viewport set
+    void render(const DrawList& list, const ShaderProgram& shader, int fbWidth, int fbHeight, bool preferViewArray) {
+        lastDrawCalls = 0;
+        lastPacketViews = 0;
+        lastPacketCount = static_cast<int>(list.size());
+        list.forEachPacket([this](const DrawPacket& packet) {
+            for (unsigned int mask = packet.viewMask & allViews(); mask; mask &= mask - 1) lastPacketViews++;
+            });
+
+        if (viewArraySupported && preferViewArray) {
+            viewArrayShader.use();
+            for (size_t i = 0; i < views.size(); i++) {
+                std::string name = "viewProjections[" + std::to_string(i) + "]";
+                viewArrayShader.setMat4(name.c_str(), views[i].projection * views[i].view);
+                viewportIndexedf(static_cast<GLuint>(i), static_cast<float>(views[i].x), static_cast<float>(views[i].y),
+                    static_cast<float>(views[i].width), static_cast<float>(views[i].height));
+            }
+            viewArrayShader.setInt("viewCount", static_cast<int>(views.size()));
+            list.executeViewMasked(viewArrayShader);
+            list.forEachPacket([this](const DrawPacket& packet) {
+                if (packet.viewMask & allViews()) lastDrawCalls++;
+                });
+            shader.use();
+        }
+        else {
+            shader.use();
+            for (size_t i = 0; i < views.size(); i++) {
+                glViewport(views[i].x, views[i].y, views[i].width, views[i].height);
+                shader.setMat4("view", views[i].view);
+                shader.setMat4("projection", views[i].projection);
+                list.executeView(shader, 1u << i);
+            }
+            lastDrawCalls = lastPacketViews;
+        }
+
+        glViewport(0, 0, fbWidth, fbHeight);
+    }
+
+    bool isViewArraySupported() const { return viewArraySupported; }
+
+    // Last render(): packet-view pairs the frustum test dropped, out of every pair
+    int getCulledPacketViews() const { return getPacketViewCandidates() - lastPacketViews; }
+    int getPacketViewCandidates() const { return lastPacketCount * static_cast<int>(views.size()); }
+
+    void printInfo() const {
+        std::cout << "Multi-view: " << views.size() << " views, " << lastDrawCalls << " draw calls for "
+            << lastPacketViews << " packet-views" << std::endl;
+    }
+
+    void cleanup() {
+        if (viewArraySupported) viewArrayShader.cleanup();
+    }
+};
+
+#endif
@@ -0,0 +1,143 @@
+#ifndef OCCLUSIONCULLER_H
+#define OCCLUSIONCULLER_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <iostream>
+#include <vector>
+
+// ==================== OcclusionCuller Class ====================
+// Hardware occlusion queries against cheap proxy boxes. Each proxy owns two
+// query objects used in ping-pong fashion: the queries issued in frame N drive
+// conditional rendering in frame N+1, so the CPU never waits on the GPU.
+class OcclusionCuller {
+private:
+    struct Proxy {
+        glm::vec3 center;
+        glm::vec3 size;
+        unsigned int queries[2];
+        bool issued[2];      // Query was issued in this slot (false = draw unconditionally)
+    };
+
+    std::vector<Proxy> proxies;
+    Cube proxyBox;           // Unit cube, scaled to each proxy at draw time
+    int frameSlot;           // Slot receiving this frame's queries
+    bool enabled;
+
+    int previousSlot() const { return 1 - frameSlot; }
+
+    // Camera inside (or right at the surface of) a proxy would clip its faces
+    // against the near plane, so such proxies are always treated as visible
+    bool containsPoint(const Proxy& proxy, const glm::vec3& point) const {
+        glm::vec3 halfSize = proxy.size * 0.5f + glm::vec3(0.15f);
+        glm::vec3 d = point - proxy.center;
+        return d.x > -halfSize.x && d.x < halfSize.x &&
+            d.y > -halfSize.y && d.y < halfSize.y &&
+            d.z > -halfSize.z && d.z < halfSize.z;
+    }
+
+public:
+    OcclusionCuller()
+        : proxyBox(glm::vec3(0.0f), glm::vec3(1.0f), glm::vec3(0.0f)),
+        frameSlot(0), enabled(true) {
+    }
+
+    // Registers a proxy box in model space, returns its id
+    int addProxy(const glm::vec3& minCorner, const glm::vec3& maxCorner) {
+        Proxy proxy;
+        proxy.center = (minCorner + maxCorner) * 0.5f;
+        proxy.size = maxCorner - minCorner;
+        proxy.queries[0] = proxy.queries[1] = 0;
+        proxy.issued[0] = proxy.issued[1] = false;
+        proxies.push_back(proxy);
+        return static_cast<int>(proxies.size()) - 1;
+    }
+
+    void setup() {
+        proxyBox.setup();
+        for (auto& proxy : proxies) {
+            glGenQueries(2, proxy.queries);
+        }
+    }
+
+    // Query holding last frame's result for a proxy, for conditional
+    // rendering of its group (0 = no result, draw unconditionally)
+    unsigned int getConditionQuery(int id) const {
+        if (!enabled || id < 0) return 0;
+        const Proxy& proxy = proxies[id];
+        return proxy.issued[previousSlot()] ? proxy.queries[previousSlot()] : 0;
+    }
+
+    // Issue this frame's queries; call after all occluders have been drawn
+    void issueQueries(const ShaderProgram& shader, const glm::mat4& baseModel, const glm::vec3& localEye) {
+        if (!enabled) return;
+
+        glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+        glDepthMask(GL_FALSE);
+
+        for (auto& proxy : proxies) {
+            if (containsPoint(proxy, localEye)) {
+                proxy.issued[frameSlot] = false;
+                continue;
+            }
+
+            glm::mat4 model = glm::translate(baseModel, proxy.center);
+            model = glm::scale(model, proxy.size);
+
+            glBeginQuery(GL_ANY_SAMPLES_PASSED, proxy.queries[frameSlot]);
+            proxyBox.draw(shader, model);
+            glEndQuery(GL_ANY_SAMPLES_PASSED);
+            proxy.issued[frameSlot] = true;
+        }
+
+        glDepthMask(GL_TRUE);
+        glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+    }
+
+    void endFrame() {
+        frameSlot = previousSlot();
+    }
+
+    // Number of proxies whose last finished query reported no samples.
+    // Only reads results that are already available, so it never stalls.
+    int countOccluded() const {
+        int occluded = 0;
+        for (const auto& proxy : proxies) {
+            if (!proxy.issued[previousSlot()]) continue;
+
+            GLuint available = 0;
+            glGetQueryObjectuiv(proxy.queries[previousSlot()], GL_QUERY_RESULT_AVAILABLE, &available);
+            if (!available) continue;
+
+            GLuint anySamples = 1;
+            glGetQueryObjectuiv(proxy.queries[previousSlot()], GL_QUERY_RESULT, &anySamples);
+            if (!anySamples) occluded++;
+        }
+        return occluded;
+    }
+
+    int getProxyCount() const { return static_cast<int>(proxies.size()); }
+
+    void setEnabled(bool value) {
+        enabled = value;
+        // Results from before the toggle are stale
+        for (auto& proxy : proxies) {
+            proxy.issued[0] = proxy.issued[1] = false;
+        }
+    }
+
+    bool isEnabled() const { return enabled; }
+
+    void cleanup() {
+        proxyBox.cleanup();
+        for (auto& proxy : proxies) {
+            glDeleteQueries(2, proxy.queries);
+            proxy.queries[0] = proxy.queries[1] = 0;
+            proxy.issued[0] = proxy.issued[1] = false;
+        }
+    }
+};
+
+#endif
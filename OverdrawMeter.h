@@ -0,0 +1,100 @@
+#ifndef OVERDRAWMETER_H
+#define OVERDRAWMETER_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <iostream>
+#include <vector>
+
+// ==================== OverdrawMeter Class ====================
+// Debug pass that replays the frame's draw list into a counter target
+// (+1 per fragment, additive blending) and reports fragments per pixel.
+// The counter is R32F: integer attachments do not support blending in GL, and
+// a float counts exactly far beyond any realistic overdraw. The render graph
+// owns the target (R32F color + depth), so it is only allocated while measuring.
+// Reads the counter back every measured frame, so it is a debug-only stall.
+class OverdrawMeter {
+private:
+    ShaderProgram shader;
+
+    std::vector<float> counts;
+    double overdrawSum;
+    float maxOverdraw;
+    int measuredFrames;
+    static const int REPORT_INTERVAL = 60;
+
+    void readCounts(unsigned int countTexture, int width, int height) {
+        counts.resize(static_cast<size_t>(width) * height);
+        glBindTexture(GL_TEXTURE_2D, countTexture);
+        glGetTexImage(GL_TEXTURE_2D, 0, GL_RED, GL_FLOAT, counts.data());
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+
+public:
+    OverdrawMeter()
+        : overdrawSum(0.0), maxOverdraw(0.0f), measuredFrames(0) {
+    }
+
+    bool setup() {
+        return shader.create("vertex.glsl", "overdraw.glsl");
+    }
+
+    void reset() {
+        overdrawSum = 0.0;
+        maxOverdraw = 0.0f;
+        measuredFrames = 0;
+    }
+
+    // Replays the frame the same way the main pass drew it, into the bound
+    // counter target
+    void render(const DrawList& drawList, const glm::mat4& view, const glm::mat4& projection, bool depthPrepass) {
+        glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        shader.use();
+        shader.setMat4("view", view);
+        shader.setMat4("projection", projection);
+
+        // Blending does not affect the color-masked prepass
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_ONE, GL_ONE);
+        drawList.render(shader, depthPrepass);
+        glDisable(GL_BLEND);
+    }
+
+    // Reads the counter written by render() and reports every REPORT_INTERVAL frames
+    void accumulate(unsigned int countTexture, int width, int height) {
+        if (countTexture == 0 || width <= 0 || height <= 0) return;
+        readCounts(countTexture, width, height);
+
+        double fragments = 0.0;
+        size_t covered = 0;
+        float frameMax = 0.0f;
+        for (float c : counts) {
+            if (c <= 0.0f) continue;
+            fragments += c;
+            covered++;
+            if (c > frameMax) frameMax = c;
+        }
+
+        if (covered > 0) overdrawSum += fragments / covered;
+        if (frameMax > maxOverdraw) maxOverdraw = frameMax;
+        measuredFrames++;
+
+        if (measuredFrames >= REPORT_INTERVAL) {
+            std::cout << "Overdraw: " << (overdrawSum / measuredFrames)
+                << " fragments/covered pixel (max " << maxOverdraw << ", "
+                << (100.0 * covered / counts.size()) << "% coverage)" << std::endl;
+            overdrawSum = 0.0;
+            maxOverdraw = 0.0f;
+            measuredFrames = 0;
+        }
+    }
+
+    void cleanup() {
+        shader.cleanup();
+    }
+};
+
+#endif
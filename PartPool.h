@@ -0,0 +1,213 @@
+#ifndef PARTPOOL_H
+#define PARTPOOL_H
+
+#include <cstdint>
+#include <iostream>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+// ==================== PartHandle Struct ====================
+// Names one part in a PartPool. The generation is the pool's creation count
+// when the part was made, so the handle of a destroyed part never becomes
+// valid again, even once its slot (or the pool's whole memory) is reused.
+struct PartHandle {
+    uint32_t index;
+    uint32_t generation;     // 0 = no part
+
+    PartHandle() : index(0), generation(0) {}
+    PartHandle(uint32_t i, uint32_t g) : index(i), generation(g) {}
+
+    bool isValid() const { return generation != 0; }
+    bool operator==(const PartHandle& other) const { return index == other.index && generation == other.generation; }
+    bool operator!=(const PartHandle& other) const { return !(*this == other); }
+};
+
+// ==================== PartPool Class ====================
+// Fixed-address storage for one kind of part, carved from an Arena in chunks
+// of contiguous slots. Destroyed slots are reused first; get() returns
+// nullptr for a stale handle. Parts are constructed with 'partBuffers' as
+// their last argument, the arena their own buffers (CPU geometry) go to.
+// clear() forgets the chunks, so it must come before the arena's reset().
+template <typename T>
+class PartPool {
+private:
+    struct Slot {
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+        uint32_t generation;     // 0 = free
+        uint32_t nextFree;
+    };
+
+    static const uint32_t MAX_CHUNKS = 32;
+    static const uint32_t NO_SLOT = 0xFFFFFFFFu;
+
+    Arena& arena;
+    Arena* partBuffers;
+    Slot* chunks[MAX_CHUNKS];
+    uint32_t chunkShift;         // Slots per chunk = 1 << chunkShift
+    uint32_t chunkCount;
+    uint32_t slotCount;          // Slots ever handed out since clear()
+    uint32_t freeHead;
+    uint32_t liveCount;
+    uint32_t creations;
+
+    Slot& slotAt(uint32_t index) const {
+        return chunks[index >> chunkShift][index & ((1u << chunkShift) - 1)];
+    }
+
+    void addChunk() {
+        if (chunkCount == MAX_CHUNKS) {
+            std::cerr << "ERROR::PARTPOOL::FULL\n" << (MAX_CHUNKS << chunkShift) << " parts" << std::endl;
+            throw std::length_error("part pool full");
+        }
+        chunks[chunkCount++] = arena.allocateArray<Slot>(size_t(1) << chunkShift);
+    }
+
+public:
+    // 'slotsPerChunk' is rounded up to a power of two; size it so one chunk
+    // holds a typical model and its parts stay in one block
+    PartPool(Arena& storage, uint32_t slotsPerChunk, Arena* buffers = nullptr)
+        : arena(storage), partBuffers(buffers), chunkShift(0), chunkCount(0), slotCount(0),
+        freeHead(NO_SLOT), liveCount(0), creations(0) {
+        while ((1u << chunkShift) < slotsPerChunk) chunkShift++;
+    }
+
+    ~PartPool() { clear(); }
+
+    PartPool(const PartPool&) = delete;
+    PartPool& operator=(const PartPool&) = delete;
+
+    template <typename... Args>
+    PartHandle create(Args&&... args) {
+        uint32_t index;
+        if (freeHead != NO_SLOT) {
+            index = freeHead;
+            freeHead = slotAt(index).nextFree;
+        }
+        else {
+            if (slotCount == (chunkCount << chunkShift)) addChunk();
+            index = slotCount++;
+        }
+
+        Slot& slot = slotAt(index);
+        new (&slot.storage) T(std::forward<Args>(args)..., partBuffers);
+        if (++creations == 0) creations = 1;
+        slot.generation = creations;
+        liveCount++;
+        return PartHandle(index, slot.generation);
+    }
+
+    // False if the handle was already stale
+    bool destroy(PartHandle handle) {
+        T* part = get(handle);
+        if (!part) return false;
+        part->~T();
+        Slot& slot = slotAt(handle.index);
+        slot.generation = 0;
+        slot.nextFree = freeHead;
+        freeHead = handle.index;
+        liveCount--;
+        return true;
+    }
+
+    T* get(PartHandle handle) {
+        if (!handle.isValid() || handle.index >= slotCount) return nullptr;
+        Slot& slot = slotAt(handle.index);
+        return slot.generation == handle.generation ? reinterpret_cast<T*>(&slot.storage) : nullptr;
+    }
+
+    const T* get(PartHandle handle) const {
+        return const_cast<PartPool*>(this)->get(handle);
+    }
+
+    // Destroys every part; the chunk memory goes back with the arena's reset()
+    void clear() {
+        for (uint32_t i = 0; i < slotCount; i++) {
+            Slot& slot = slotAt(i);
+            if (slot.generation == 0) continue;
+            reinterpret_cast<T*>(&slot.storage)->~T();
+            slot.generation = 0;
+        }
+        chunkCount = 0;
+        slotCount = 0;
+        freeHead = NO_SLOT;
+        liveCount = 0;
+    }
+
+    size_t size() const { return liveCount; }
+    size_t capacity() const { return size_t(chunkCount) << chunkShift; }
+    Arena& getArena() const { return arena; }
+};
+
+// ==================== PartList Class ====================
+// Ordered group of parts in a PartPool (a bus's body, one door, ...), used
+// like a vector of parts. Only the handles live here, in the pool's arena,
+// so several groups share one pool and all their parts stay contiguous.
+template <typename T>
+class PartList {
+private:
+    template <typename Pool, typename Value>
+    class Iterator {
+    private:
+        Pool* pool;
+        const PartHandle* handle;
+
+    public:
+        Iterator(Pool* p, const PartHandle* h) : pool(p), handle(h) {}
+        Value& operator*() const { return *pool->get(*handle); }
+        Value* operator->() const { return pool->get(*handle); }
+        Iterator& operator++() { ++handle; return *this; }
+        bool operator==(const Iterator& other) const { return handle == other.handle; }
+        bool operator!=(const Iterator& other) const { return handle != other.handle; }
+    };
+
+    PartPool<T>* pool;
+    ArenaVector<PartHandle> handles;
+
+public:
+    typedef Iterator<PartPool<T>, T> iterator;
+    typedef Iterator<const PartPool<T>, const T> const_iterator;
+
+    explicit PartList(PartPool<T>& parts) : pool(&parts), handles(ArenaAllocator<PartHandle>(&parts.getArena())) {}
+
+    PartList(const PartList&) = delete;
+    PartList& operator=(const PartList&) = delete;
+
+    template <typename... Args>
+    T& emplace_back(Args&&... args) {
+        PartHandle handle = pool->create(std::forward<Args>(args)...);
+        handles.push_back(handle);
+        return *pool->get(handle);
+    }
+
+    // Destroys the parts; the handle storage is kept for refilling
+    void clear() {
+        for (PartHandle handle : handles) pool->destroy(handle);
+        handles.clear();
+    }
+
+    // clear() and hands the handle storage back, before the arena's reset()
+    void release() {
+        clear();
+        ArenaVector<PartHandle>(handles.get_allocator()).swap(handles);
+    }
+
+    void reserve(size_t count) { handles.reserve(count); }
+
+    size_t size() const { return handles.size(); }
+    bool empty() const { return handles.empty(); }
+    PartHandle handleAt(size_t i) const { return handles[i]; }
+
+    T& operator[](size_t i) { return *pool->get(handles[i]); }
+    const T& operator[](size_t i) const { return *pool->get(handles[i]); }
+    T& front() { return (*this)[0]; }
+    const T& front() const { return (*this)[0]; }
+
+    iterator begin() { return iterator(pool, handles.data()); }
+    iterator end() { return iterator(pool, handles.data() + handles.size()); }
+    const_iterator begin() const { return const_iterator(pool, handles.data()); }
+    const_iterator end() const { return const_iterator(pool, handles.data() + handles.size()); }
+};
+
+#endif
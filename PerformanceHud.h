@@ -0,0 +1,330 @@
+#ifndef PERFORMANCEHUD_H
+#define PERFORMANCEHUD_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+// ==================== PerformanceHud Class ====================
+// In-window overlay: a rolling frame-time graph over a few lines of stats.
+// Text uses a 5x7 bitmap font baked into a small R8 atlas at setup; the
+// panel and the graph bars sample the atlas's solid cell, so the whole
+// overlay is one list of quads streamed into one vertex buffer (orphaned
+// every frame) and drawn with one glDrawElements over a static index buffer.
+// The font has no lowercase: letters are drawn as capitals.
+class PerformanceHud {
+private:
+    struct Vertex {
+        float x, y;              // Pixels, top-left origin
+        float u, v;
+        unsigned char r, g, b, a;
+    };
+
+    struct Color {
+        unsigned char r, g, b, a;
+    };
+
+    static const int GLYPH_WIDTH = 5;
+    static const int GLYPH_HEIGHT = 7;
+    static const int FIRST_GLYPH = 32;       // ' '
+    static const int GLYPH_COUNT = 64;       // ' ' to '_'
+    static const int CELL_WIDTH = 6;         // Atlas cell: glyph plus a blank column and row
+    static const int CELL_HEIGHT = 8;
+    static const int ATLAS_COLUMNS = 16;
+    static const int ATLAS_WIDTH = ATLAS_COLUMNS * CELL_WIDTH;
+    static const int ATLAS_HEIGHT = (GLYPH_COUNT / ATLAS_COLUMNS + 1) * CELL_HEIGHT;   // Last row: solid cell
+
+    static const int SCALE = 2;              // Screen pixels per font pixel
+    static const int MARGIN = 10;
+    static const int PADDING = 8;
+    static const int LINE_HEIGHT = (CELL_HEIGHT + 2) * SCALE;
+    static const int GRAPH_HEIGHT = 60;
+    static const int BAR_WIDTH = 2;
+
+    static const int HISTORY_SIZE = 120;     // Frames in the graph
+    static const int MAX_LINES = 12;
+    static const int MAX_LINE_LENGTH = 96;
+    static const int MAX_QUADS = 4096;       // 16-bit indices
+
+    ShaderProgram shader;
+    unsigned int VAO, VBO, EBO, atlas;
+    bool ready;
+    bool visible;
+
+    std::vector<Vertex> vertices;
+    float history[HISTORY_SIZE];             // Frame times in milliseconds, ring
+    int historyHead;
+    int historyCount;
+    char lines[MAX_LINES][MAX_LINE_LENGTH];
+    int lineCount;
+    double lastCpuMs;                        // Building and submitting the previous overlay
+
+    // ' ' to '_', four glyphs per line; rows top to bottom, bit 4 = leftmost pixel
+    static const unsigned char* glyphRows(int glyph) {
+        static const unsigned char rows[GLYPH_COUNT][GLYPH_HEIGHT] = {
+            { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }, { 0x04, 0x04, 0x04, 0x04, 0x04, 0x00, 0x04 }, { 0x0A, 0x0A, 0x0A, 0x00, 0x00, 0x00, 0x00 }, { 0x0A, 0x0A, 0x1F, 0x0A, 0x1F, 0x0A, 0x0A },
+            { 0x04, 0x0F, 0x14, 0x0E, 0x05, 0x1E, 0x04 }, { 0x18, 0x19, 0x02, 0x04, 0x08, 0x13, 0x03 }, { 0x0C, 0x12, 0x14, 0x08, 0x15, 0x12, 0x0D }, { 0x04, 0x04, 0x08, 0x00, 0x00, 0x00, 0x00 },
+            { 0x02, 0x04, 0x08, 0x08, 0x08, 0x04, 0x02 }, { 0x08, 0x04, 0x02, 0x02, 0x02, 0x04, 0x08 }, { 0x00, 0x04, 0x15, 0x0E, 0x15, 0x04, 0x00 }, { 0x00, 0x04, 0x04, 0x1F, 0x04, 0x04, 0x00 },
+            { 0x00, 0x00, 0x00, 0x00, 0x0C, 0x04, 0x08 }, { 0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C }, { 0x00, 0x01, 0x02, 0x04, 0x08, 0x10, 0x00 },
+            { 0x0E, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0E }, { 0x04, 0x0C, 0x04, 0x04, 0x04, 0x04, 0x0E }, { 0x0E, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1F }, { 0x1F, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0E },
+            { 0x02, 0x06, 0x0A, 0x12, 0x1F, 0x02, 0x02 }, { 0x1F, 0x10, 0x1E, 0x01, 0x01, 0x11, 0x0E }, { 0x06, 0x08, 0x10, 0x1E, 0x11, 0x11, 0x0E }, { 0x1F, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08 },
+            { 0x0E, 0x11, 0x11, 0x0E, 0x11, 0x11, 0x0E }, { 0x0E, 0x11, 0x11, 0x0F, 0x01, 0x02, 0x0C }, { 0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x0C, 0x00 }, { 0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x04, 0x08 },
+            { 0x02, 0x04, 0x08, 0x10, 0x08, 0x04, 0x02 }, { 0x00, 0x00, 0x1F, 0x00, 0x1F, 0x00, 0x00 }, { 0x08, 0x04, 0x02, 0x01, 0x02, 0x04, 0x08 }, { 0x0E, 0x11, 0x01, 0x02, 0x04, 0x00, 0x04 },
+            { 0x0E, 0x11, 0x01, 0x0D, 0x15, 0x15, 0x0E }, { 0x0E, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11 }, { 0x1E, 0x11, 0x11, 0x1E, 0x11, 0x11, 0x1E }, { 0x0E, 0x11, 0x10, 0x10, 0x10, 0x11, 0x0E },
+            { 0x1C, 0x12, 0x11, 0x11, 0x11, 0x12, 0x1C }, { 0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x1F }, { 0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x10 }, { 0x0E, 0x11, 0x10, 0x17, 0x11, 0x11, 0x0F },
+            { 0x11, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11 }, { 0x0E, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0E }, { 0x07, 0x02, 0x02, 0x02, 0x02, 0x12, 0x0C }, { 0x11, 0x12, 0x14, 0x18, 0x14, 0x12, 0x11 },
+            { 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1F }, { 0x11, 0x1B, 0x15, 0x15, 0x11, 0x11, 0x11 }, { 0x11, 0x11, 0x19, 0x15, 0x13, 0x11, 0x11 }, { 0x0E, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E },
+            { 0x1E, 0x11, 0x11, 0x1E, 0x10, 0x10, 0x10 }, { 0x0E, 0x11, 0x11, 0x11, 0x15, 0x12, 0x0D }, { 0x1E, 0x11, 0x11, 0x1E, 0x14, 0x12, 0x11 }, { 0x0F, 0x10, 0x10, 0x0E, 0x01, 0x01, 0x1E },
+            { 0x1F, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04 }, { 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E }, { 0x11, 0x11, 0x11, 0x11, 0x11, 0x0A, 0x04 }, { 0x11, 0x11, 0x11, 0x15, 0x15, 0x15, 0x0A },
+            { 0x11, 0x11, 0x0A, 0x04, 0x0A, 0x11, 0x11 }, { 0x11, 0x11, 0x11, 0x0A, 0x04, 0x04, 0x04 }, { 0x1F, 0x01, 0x02, 0x04, 0x08, 0x10, 0x1F }, { 0x0E, 0x08, 0x08, 0x08, 0x08, 0x08, 0x0E },
+            { 0x00, 0x10, 0x08, 0x04, 0x02, 0x01, 0x00 }, { 0x0E, 0x02, 0x02, 0x02, 0x02, 0x02, 0x0E }, { 0x04, 0x0A, 0x11, 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1F }
+        };
+        return rows[glyph];
+    }
+
+    static float atlasU(int x) { return static_cast<float>(x) / ATLAS_WIDTH; }
+    static float atlasV(int y) { return static_cast<float>(y) / ATLAS_HEIGHT; }
+
+    void quad(float x0, float y0, float x1, float y1, float u0, float v0, float u1, float v1, Color c) {
+        if (vertices.size() >= MAX_QUADS * 4) return;
+        vertices.push_back(Vertex{ x0, y0, u0, v0, c.r, c.g, c.b, c.a });
+        vertices.push_back(Vertex{ x1, y0, u1, v0, c.r, c.g, c.b, c.a });
+        vertices.push_back(Vertex{ x1, y1, u1, v1, c.r, c.g, c.b, c.a });
+        vertices.push_back(Vertex{ x0, y1, u0, v1, c.r, c.g, c.b, c.a });
+    }
+
+    // Untextured: every corner samples the middle of the solid cell
+    void solid(float x0, float y0, float x1, float y1, Color c) {
+        float u = atlasU(CELL_WIDTH / 2);
+        float v = atlasV(ATLAS_HEIGHT - CELL_HEIGHT / 2);
+        quad(x0, y0, x1, y1, u, v, u, v, c);
+    }
+
+    void text(float x, float y, const char* str, Color c) {
+        for (; *str; str++, x += CELL_WIDTH * SCALE) {
+            int ch = static_cast<unsigned char>(*str);
+            if (ch >= 'a' && ch <= 'z') ch -= 'a' - 'A';
+            if (ch == ' ') continue;
+            int glyph = ch - FIRST_GLYPH;
+            if (glyph < 0 || glyph >= GLYPH_COUNT) glyph = '?' - FIRST_GLYPH;
+
+            int cellX = (glyph % ATLAS_COLUMNS) * CELL_WIDTH;
+            int cellY = (glyph / ATLAS_COLUMNS) * CELL_HEIGHT;
+            quad(x, y, x + GLYPH_WIDTH * SCALE, y + GLYPH_HEIGHT * SCALE,
+                atlasU(cellX), atlasV(cellY), atlasU(cellX + GLYPH_WIDTH), atlasV(cellY + GLYPH_HEIGHT), c);
+        }
+    }
+
+    bool createAtlas() {
+        std::vector<unsigned char> pixels(ATLAS_WIDTH * ATLAS_HEIGHT, 0);
+        for (int glyph = 0; glyph < GLYPH_COUNT; glyph++) {
+            const unsigned char* rows = glyphRows(glyph);
+            int cellX = (glyph % ATLAS_COLUMNS) * CELL_WIDTH;
+            int cellY = (glyph / ATLAS_COLUMNS) * CELL_HEIGHT;
+            for (int row = 0; row < GLYPH_HEIGHT; row++) {
+                for (int column = 0; column < GLYPH_WIDTH; column++) {
+                    if (rows[row] & (0x10 >> column)) pixels[(cellY + row) * ATLAS_WIDTH + cellX + column] = 255;
+                }
+            }
+        }
+        for (int y = ATLAS_HEIGHT - CELL_HEIGHT; y < ATLAS_HEIGHT; y++) {
+            for (int x = 0; x < CELL_WIDTH; x++) pixels[y * ATLAS_WIDTH + x] = 255;
+        }
+
+        glGenTextures(1, &atlas);
+        glBindTexture(GL_TEXTURE_2D, atlas);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, ATLAS_WIDTH, ATLAS_HEIGHT, 0, GL_RED, GL_UNSIGNED_BYTE, pixels.data());
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        return atlas != 0;
+    }
+
+public:
+    PerformanceHud() : VAO(0), VBO(0), EBO(0), atlas(0), ready(false), visible(false),
+        historyHead(0), historyCount(0), lineCount(0), lastCpuMs(0.0) {
+        for (float& ms : history) ms = 0.0f;
+        vertices.reserve(MAX_QUADS * 4);
+    }
+
+    bool setup() {
+        if (!shader.create("vertex_hud.glsl", "fragment_hud.glsl")) return false;
+        if (!createAtlas()) {
+            std::cerr << "ERROR::HUD::ATLAS_FAILED" << std::endl;
+            return false;
+        }
+
+        // Quads are 4 vertices each; the 6 indices per quad never change
+        std::vector<unsigned short> indices;
+        indices.reserve(MAX_QUADS * 6);
+        for (int q = 0; q < MAX_QUADS; q++) {
+            unsigned short base = static_cast<unsigned short>(q * 4);
+            unsigned short quadIndices[6] = { base, static_cast<unsigned short>(base + 1), static_cast<unsigned short>(base + 2),
+                base, static_cast<unsigned short>(base + 2), static_cast<unsigned short>(base + 3) };
+            indices.insert(indices.end(), quadIndices, quadIndices + 6);
+        }
+
+        glGenVertexArrays(1, &VAO);
+        glGenBuffers(1, &VBO);
+        glGenBuffers(1, &EBO);
+        glBindVertexArray(VAO);
+        glBindBuffer(GL_ARRAY_BUFFER, VBO);
+        glBufferData(GL_ARRAY_BUFFER, MAX_QUADS * 4 * sizeof(Vertex), nullptr, GL_STREAM_DRAW);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned short), indices.data(), GL_STATIC_DRAW);
+
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)(2 * sizeof(float)));
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(Vertex), (void*)(4 * sizeof(float)));
+        glEnableVertexAttribArray(2);
+        glBindVertexArray(0);
+
+        ready = true;
+        return true;
+    }
+
+    void setVisible(bool show) { visible = show; }
+    bool isVisible() const { return visible && ready; }
+
+    // Every frame, shown or not, so the graph is full when it appears
+    void addFrameTime(float milliseconds) {
+        history[historyHead] = milliseconds;
+        historyHead = (historyHead + 1) % HISTORY_SIZE;
+        historyCount = std::min(historyCount + 1, HISTORY_SIZE);
+    }
+
+    // printf-style; lines are collected for the next render()
+    void addLine(const char* format, ...) {
+        if (lineCount == MAX_LINES) return;
+        va_list args;
+        va_start(args, format);
+        std::vsnprintf(lines[lineCount++], MAX_LINE_LENGTH, format, args);
+        va_end(args);
+    }
+
+    // Appends to the last line
+    void extendLine(const char* format, ...) {
+        if (lineCount == 0) return;
+        char* line = lines[lineCount - 1];
+        size_t length = std::strlen(line);
+        va_list args;
+        va_start(args, format);
+        std::vsnprintf(line + length, MAX_LINE_LENGTH - length, format, args);
+        va_end(args);
+    }
+
+    void clearLines() { lineCount = 0; }
+
+    // Fills the quad list (no GL); returns the number of quads
+    size_t build() {
+        vertices.clear();
+
+        float newest = 0.0f, worst = 0.0f, total = 0.0f;
+        for (int i = 0; i < historyCount; i++) {
+            float ms = history[(historyHead - 1 - i + HISTORY_SIZE) % HISTORY_SIZE];
+            if (i == 0) newest = ms;
+            worst = std::max(worst, ms);
+            total += ms;
+        }
+        float average = historyCount ? total / historyCount : 0.0f;
+        char header[MAX_LINE_LENGTH];
+        std::snprintf(header, sizeof(header), "Frame %.2f ms (%.0f fps) max %.2f  hud %.3f ms",
+            newest, average > 0.0f ? 1000.0f / average : 0.0f, worst, lastCpuMs);
+
+        int columns = static_cast<int>(std::strlen(header));
+        for (int i = 0; i < lineCount; i++) columns = std::max(columns, static_cast<int>(std::strlen(lines[i])));
+        float graphWidth = static_cast<float>(HISTORY_SIZE * BAR_WIDTH);
+        float width = std::max(graphWidth, static_cast<float>(columns * CELL_WIDTH * SCALE)) + 2 * PADDING;
+        float height = GRAPH_HEIGHT + (lineCount + 1) * LINE_HEIGHT + 3 * PADDING;
+
+        float x = MARGIN, y = MARGIN;
+        solid(x, y, x + width, y + height, Color{ 0, 0, 0, 160 });
+
+        // Graph: oldest bar on the left; the scale grows past 33 ms only when a frame did
+        float graphTop = y + PADDING;
+        float graphBottom = graphTop + GRAPH_HEIGHT;
+        float range = std::max(100.0f / 3.0f, worst);
+        solid(x + PADDING, graphTop, x + PADDING + graphWidth, graphBottom, Color{ 255, 255, 255, 24 });
+        for (int i = 0; i < historyCount; i++) {
+            float ms = history[(historyHead - historyCount + i + HISTORY_SIZE) % HISTORY_SIZE];
+            float barX = x + PADDING + (HISTORY_SIZE - historyCount + i) * BAR_WIDTH;
+            float barTop = graphBottom - std::min(ms / range, 1.0f) * GRAPH_HEIGHT;
+            Color c = ms <= 1000.0f / 60.0f ? Color{ 80, 220, 80, 255 } :
+                ms <= 1000.0f / 30.0f ? Color{ 240, 200, 60, 255 } : Color{ 240, 70, 60, 255 };
+            solid(barX, barTop, barX + BAR_WIDTH, graphBottom, c);
+        }
+        float budgetY = graphBottom - (1000.0f / 60.0f) / range * GRAPH_HEIGHT;
+        solid(x + PADDING, budgetY, x + PADDING + graphWidth, budgetY + 1.0f, Color{ 255, 255, 255, 140 });
+
+        float textY = graphBottom + PADDING;
+        text(x + PADDING, textY, header, Color{ 255, 255, 255, 255 });
+        for (int i = 0; i < lineCount; i++) {
+            text(x + PADDING, textY + (i + 1) * LINE_HEIGHT, lines[i], Color{ 210, 230, 255, 255 });
+        }
+        return vertices.size() / 4;
+    }
+
+    // One upload and one draw on top of whatever the backbuffer holds; leaves
+    // depth test and back-face culling on, blending off
+    void render(int fbWidth, int fbHeight) {
+        if (!isVisible() || fbWidth <= 0 || fbHeight <= 0) {
+            clearLines();
+            return;
+        }
+        auto start = std::chrono::steady_clock::now();
+
+        size_t quads = build();
+        clearLines();
+
+        shader.use();
+        shader.setMat4("projection", glm::ortho(0.0f, static_cast<float>(fbWidth), static_cast<float>(fbHeight), 0.0f));
+        shader.setInt("atlas", 0);
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, atlas);
+
+        glBindVertexArray(VAO);
+        glBindBuffer(GL_ARRAY_BUFFER, VBO);
+        // Orphan: the driver hands out fresh storage instead of waiting for last frame's draw
+        glBufferData(GL_ARRAY_BUFFER, MAX_QUADS * 4 * sizeof(Vertex), nullptr, GL_STREAM_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, vertices.size() * sizeof(Vertex), vertices.data());
+
+        glDisable(GL_DEPTH_TEST);
+        glDisable(GL_CULL_FACE);
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(quads * 6), GL_UNSIGNED_SHORT, (void*)0);
+        glDisable(GL_BLEND);
+        glEnable(GL_CULL_FACE);
+        glEnable(GL_DEPTH_TEST);
+
+        glBindVertexArray(0);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        lastCpuMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    void cleanup() {
+        if (!ready) return;
+        glDeleteVertexArrays(1, &VAO);
+        glDeleteBuffers(1, &VBO);
+        glDeleteBuffers(1, &EBO);
+        glDeleteTextures(1, &atlas);
+        shader.cleanup();
+        ready = false;
+    }
+};
+
+#endif
@@ -0,0 +1,160 @@
+#ifndef PORTALRENDERER_H
+#define PORTALRENDERER_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <vector>
+
+// ==================== Portal Struct ====================
+// Flat window opening in bus model space. The box is placed just in front of
+// the outermost glass/border layer, so window bars and anything else in front
+// of the window still win the depth test against it.
+struct Portal {
+    glm::vec3 center;
+    glm::vec3 size;          // Zero along the normal axis
+    glm::vec3 normal;        // Points out of the bus
+};
+
+// ==================== PortalRenderer Class ====================
+// Draws the interior only where it is seen through windows: visible portals
+// are unioned into a scissor rectangle, their surfaces are written to the
+// stencil buffer, depth is reset to far inside them, and the interior is drawn
+// with the stencil test on. No visible window means no interior at all.
+class PortalRenderer {
+private:
+    Cube unitBox;
+    std::vector<const Portal*> visiblePortals;
+    int scissorX, scissorY, scissorWidth, scissorHeight;
+
+    // Screen rectangle of one portal, false if it is off screen.
+    // Portals crossing the camera plane conservatively cover the whole screen.
+    bool projectPortal(const Portal& portal, const glm::mat4& modelViewProjection,
+        glm::vec2& ndcMin, glm::vec2& ndcMax) const {
+        ndcMin = glm::vec2(1e9f);
+        ndcMax = glm::vec2(-1e9f);
+
+        for (int i = 0; i < 8; i++) {
+            glm::vec3 corner = portal.center + 0.5f * glm::vec3(
+                (i & 1) ? portal.size.x : -portal.size.x,
+                (i & 2) ? portal.size.y : -portal.size.y,
+                (i & 4) ? portal.size.z : -portal.size.z);
+            glm::vec4 clip = modelViewProjection * glm::vec4(corner, 1.0f);
+
+            if (clip.w <= 1e-4f) {
+                ndcMin = glm::vec2(-1.0f);
+                ndcMax = glm::vec2(1.0f);
+                return true;
+            }
+
+            glm::vec2 ndc(clip.x / clip.w, clip.y / clip.w);
+            ndcMin.x = std::min(ndcMin.x, ndc.x);
+            ndcMin.y = std::min(ndcMin.y, ndc.y);
+            ndcMax.x = std::max(ndcMax.x, ndc.x);
+            ndcMax.y = std::max(ndcMax.y, ndc.y);
+        }
+
+        ndcMin.x = std::max(ndcMin.x, -1.0f);
+        ndcMin.y = std::max(ndcMin.y, -1.0f);
+        ndcMax.x = std::min(ndcMax.x, 1.0f);
+        ndcMax.y = std::min(ndcMax.y, 1.0f);
+        return ndcMin.x < ndcMax.x && ndcMin.y < ndcMax.y;
+    }
+
+    glm::mat4 portalModel(const glm::mat4& baseModel, const Portal& portal) const {
+        glm::mat4 model = glm::translate(baseModel, portal.center);
+        return glm::scale(model, portal.size);
+    }
+
+public:
+    PortalRenderer()
+        : unitBox(glm::vec3(0.0f), glm::vec3(1.0f), glm::vec3(0.0f)),
+        scissorX(0), scissorY(0), scissorWidth(0), scissorHeight(0) {
+    }
+
+    void setup() {
+        unitBox.setup();
+    }
+
+    // Finds the portals facing the camera and on screen.
+    // Returns false when none is visible, so the interior can be skipped.
+    bool prepare(const std::vector<Portal>& portals, const glm::mat4& baseModel,
+        const glm::mat4& viewProjection, const glm::vec3& localEye, int fbWidth, int fbHeight) {
+        visiblePortals.clear();
+        glm::vec2 unionMin(1e9f), unionMax(-1e9f);
+        glm::mat4 modelViewProjection = viewProjection * baseModel;
+
+        for (const auto& portal : portals) {
+            if (glm::dot(localEye - portal.center, portal.normal) <= 0.0f) continue;
+
+            glm::vec2 ndcMin, ndcMax;
+            if (!projectPortal(portal, modelViewProjection, ndcMin, ndcMax)) continue;
+
+            visiblePortals.push_back(&portal);
+            unionMin.x = std::min(unionMin.x, ndcMin.x);
+            unionMin.y = std::min(unionMin.y, ndcMin.y);
+            unionMax.x = std::max(unionMax.x, ndcMax.x);
+            unionMax.y = std::max(unionMax.y, ndcMax.y);
+        }
+
+        if (visiblePortals.empty()) return false;
+
+        scissorX = static_cast<int>((unionMin.x * 0.5f + 0.5f) * fbWidth);
+        scissorY = static_cast<int>((unionMin.y * 0.5f + 0.5f) * fbHeight);
+        scissorWidth = static_cast<int>((unionMax.x * 0.5f + 0.5f) * fbWidth) - scissorX + 1;
+        scissorHeight = static_cast<int>((unionMax.y * 0.5f + 0.5f) * fbHeight) - scissorY + 1;
+        return true;
+    }
+
+    // Marks visible window surfaces in the stencil buffer and pushes their
+    // depth back to the far plane; leaves the stencil test on for the interior
+    void beginInterior(const ShaderProgram& shader, const glm::mat4& baseModel,
+        const glm::mat4& view, const glm::mat4& projection) {
+        glEnable(GL_SCISSOR_TEST);
+        glScissor(scissorX, scissorY, scissorWidth, scissorHeight);
+
+        glEnable(GL_STENCIL_TEST);
+        glStencilMask(0xFF);
+        glStencilFunc(GL_ALWAYS, 1, 0xFF);
+        glStencilOp(GL_KEEP, GL_KEEP, GL_REPLACE);
+        glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+        glDepthMask(GL_FALSE);
+        glDepthFunc(GL_LESS);
+
+        for (const Portal* portal : visiblePortals) {
+            unitBox.draw(shader, portalModel(baseModel, *portal));
+        }
+
+        // Full-screen box flattened onto the far plane (NDC z = 1)
+        glStencilFunc(GL_EQUAL, 1, 0xFF);
+        glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
+        glDepthMask(GL_TRUE);
+        glDepthFunc(GL_ALWAYS);
+
+        glm::mat4 identity(1.0f);
+        shader.setMat4("view", identity);
+        shader.setMat4("projection", identity);
+        glm::mat4 farPlane = glm::translate(identity, glm::vec3(0.0f, 0.0f, 1.0f));
+        unitBox.draw(shader, glm::scale(farPlane, glm::vec3(2.0f, 2.0f, 0.0f)));
+        shader.setMat4("view", view);
+        shader.setMat4("projection", projection);
+
+        glDepthFunc(GL_LEQUAL);
+        glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+    }
+
+    void endInterior() {
+        glDisable(GL_STENCIL_TEST);
+        glDisable(GL_SCISSOR_TEST);
+    }
+
+    int getVisibleCount() const { return static_cast<int>(visiblePortals.size()); }
+
+    void cleanup() {
+        unitBox.cleanup();
+    }
+};
+
+#endif
@@ -0,0 +1,511 @@
+#ifndef RENDERGRAPH_H
+#define RENDERGRAPH_H
+
+#include <glad/glad.h>
+
+#include <functional>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+// ==================== RenderGraph Class ====================
+// Per-frame pass graph. Each frame the passes are declared again with the
+// attachments they read and write; compile() orders them by those
+// dependencies, culls passes whose results nothing consumes, and maps every
+// transient texture onto a pooled GL texture. Transients whose lifetimes do
+// not overlap share the same texture, and the pool outlives the frame, so
+// adding a pass costs GPU memory only if its targets are alive at the same
+// time as every existing one.
+//   - The backbuffer is imported; writing it (or markOutput) keeps a pass alive
+//   - Transient contents are undefined when a pass starts: clear or overwrite
+//   - Execute callbacks run with the pass's FBO bound and its viewport set
+// With GPU timing on, every live pass is wrapped in a GL_TIME_ELAPSED query.
+class RenderGraph {
+public:
+    typedef int Resource;
+    typedef int Pass;
+
+    struct PassContext {
+        const RenderGraph* graph;
+        int width, height;       // Size of the pass's render target
+        unsigned int texture(Resource resource) const { return graph->getTexture(resource); }
+    };
+
+    struct PassTiming {
+        std::string name;
+        double milliseconds;
+    };
+
+private:
+    struct TextureDesc {
+        int width, height;
+        GLenum format;           // Sized internal format, e.g. GL_RGBA8, GL_R32F, GL_DEPTH_COMPONENT24
+
+        bool operator==(const TextureDesc& other) const {
+            return width == other.width && height == other.height && format == other.format;
+        }
+    };
+
+    struct ResourceNode {
+        std::string name;
+        TextureDesc desc;
+        bool imported;           // Backbuffer: never allocated, always an output
+        int physical;            // Pool index after compile, -1 = none
+        int firstUse, lastUse;   // Positions in the compiled order
+    };
+
+    struct PassNode {
+        std::string name;
+        std::function<void(const PassContext&)> execute;
+        std::vector<Resource> reads, writes;
+        bool output;
+        bool live;
+    };
+
+    struct PhysicalTexture {
+        unsigned int texture;
+        TextureDesc desc;
+        int busyUntil;           // Last compiled position of the transient holding it
+        long long lastUsedFrame;
+    };
+
+    // One executed frame's timer queries, reused every TIMER_LATENCY frames
+    struct TimerFrame {
+        std::vector<unsigned int> queries;
+        std::vector<std::string> names;
+        size_t used;
+    };
+
+    std::vector<ResourceNode> resources;
+    std::vector<PassNode> passes;
+    std::vector<Pass> order;     // Live passes, dependency order
+
+    std::vector<PhysicalTexture> pool;
+    std::map<std::vector<unsigned int>, unsigned int> framebuffers;   // Attachment set -> FBO
+    long long frame;
+    int texturesCreated;
+    bool compiled;
+
+    // Timer results are read TIMER_LATENCY frames after they were issued,
+    // when the GPU has long finished them, so reading never stalls
+    static const int TIMER_LATENCY = 3;
+    TimerFrame timerFrames[TIMER_LATENCY];
+    std::vector<PassTiming> gpuTimings;
+    bool gpuTiming;
+
+    // Textures unused for this many frames are freed (e.g. after a resize)
+    static const int POOL_TRIM_FRAMES = 120;
+
+    static bool isDepthFormat(GLenum format) {
+        return format == GL_DEPTH_COMPONENT24 || format == GL_DEPTH_COMPONENT32F || format == GL_DEPTH24_STENCIL8;
+    }
+
+    static size_t bytesPerPixel(GLenum format) {
+        switch (format) {
+        case GL_R8: return 1;
+        case GL_RGBA16F: return 8;
+        case GL_RGBA32F: return 16;
+        default: return 4;       // RGBA8, R32F, DEPTH24(_STENCIL8), DEPTH32F
+        }
+    }
+
+    static size_t textureBytes(const TextureDesc& desc) {
+        return static_cast<size_t>(desc.width) * desc.height * bytesPerPixel(desc.format);
+    }
+
+    static unsigned int createTexture(const TextureDesc& desc) {
+        GLenum format = GL_RGBA, type = GL_UNSIGNED_BYTE;
+        if (desc.format == GL_R32F) { format = GL_RED; type = GL_FLOAT; }
+        else if (desc.format == GL_R8) { format = GL_RED; }
+        else if (desc.format == GL_RGBA16F || desc.format == GL_RGBA32F) { type = GL_FLOAT; }
+        else if (desc.format == GL_DEPTH24_STENCIL8) { format = GL_DEPTH_STENCIL; type = GL_UNSIGNED_INT_24_8; }
+        else if (isDepthFormat(desc.format)) { format = GL_DEPTH_COMPONENT; type = GL_FLOAT; }
+
+        unsigned int texture;
+        glGenTextures(1, &texture);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glTexImage2D(GL_TEXTURE_2D, 0, desc.format, desc.width, desc.height, 0, format, type, nullptr);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        return texture;
+    }
+
+    bool writesBackbuffer(const PassNode& pass) const {
+        for (Resource r : pass.writes) {
+            if (resources[r].imported) return true;
+        }
+        return false;
+    }
+
+    // Edges follow declaration order per resource: readers and later writers
+    // wait for the previous writer, a writer waits for the readers before it.
+    // A read with no earlier writer binds to the first writer declared after it.
+    bool sortPasses(std::vector<Pass>& sorted) const {
+        size_t count = passes.size();
+        std::vector<std::vector<Pass>> successors(count);
+        std::vector<int> incoming(count, 0);
+        auto addEdge = [&](Pass from, Pass to) {
+            if (from == to) return;
+            successors[from].push_back(to);
+            incoming[to]++;
+        };
+
+        for (size_t r = 0; r < resources.size(); r++) {
+            Pass lastWriter = -1;
+            std::vector<Pass> readersSinceWrite;
+            std::vector<Pass> earlyReaders;  // Read before any writer was declared
+            for (size_t p = 0; p < count; p++) {
+                const PassNode& pass = passes[p];
+                bool reads = false, writes = false;
+                for (Resource x : pass.reads) reads |= (x == static_cast<Resource>(r));
+                for (Resource x : pass.writes) writes |= (x == static_cast<Resource>(r));
+
+                if (reads) {
+                    if (lastWriter >= 0) addEdge(lastWriter, static_cast<Pass>(p));
+                    else earlyReaders.push_back(static_cast<Pass>(p));
+                    readersSinceWrite.push_back(static_cast<Pass>(p));
+                }
+                if (writes) {
+                    if (lastWriter < 0) {
+                        for (Pass reader : earlyReaders) addEdge(static_cast<Pass>(p), reader);
+                    }
+                    else {
+                        addEdge(lastWriter, static_cast<Pass>(p));
+                        for (Pass reader : readersSinceWrite) addEdge(reader, static_cast<Pass>(p));
+                    }
+                    readersSinceWrite.clear();
+                    lastWriter = static_cast<Pass>(p);
+                }
+            }
+        }
+
+        // Kahn's algorithm, lowest declaration index first so independent
+        // passes keep the order they were declared in
+        sorted.clear();
+        std::vector<bool> done(count, false);
+        for (size_t step = 0; step < count; step++) {
+            Pass next = -1;
+            for (size_t p = 0; p < count; p++) {
+                if (!done[p] && incoming[p] == 0) { next = static_cast<Pass>(p); break; }
+            }
+            if (next < 0) return false;
+            done[next] = true;
+            sorted.push_back(next);
+            for (Pass s : successors[next]) incoming[s]--;
+        }
+        return true;
+    }
+
+    int acquireTexture(const TextureDesc& desc, int position) {
+        for (size_t i = 0; i < pool.size(); i++) {
+            if (pool[i].busyUntil < position && pool[i].desc == desc) return static_cast<int>(i);
+        }
+        PhysicalTexture physical;
+        physical.texture = createTexture(desc);
+        physical.desc = desc;
+        physical.busyUntil = -1;
+        physical.lastUsedFrame = frame;
+        pool.push_back(physical);
+        texturesCreated++;
+        return static_cast<int>(pool.size()) - 1;
+    }
+
+    void trimPool() {
+        bool trimmed = false;
+        for (size_t i = 0; i < pool.size();) {
+            if (frame - pool[i].lastUsedFrame > POOL_TRIM_FRAMES) {
+                glDeleteTextures(1, &pool[i].texture);
+                pool[i] = pool.back();
+                pool.pop_back();
+                trimmed = true;
+            }
+            else {
+                i++;
+            }
+        }
+        // Cached FBOs may reference a deleted texture
+        if (trimmed) releaseFramebuffers();
+    }
+
+    void beginTimer(TimerFrame& timers, const std::string& name) {
+        if (timers.used == timers.queries.size()) {
+            unsigned int query;
+            glGenQueries(1, &query);
+            timers.queries.push_back(query);
+            timers.names.emplace_back();
+        }
+        timers.names[timers.used] = name;
+        glBeginQuery(GL_TIME_ELAPSED, timers.queries[timers.used++]);
+    }
+
+    // Results still pending this late (a stalled GPU) are dropped
+    void collectTimings(TimerFrame& timers) {
+        if (timers.used == 0) return;
+        GLint available = 0;
+        glGetQueryObjectiv(timers.queries[timers.used - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (available) {
+            gpuTimings.resize(timers.used);
+            for (size_t i = 0; i < timers.used; i++) {
+                GLuint64 nanoseconds = 0;
+                glGetQueryObjectui64v(timers.queries[i], GL_QUERY_RESULT, &nanoseconds);
+                gpuTimings[i].name = timers.names[i];
+                gpuTimings[i].milliseconds = nanoseconds / 1.0e6;
+            }
+        }
+        timers.used = 0;
+    }
+
+    void releaseFramebuffers() {
+        for (auto& entry : framebuffers) glDeleteFramebuffers(1, &entry.second);
+        framebuffers.clear();
+    }
+
+    unsigned int framebufferFor(const PassNode& pass) {
+        std::vector<unsigned int> key;
+        unsigned int depth = 0;
+        GLenum depthAttachment = GL_DEPTH_ATTACHMENT;
+        for (Resource r : pass.writes) {
+            unsigned int texture = pool[resources[r].physical].texture;
+            if (isDepthFormat(resources[r].desc.format)) {
+                depth = texture;
+                if (resources[r].desc.format == GL_DEPTH24_STENCIL8) depthAttachment = GL_DEPTH_STENCIL_ATTACHMENT;
+            }
+            else {
+                key.push_back(texture);
+            }
+        }
+        size_t colorCount = key.size();
+        key.push_back(depth);
+
+        auto found = framebuffers.find(key);
+        if (found != framebuffers.end()) return found->second;
+
+        unsigned int fbo;
+        glGenFramebuffers(1, &fbo);
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+        std::vector<GLenum> drawBuffers;
+        for (size_t i = 0; i < colorCount; i++) {
+            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + static_cast<GLenum>(i), GL_TEXTURE_2D, key[i], 0);
+            drawBuffers.push_back(GL_COLOR_ATTACHMENT0 + static_cast<GLenum>(i));
+        }
+        if (depth) glFramebufferTexture2D(GL_FRAMEBUFFER, depthAttachment, GL_TEXTURE_2D, depth, 0);
+        if (drawBuffers.empty()) glDrawBuffer(GL_NONE);
+        else glDrawBuffers(static_cast<GLsizei>(drawBuffers.size()), drawBuffers.data());
+
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+            std::cerr << "ERROR::RENDERGRAPH::FRAMEBUFFER_INCOMPLETE: " << pass.name << std::endl;
+        }
+        framebuffers[key] = fbo;
+        return fbo;
+    }
+
+public:
+    RenderGraph() : frame(0), texturesCreated(0), compiled(false), gpuTiming(false) {
+        for (TimerFrame& timers : timerFrames) timers.used = 0;
+    }
+
+    // Starts the next frame's declarations; pooled textures are kept
+    void reset() {
+        resources.clear();
+        passes.clear();
+        order.clear();
+        compiled = false;
+    }
+
+    Resource importBackbuffer(int width, int height) {
+        ResourceNode node;
+        node.name = "backbuffer";
+        node.desc = { width, height, GL_RGBA8 };
+        node.imported = true;
+        node.physical = -1;
+        node.firstUse = node.lastUse = -1;
+        resources.push_back(node);
+        return static_cast<Resource>(resources.size()) - 1;
+    }
+
+    Resource createTexture(const char* name, int width, int height, GLenum format) {
+        ResourceNode node;
+        node.name = name;
+        node.desc = { width > 0 ? width : 1, height > 0 ? height : 1, format };
+        node.imported = false;
+        node.physical = -1;
+        node.firstUse = node.lastUse = -1;
+        resources.push_back(node);
+        return static_cast<Resource>(resources.size()) - 1;
+    }
+
+    Pass addPass(const char* name, std::function<void(const PassContext&)> execute) {
+        PassNode node;
+        node.name = name;
+        node.execute = execute;
+        node.output = false;
+        node.live = false;
+        passes.push_back(node);
+        return static_cast<Pass>(passes.size()) - 1;
+    }
+
+    void read(Pass pass, Resource resource) { passes[pass].reads.push_back(resource); }
+    void write(Pass pass, Resource resource) { passes[pass].writes.push_back(resource); }
+
+    // Keeps a pass with side effects (readback, queries) that nothing reads
+    void markOutput(Pass pass) { passes[pass].output = true; }
+
+    bool compile() {
+        compiled = false;
+        std::vector<Pass> sorted;
+        if (!sortPasses(sorted)) {
+            std::cerr << "ERROR::RENDERGRAPH::CYCLE" << std::endl;
+            return false;
+        }
+        for (const PassNode& pass : passes) {
+            if (writesBackbuffer(pass) && pass.writes.size() > 1) {
+                std::cerr << "ERROR::RENDERGRAPH::BACKBUFFER_WITH_TEXTURES: " << pass.name << std::endl;
+                return false;
+            }
+        }
+
+        // Culling, consumers first: a pass lives if it is an output or
+        // writes something a live pass reads
+        std::vector<bool> needed(resources.size(), false);
+        for (auto it = sorted.rbegin(); it != sorted.rend(); ++it) {
+            PassNode& pass = passes[*it];
+            pass.live = pass.output || writesBackbuffer(pass);
+            for (Resource r : pass.writes) pass.live = pass.live || needed[r];
+            if (pass.live) {
+                for (Resource r : pass.reads) needed[r] = true;
+            }
+        }
+
+        order.clear();
+        for (Pass p : sorted) {
+            if (passes[p].live) order.push_back(p);
+        }
+
+        // Lifetimes over the live order, then greedy aliasing: a pooled
+        // texture is free again once the last pass using its transient ran
+        for (int position = 0; position < static_cast<int>(order.size()); position++) {
+            const PassNode& pass = passes[order[position]];
+            for (const std::vector<Resource>* list : { &pass.reads, &pass.writes }) {
+                for (Resource r : *list) {
+                    if (resources[r].firstUse < 0) resources[r].firstUse = position;
+                    resources[r].lastUse = position;
+                }
+            }
+        }
+        for (PhysicalTexture& physical : pool) physical.busyUntil = -1;
+        for (int position = 0; position < static_cast<int>(order.size()); position++) {
+            for (ResourceNode& resource : resources) {
+                if (resource.imported || resource.firstUse != position) continue;
+                resource.physical = acquireTexture(resource.desc, position);
+                pool[resource.physical].busyUntil = resource.lastUse;
+                pool[resource.physical].lastUsedFrame = frame;
+            }
+        }
+
+        compiled = true;
+        return true;
+    }
+
+    void execute() {
+        if (compiled) {
+            TimerFrame* timers = nullptr;
+            if (gpuTiming) {
+                timers = &timerFrames[frame % TIMER_LATENCY];
+                collectTimings(*timers);
+            }
+
+            for (Pass p : order) {
+                PassNode& pass = passes[p];
+                PassContext context;
+                context.graph = this;
+                context.width = context.height = 0;
+
+                if (!pass.writes.empty()) {
+                    const ResourceNode& target = resources[pass.writes[0]];
+                    glBindFramebuffer(GL_FRAMEBUFFER, target.imported ? 0 : framebufferFor(pass));
+                    context.width = target.desc.width;
+                    context.height = target.desc.height;
+                    glViewport(0, 0, context.width, context.height);
+                }
+                if (timers) beginTimer(*timers, pass.name);
+                pass.execute(context);
+                if (timers) glEndQuery(GL_TIME_ELAPSED);
+            }
+
+            // Leave the default framebuffer bound for anything drawn outside the graph
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+            for (const ResourceNode& resource : resources) {
+                if (resource.imported) glViewport(0, 0, resource.desc.width, resource.desc.height);
+            }
+        }
+
+        frame++;
+        trimPool();
+    }
+
+    unsigned int getTexture(Resource resource) const {
+        int physical = resources[resource].physical;
+        return physical >= 0 ? pool[physical].texture : 0;
+    }
+
+    // Costs two queries per pass; results show up TIMER_LATENCY frames later
+    void setGpuTiming(bool enabled) {
+        gpuTiming = enabled;
+        if (gpuTiming) return;
+        for (TimerFrame& timers : timerFrames) timers.used = 0;
+        gpuTimings.clear();
+    }
+
+    bool isGpuTiming() const { return gpuTiming; }
+
+    // Live passes of a recent frame, in execution order
+    const std::vector<PassTiming>& getGpuTimings() const { return gpuTimings; }
+
+    size_t getPoolBytes() const {
+        size_t bytes = 0;
+        for (const PhysicalTexture& physical : pool) bytes += textureBytes(physical.desc);
+        return bytes;
+    }
+
+    void printInfo() const {
+        size_t declaredBytes = 0;
+        int transients = 0;
+        for (const ResourceNode& resource : resources) {
+            if (resource.imported || resource.physical < 0) continue;
+            declaredBytes += textureBytes(resource.desc);
+            transients++;
+        }
+
+        std::cout << "Render graph: " << order.size() << "/" << passes.size() << " passes live:";
+        for (Pass p : order) std::cout << " " << passes[p].name;
+        std::cout << std::endl;
+        std::cout << "  " << transients << " transient textures (" << declaredBytes / 1024 << " KB) on "
+            << pool.size() << " pooled (" << getPoolBytes() / 1024 << " KB), "
+            << texturesCreated << " created since start, " << framebuffers.size() << " FBOs cached" << std::endl;
+        if (!gpuTimings.empty()) {
+            std::cout << "  GPU:";
+            for (const PassTiming& timing : gpuTimings) std::cout << " " << timing.name << " " << timing.milliseconds << " ms";
+            std::cout << std::endl;
+        }
+    }
+
+    void cleanup() {
+        for (TimerFrame& timers : timerFrames) {
+            if (!timers.queries.empty()) glDeleteQueries(static_cast<GLsizei>(timers.queries.size()), timers.queries.data());
+            timers.queries.clear();
+            timers.names.clear();
+            timers.used = 0;
+        }
+        gpuTimings.clear();
+        releaseFramebuffers();
+        for (PhysicalTexture& physical : pool) glDeleteTextures(1, &physical.texture);
+        pool.clear();
+        reset();
+    }
+};
+
+#endif
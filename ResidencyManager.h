@@ -0,0 +1,185 @@
+#ifndef RESIDENCYMANAGER_H
+#define RESIDENCYMANAGER_H
+
+#include <chrono>
+#include <functional>
+#include <future>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// ==================== ResidencyManager Class ====================
+// Optional detail sets (the bus interior, ...) that are built lazily and kept
+// on the GPU only while they fit a memory budget.
+//   UNLOADED --request/prefetch--> BUILDING (CPU geometry on the thread pool)
+//   BUILDING --job done--> READY --update(), fits budget or requested--> RESIDENT
+//   RESIDENT --over budget, least recently used, not used this frame--> UNLOADED
+// update() runs on the GL thread; only build callbacks run on workers.
+class ResidencyManager {
+public:
+    enum State { UNLOADED, BUILDING, READY, RESIDENT };
+
+private:
+    struct Asset {
+        std::string name;
+        std::function<size_t()> build;     // Worker thread: CPU geometry, returns bytes to upload
+        std::function<void()> upload;      // GL thread
+        std::function<void()> release;     // GL thread: frees GPU objects
+        State state;
+        size_t bytes;
+        unsigned long lastUsedFrame;
+        bool everUsed;
+        std::future<size_t> job;
+    };
+
+    ThreadPool& pool;
+    std::vector<Asset> assets;
+    size_t budget;
+    size_t residentBytes;
+    unsigned long frame;
+    size_t uploadCount;          // Since startup, evicted assets included
+    size_t uploadedBytes;
+
+    void startBuild(Asset& asset) {
+        auto task = std::make_shared<std::packaged_task<size_t()>>(asset.build);
+        asset.job = task->get_future();
+        asset.state = BUILDING;
+        pool.submit([task] { (*task)(); });
+    }
+
+    bool usedThisFrame(const Asset& asset) const {
+        return asset.everUsed && asset.lastUsedFrame == frame;
+    }
+
+    // Least recently used resident asset that this frame does not need, or -1
+    int findEvictionCandidate() const {
+        int candidate = -1;
+        for (size_t i = 0; i < assets.size(); i++) {
+            const Asset& asset = assets[i];
+            if (asset.state != RESIDENT || usedThisFrame(asset)) continue;
+            if (candidate < 0 || asset.lastUsedFrame < assets[candidate].lastUsedFrame) {
+                candidate = static_cast<int>(i);
+            }
+        }
+        return candidate;
+    }
+
+    void evict(Asset& asset) {
+        asset.release();
+        residentBytes -= asset.bytes;
+        asset.state = UNLOADED;
+        std::cout << "Residency: evicted " << asset.name << " (" << asset.bytes / 1024 << " KB)" << std::endl;
+    }
+
+    // Frees least recently used assets until 'incoming' more bytes fit
+    bool makeRoom(size_t incoming) {
+        while (residentBytes + incoming > budget) {
+            int candidate = findEvictionCandidate();
+            if (candidate < 0) return false;
+            evict(assets[candidate]);
+        }
+        return true;
+    }
+
+public:
+    ResidencyManager(ThreadPool& threadPool, size_t budgetBytes)
+        : pool(threadPool), budget(budgetBytes), residentBytes(0), frame(0), uploadCount(0), uploadedBytes(0) {
+    }
+
+    int addAsset(const std::string& name, std::function<size_t()> build,
+        std::function<void()> upload, std::function<void()> release) {
+        Asset asset;
+        asset.name = name;
+        asset.build = build;
+        asset.upload = upload;
+        asset.release = release;
+        asset.state = UNLOADED;
+        asset.bytes = 0;
+        asset.lastUsedFrame = 0;
+        asset.everUsed = false;
+        assets.push_back(std::move(asset));
+        return static_cast<int>(assets.size()) - 1;
+    }
+
+    // The asset is needed this frame: starts loading if necessary and
+    // protects it from eviction
+    void request(int id) {
+        Asset& asset = assets[id];
+        asset.lastUsedFrame = frame;
+        asset.everUsed = true;
+        if (asset.state == UNLOADED) startBuild(asset);
+    }
+
+    // The asset will probably be needed soon (camera approaching): build it
+    // in the background, upload only if it fits the budget
+    void prefetch(int id) {
+        Asset& asset = assets[id];
+        if (asset.state == UNLOADED) startBuild(asset);
+    }
+
+    bool isResident(int id) const { return assets[id].state == RESIDENT; }
+    State getState(int id) const { return assets[id].state; }
+
+    // A background build is running; its result shows up in a later update()
+    bool isBuilding() const {
+        for (const auto& asset : assets) {
+            if (asset.state == BUILDING) return true;
+        }
+        return false;
+    }
+
+    // Once per frame on the GL thread: finish loads, upload, enforce the budget
+    void update() {
+        for (auto& asset : assets) {
+            if (asset.state == BUILDING &&
+                asset.job.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+                asset.bytes = asset.job.get();
+                asset.state = READY;
+            }
+
+            if (asset.state == READY) {
+                bool requested = usedThisFrame(asset);
+                if (makeRoom(asset.bytes) || requested) {
+                    asset.upload();
+                    residentBytes += asset.bytes;
+                    uploadCount++;
+                    uploadedBytes += asset.bytes;
+                    asset.state = RESIDENT;
+                    std::cout << "Residency: loaded " << asset.name << " (" << asset.bytes / 1024 << " KB)" << std::endl;
+                }
+            }
+        }
+
+        // A lowered budget or a forced upload can leave us over it
+        makeRoom(0);
+        frame++;
+    }
+
+    void setBudget(size_t bytes) { budget = bytes; }
+    size_t getBudget() const { return budget; }
+    size_t getResidentBytes() const { return residentBytes; }
+    size_t getUploadCount() const { return uploadCount; }
+    size_t getUploadedBytes() const { return uploadedBytes; }
+
+    void printInfo() const {
+        static const char* stateNames[] = { "unloaded", "building", "ready", "resident" };
+        std::cout << "Residency: " << residentBytes / 1024 << " KB / " << budget / 1024 << " KB budget" << std::endl;
+        for (const auto& asset : assets) {
+            std::cout << "  " << asset.name << ": " << stateNames[asset.state];
+            if (asset.state == RESIDENT) std::cout << " (" << asset.bytes / 1024 << " KB)";
+            std::cout << std::endl;
+        }
+    }
+
+    // Waits for in-flight builds, then frees everything resident
+    void cleanup() {
+        for (auto& asset : assets) {
+            if (asset.state == BUILDING) asset.job.wait();
+            if (asset.state == RESIDENT) asset.release();
+            asset.state = UNLOADED;
+        }
+        residentBytes = 0;
+    }
+};
+
+#endif
@@ -50,12 +50,14 @@ private:
 public:
     ShaderProgram() : programID(0) {}
 
+    // gPath is optional: a geometry stage between vertex and fragment
     inline bool create(const char* vPath = "vertex.glsl",
-        const char* fPath = "fragment.glsl") {
+        const char* fPath = "fragment.glsl", const char* gPath = nullptr) {
         std::string vertexSource = loadSource(vPath);
         std::string fragmentSource = loadSource(fPath);
+        std::string geometrySource = gPath ? loadSource(gPath) : std::string();
 
-        if (vertexSource.empty() || fragmentSource.empty()) {
+        if (vertexSource.empty() || fragmentSource.empty() || (gPath && geometrySource.empty())) {
             std::cerr << "ERROR::SHADER::EMPTY_SOURCE" << std::endl;
             return false;
         }
@@ -65,8 +67,12 @@ public:
         unsigned int fragmentShader =
             compileShader(GL_FRAGMENT_SHADER, fragmentSource.c_str());
 
+        unsigned int geometryShader = gPath ?
+            compileShader(GL_GEOMETRY_SHADER, geometrySource.c_str()) : 0;
+
         programID = glCreateProgram();
         glAttachShader(programID, vertexShader);
+        if (geometryShader) glAttachShader(programID, geometryShader);
         glAttachShader(programID, fragmentShader);
         glLinkProgram(programID);
 
@@ -80,6 +86,7 @@ public:
         }
 
         glDeleteShader(vertexShader);
+        if (geometryShader) glDeleteShader(geometryShader);
         glDeleteShader(fragmentShader);
 
         return success;
@@ -96,6 +103,18 @@ public:
         );
     }
 
+    inline void setInt(const char* name, int value) const {
+        glUniform1i(glGetUniformLocation(programID, name), value);
+    }
+
+    inline void setFloat(const char* name, float value) const {
+        glUniform1f(glGetUniformLocation(programID, name), value);
+    }
+
+    inline void setVec3(const char* name, const glm::vec3& value) const {
+        glUniform3fv(glGetUniformLocation(programID, name), 1, glm::value_ptr(value));
+    }
+
     inline unsigned int getID() const {
         return programID;
     }
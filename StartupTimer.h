@@ -0,0 +1,57 @@
+#ifndef STARTUPTIMER_H
+#define STARTUPTIMER_H
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// ==================== StartupTimer Class ====================
+// Wall-clock time of each startup stage, printed once after the first frame
+class StartupTimer {
+private:
+    struct Stage {
+        std::string name;
+        double milliseconds;
+    };
+
+    std::chrono::steady_clock::time_point start;
+    std::chrono::steady_clock::time_point last;
+    std::vector<Stage> stages;
+    bool reported;
+
+    static double millisecondsBetween(std::chrono::steady_clock::time_point a,
+        std::chrono::steady_clock::time_point b) {
+        return std::chrono::duration<double, std::milli>(b - a).count();
+    }
+
+public:
+    StartupTimer() : start(std::chrono::steady_clock::now()), last(start), reported(false) {}
+
+    // Ends the current stage
+    void mark(const std::string& name) {
+        auto now = std::chrono::steady_clock::now();
+        stages.push_back({ name, millisecondsBetween(last, now) });
+        last = now;
+    }
+
+    void report() {
+        if (reported) return;
+        reported = true;
+
+        std::cout << "\n=== Startup timing ===" << std::endl;
+        for (const auto& stage : stages) {
+            std::cout << "  " << std::left << std::setw(36) << stage.name << std::right
+                << std::fixed << std::setprecision(2) << std::setw(9) << stage.milliseconds << " ms" << std::endl;
+        }
+        std::cout << "  " << std::left << std::setw(36) << "Time to first frame" << std::right
+            << std::setw(9) << millisecondsBetween(start, last) << " ms" << std::endl;
+        std::cout.unsetf(std::ios::floatfield);
+        std::cout << std::setprecision(6);
+    }
+
+    bool hasReported() const { return reported; }
+};
+
+#endif
@@ -0,0 +1,78 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+// ==================== ThreadPool Class ====================
+// Fixed set of worker threads pulling tasks from one queue. Used for CPU-only
+// work (geometry generation); GL calls stay on the main thread.
+class ThreadPool {
+private:
+    std::vector<std::thread> workers;
+    std::queue<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable condition;
+    bool stopping;
+
+    void workerLoop() {
+        while (true) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                condition.wait(lock, [this] { return stopping || !tasks.empty(); });
+                if (stopping && tasks.empty()) return;
+                task = std::move(tasks.front());
+                tasks.pop();
+            }
+            task();
+        }
+    }
+
+public:
+    // 0 = one worker per hardware thread, leaving one for the caller
+    explicit ThreadPool(size_t threadCount = 0) : stopping(false) {
+        if (threadCount == 0) {
+            unsigned int hardware = std::thread::hardware_concurrency();
+            threadCount = hardware > 1 ? hardware - 1 : 1;
+        }
+        for (size_t i = 0; i < threadCount; i++) {
+            workers.emplace_back(&ThreadPool::workerLoop, this);
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        condition.notify_all();
+        for (auto& worker : workers) worker.join();
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Exceptions thrown by the task are rethrown from future.get()
+    template <typename Task>
+    std::future<void> submit(Task task) {
+        auto job = std::make_shared<std::packaged_task<void()>>(task);
+        std::future<void> result = job->get_future();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            tasks.push([job] { (*job)(); });
+        }
+        condition.notify_one();
+        return result;
+    }
+
+    size_t getThreadCount() const { return workers.size(); }
+};
+
+#endif
@@ -0,0 +1,280 @@
+#ifndef TRANSFORMKERNEL_H
+#define TRANSFORMKERNEL_H
+
+#include <glm/glm.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include <cmath>
+#include <vector>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define BUS_SIMD_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define BUS_TARGET_AVX2
+#else
+#define BUS_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+// ==================== TransformBatch Struct ====================
+// Structure-of-arrays translation / rotation (quaternion) / scale for N parts.
+// world[i] = parent * T(i) * R(i) * S(i), the same as chaining
+// glm::translate / glm::rotate / glm::scale on the parent matrix.
+struct TransformBatch {
+    std::vector<float> tx, ty, tz;
+    std::vector<float> qx, qy, qz, qw;
+    std::vector<float> sx, sy, sz;
+
+    size_t size() const { return tx.size(); }
+
+    void clear() {
+        tx.clear(); ty.clear(); tz.clear();
+        qx.clear(); qy.clear(); qz.clear(); qw.clear();
+        sx.clear(); sy.clear(); sz.clear();
+    }
+
+    void reserve(size_t n) {
+        tx.reserve(n); ty.reserve(n); tz.reserve(n);
+        qx.reserve(n); qy.reserve(n); qz.reserve(n); qw.reserve(n);
+        sx.reserve(n); sy.reserve(n); sz.reserve(n);
+    }
+
+    size_t add(const glm::vec3& translation, const glm::vec3& scale) {
+        tx.push_back(translation.x); ty.push_back(translation.y); tz.push_back(translation.z);
+        qx.push_back(0.0f); qy.push_back(0.0f); qz.push_back(0.0f); qw.push_back(1.0f);
+        sx.push_back(scale.x); sy.push_back(scale.y); sz.push_back(scale.z);
+        return size() - 1;
+    }
+
+    size_t add(const glm::vec3& translation, const glm::vec3& scale, float angle, const glm::vec3& axis) {
+        size_t i = add(translation, scale);
+        setRotation(i, angle, axis);
+        return i;
+    }
+
+    // Angle in radians, as glm::rotate
+    void setRotation(size_t i, float angle, const glm::vec3& axis) {
+        glm::vec3 a = glm::normalize(axis) * std::sin(angle * 0.5f);
+        qx[i] = a.x; qy[i] = a.y; qz[i] = a.z;
+        qw[i] = std::cos(angle * 0.5f);
+    }
+};
+
+// ==================== Transform Kernel ====================
+namespace TransformKernel {
+
+    enum SimdLevel { SIMD_SCALAR, SIMD_SSE2, SIMD_AVX2 };
+
+    inline SimdLevel detectSimdLevel() {
+#if defined(BUS_SIMD_X86) && defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 0);
+        int maxLeaf = info[0];
+        __cpuid(info, 1);
+        bool sse2 = (info[3] & (1 << 26)) != 0;
+        bool osxsave = (info[2] & (1 << 27)) != 0;
+        bool avx = (info[2] & (1 << 28)) != 0;
+        bool avx2 = false;
+        if (maxLeaf >= 7) {
+            __cpuidex(info, 7, 0);
+            avx2 = (info[1] & (1 << 5)) != 0;
+        }
+        // The OS must also save the upper YMM state
+        bool osAvx = osxsave && (_xgetbv(0) & 6) == 6;
+        if (avx && avx2 && osAvx) return SIMD_AVX2;
+        return sse2 ? SIMD_SSE2 : SIMD_SCALAR;
+#elif defined(BUS_SIMD_X86)
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) return SIMD_AVX2;
+        if (__builtin_cpu_supports("sse2")) return SIMD_SSE2;
+        return SIMD_SCALAR;
+#else
+        return SIMD_SCALAR;
+#endif
+    }
+
+    inline SimdLevel activeSimdLevel() {
+        static const SimdLevel level = detectSimdLevel();
+        return level;
+    }
+
+    inline const char* simdLevelName(SimdLevel level) {
+        switch (level) {
+        case SIMD_AVX2: return "AVX2";
+        case SIMD_SSE2: return "SSE2";
+        default: return "scalar";
+        }
+    }
+
+    // Reference path, also used for the tail of the SIMD loops
+    inline void computeScalar(const TransformBatch& b, const glm::mat4& parent, glm::mat4* out,
+        size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            float x = b.qx[i], y = b.qy[i], z = b.qz[i], w = b.qw[i];
+
+            glm::vec3 r0(1.0f - 2.0f * (y * y + z * z), 2.0f * (x * y + w * z), 2.0f * (x * z - w * y));
+            glm::vec3 r1(2.0f * (x * y - w * z), 1.0f - 2.0f * (x * x + z * z), 2.0f * (y * z + w * x));
+            glm::vec3 r2(2.0f * (x * z + w * y), 2.0f * (y * z - w * x), 1.0f - 2.0f * (x * x + y * y));
+            r0 *= b.sx[i];
+            r1 *= b.sy[i];
+            r2 *= b.sz[i];
+
+            glm::mat4& m = out[i];
+            m[0] = parent[0] * r0.x + parent[1] * r0.y + parent[2] * r0.z;
+            m[1] = parent[0] * r1.x + parent[1] * r1.y + parent[2] * r1.z;
+            m[2] = parent[0] * r2.x + parent[1] * r2.y + parent[2] * r2.z;
+            m[3] = parent[0] * b.tx[i] + parent[1] * b.ty[i] + parent[2] * b.tz[i] + parent[3];
+        }
+    }
+
+#ifdef BUS_SIMD_X86
+    // 4 parts per iteration; 4x4 transposes turn element-major lanes back
+    // into one contiguous matrix per part
+    inline size_t computeSSE2(const TransformBatch& b, const glm::mat4& parent, glm::mat4* out, size_t n) {
+        const float* p = glm::value_ptr(parent);
+        __m128 P[16];
+        for (int k = 0; k < 16; k++) P[k] = _mm_set1_ps(p[k]);
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 two = _mm_set1_ps(2.0f);
+
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            __m128 x = _mm_loadu_ps(&b.qx[i]), y = _mm_loadu_ps(&b.qy[i]);
+            __m128 z = _mm_loadu_ps(&b.qz[i]), w = _mm_loadu_ps(&b.qw[i]);
+            __m128 xx = _mm_mul_ps(x, x), yy = _mm_mul_ps(y, y), zz = _mm_mul_ps(z, z);
+            __m128 xy = _mm_mul_ps(x, y), xz = _mm_mul_ps(x, z), yz = _mm_mul_ps(y, z);
+            __m128 wx = _mm_mul_ps(w, x), wy = _mm_mul_ps(w, y), wz = _mm_mul_ps(w, z);
+            __m128 sx = _mm_loadu_ps(&b.sx[i]), sy = _mm_loadu_ps(&b.sy[i]), sz = _mm_loadu_ps(&b.sz[i]);
+
+            // Local 3x3 (rotation * scale), column-major
+            __m128 l[9];
+            l[0] = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz))), sx);
+            l[1] = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xy, wz)), sx);
+            l[2] = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xz, wy)), sx);
+            l[3] = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xy, wz)), sy);
+            l[4] = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz))), sy);
+            l[5] = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(yz, wx)), sy);
+            l[6] = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xz, wy)), sz);
+            l[7] = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(yz, wx)), sz);
+            l[8] = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy))), sz);
+            __m128 t0 = _mm_loadu_ps(&b.tx[i]), t1 = _mm_loadu_ps(&b.ty[i]), t2 = _mm_loadu_ps(&b.tz[i]);
+
+            // e[col * 4 + row] for 4 parts
+            __m128 e[16];
+            for (int row = 0; row < 4; row++) {
+                for (int col = 0; col < 3; col++) {
+                    e[col * 4 + row] = _mm_add_ps(_mm_add_ps(
+                        _mm_mul_ps(P[row], l[col * 3 + 0]),
+                        _mm_mul_ps(P[4 + row], l[col * 3 + 1])),
+                        _mm_mul_ps(P[8 + row], l[col * 3 + 2]));
+                }
+                e[12 + row] = _mm_add_ps(_mm_add_ps(_mm_mul_ps(P[row], t0), _mm_mul_ps(P[4 + row], t1)),
+                    _mm_add_ps(_mm_mul_ps(P[8 + row], t2), P[12 + row]));
+            }
+
+            for (int col = 0; col < 4; col++) {
+                __m128 c0 = e[col * 4 + 0], c1 = e[col * 4 + 1], c2 = e[col * 4 + 2], c3 = e[col * 4 + 3];
+                _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+                _mm_storeu_ps(glm::value_ptr(out[i + 0]) + col * 4, c0);
+                _mm_storeu_ps(glm::value_ptr(out[i + 1]) + col * 4, c1);
+                _mm_storeu_ps(glm::value_ptr(out[i + 2]) + col * 4, c2);
+                _mm_storeu_ps(glm::value_ptr(out[i + 3]) + col * 4, c3);
+            }
+        }
+        return i;
+    }
+
+    BUS_TARGET_AVX2 inline void transpose8(__m256* r) {
+        __m256 t[8], s[8];
+        for (int k = 0; k < 8; k += 2) {
+            t[k] = _mm256_unpacklo_ps(r[k], r[k + 1]);
+            t[k + 1] = _mm256_unpackhi_ps(r[k], r[k + 1]);
+        }
+        for (int k = 0; k < 8; k += 4) {
+            s[k + 0] = _mm256_shuffle_ps(t[k + 0], t[k + 2], _MM_SHUFFLE(1, 0, 1, 0));
+            s[k + 1] = _mm256_shuffle_ps(t[k + 0], t[k + 2], _MM_SHUFFLE(3, 2, 3, 2));
+            s[k + 2] = _mm256_shuffle_ps(t[k + 1], t[k + 3], _MM_SHUFFLE(1, 0, 1, 0));
+            s[k + 3] = _mm256_shuffle_ps(t[k + 1], t[k + 3], _MM_SHUFFLE(3, 2, 3, 2));
+        }
+        for (int k = 0; k < 4; k++) {
+            r[k] = _mm256_permute2f128_ps(s[k], s[k + 4], 0x20);
+            r[k + 4] = _mm256_permute2f128_ps(s[k], s[k + 4], 0x31);
+        }
+    }
+
+    // 8 parts per iteration; two 8x8 transposes write the first and second
+    // half of each part's matrix
+    BUS_TARGET_AVX2 inline size_t computeAVX2(const TransformBatch& b, const glm::mat4& parent, glm::mat4* out, size_t n) {
+        const float* p = glm::value_ptr(parent);
+        __m256 P[16];
+        for (int k = 0; k < 16; k++) P[k] = _mm256_set1_ps(p[k]);
+        const __m256 one = _mm256_set1_ps(1.0f);
+        const __m256 two = _mm256_set1_ps(2.0f);
+
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            __m256 x = _mm256_loadu_ps(&b.qx[i]), y = _mm256_loadu_ps(&b.qy[i]);
+            __m256 z = _mm256_loadu_ps(&b.qz[i]), w = _mm256_loadu_ps(&b.qw[i]);
+            __m256 xx = _mm256_mul_ps(x, x), yy = _mm256_mul_ps(y, y), zz = _mm256_mul_ps(z, z);
+            __m256 xy = _mm256_mul_ps(x, y), xz = _mm256_mul_ps(x, z), yz = _mm256_mul_ps(y, z);
+            __m256 wx = _mm256_mul_ps(w, x), wy = _mm256_mul_ps(w, y), wz = _mm256_mul_ps(w, z);
+            __m256 sx = _mm256_loadu_ps(&b.sx[i]), sy = _mm256_loadu_ps(&b.sy[i]), sz = _mm256_loadu_ps(&b.sz[i]);
+
+            __m256 l[9];
+            l[0] = _mm256_mul_ps(_mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(yy, zz))), sx);
+            l[1] = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(xy, wz)), sx);
+            l[2] = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(xz, wy)), sx);
+            l[3] = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(xy, wz)), sy);
+            l[4] = _mm256_mul_ps(_mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(xx, zz))), sy);
+            l[5] = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(yz, wx)), sy);
+            l[6] = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(xz, wy)), sz);
+            l[7] = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(yz, wx)), sz);
+            l[8] = _mm256_mul_ps(_mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(xx, yy))), sz);
+            __m256 t0 = _mm256_loadu_ps(&b.tx[i]), t1 = _mm256_loadu_ps(&b.ty[i]), t2 = _mm256_loadu_ps(&b.tz[i]);
+
+            __m256 e[16];
+            for (int row = 0; row < 4; row++) {
+                for (int col = 0; col < 3; col++) {
+                    e[col * 4 + row] = _mm256_add_ps(_mm256_add_ps(
+                        _mm256_mul_ps(P[row], l[col * 3 + 0]),
+                        _mm256_mul_ps(P[4 + row], l[col * 3 + 1])),
+                        _mm256_mul_ps(P[8 + row], l[col * 3 + 2]));
+                }
+                e[12 + row] = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(P[row], t0), _mm256_mul_ps(P[4 + row], t1)),
+                    _mm256_add_ps(_mm256_mul_ps(P[8 + row], t2), P[12 + row]));
+            }
+
+            transpose8(e);
+            transpose8(e + 8);
+            for (int k = 0; k < 8; k++) {
+                float* m = glm::value_ptr(out[i + k]);
+                _mm256_storeu_ps(m, e[k]);
+                _mm256_storeu_ps(m + 8, e[8 + k]);
+            }
+        }
+        _mm256_zeroupper();
+        return i;
+    }
+#endif
+
+    // Writes b.size() world matrices to out using the widest available path
+    inline void computeWorldMatrices(const TransformBatch& b, const glm::mat4& parent, glm::mat4* out,
+        SimdLevel level = activeSimdLevel()) {
+        size_t n = b.size();
+        size_t done = 0;
+#ifdef BUS_SIMD_X86
+        if (level == SIMD_AVX2) done = computeAVX2(b, parent, out, n);
+        else if (level == SIMD_SSE2) done = computeSSE2(b, parent, out, n);
+#endif
+        computeScalar(b, parent, out, done, n);
+    }
+
+    inline void computeWorldMatrices(const TransformBatch& b, const glm::mat4& parent, std::vector<glm::mat4>& out) {
+        out.resize(b.size());
+        if (!out.empty()) computeWorldMatrices(b, parent, out.data());
+    }
+}
+
+#endif
@@ -0,0 +1,324 @@
+#ifndef WORLDSTREAMER_H
+#define WORLDSTREAMER_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+// ==================== FloatingOrigin Class ====================
+// Render space stays near (0, 0, 0): once the focus (the bus) drifts past
+// REBASE_DISTANCE, the whole scene is shifted back by a whole number of
+// grid cells and the shift is accumulated here in double precision.
+// Absolute route positions are offsetX + local x.
+class FloatingOrigin {
+private:
+    double offsetX;
+    int rebaseCount;
+
+public:
+    static constexpr float REBASE_DISTANCE = 1024.0f;
+
+    FloatingOrigin() : offsetX(0.0), rebaseCount(0) {}
+
+    // Returns true and the shift to subtract from every render-space
+    // position when the focus is too far out; the shift is a multiple of
+    // grid so streamed tiles stay aligned
+    bool rebase(float focusX, float grid, glm::vec3& shift) {
+        if (std::fabs(focusX) < REBASE_DISTANCE) return false;
+
+        float cells = std::floor(focusX / grid);
+        shift = glm::vec3(cells * grid, 0.0f, 0.0f);
+        offsetX += static_cast<double>(shift.x);
+        rebaseCount++;
+        return true;
+    }
+
+    double toAbsoluteX(float localX) const { return offsetX + localX; }
+    float toLocalX(double absoluteX) const { return static_cast<float>(absoluteX - offsetX); }
+    double getOffsetX() const { return offsetX; }
+    int getRebaseCount() const { return rebaseCount; }
+};
+
+// ==================== WorldStreamer Class ====================
+// Road tiles along the route (X axis), generated from their absolute tile
+// index so every visit produces the same tile. A fixed ring of RING_SIZE
+// slots in one VAO/VBO/EBO holds the tiles around the bus; tile i always
+// lives in slot i mod RING_SIZE, so any window of RING_SIZE consecutive
+// tiles fits and streaming a tile in overwrites the one that fell out.
+// GPU memory is allocated once and never grows with route length.
+class WorldStreamer {
+public:
+    static constexpr float TILE_LENGTH = 64.0f;
+    static const int RING_RADIUS = 3;                    // Tiles kept ahead of and behind the bus
+    static const int RING_SIZE = 2 * RING_RADIUS + 1;
+    static const int MAX_STREAMS_PER_FRAME = 2;          // Bounds the upload cost of a frame
+
+private:
+    static const int MAX_TILE_BOXES = 48;
+    static const int VERTICES_PER_BOX = 8;
+    static const int INDICES_PER_BOX = 36;
+    static const int MAX_TILE_VERTICES = MAX_TILE_BOXES * VERTICES_PER_BOX;
+    static const int MAX_TILE_INDICES = MAX_TILE_BOXES * INDICES_PER_BOX;
+
+    static constexpr float GROUND_Y = -1.4f;             // Under the bus wheels
+    static constexpr float GROUND_HALF_WIDTH = 40.0f;
+
+    // Street lamps, alternating sides every 16 units
+    static const int LAMPS_PER_TILE = 4;
+    static glm::vec3 lampHead(int i) {
+        float side = (i % 2 == 0) ? 1.0f : -1.0f;
+        return glm::vec3(-24.0f + 16.0f * i, GROUND_Y + 5.5f, side * 4.2f);
+    }
+
+    struct Slot {
+        long long tile;          // Absolute tile index held (valid only if loaded)
+        bool loaded;
+        MeshRange mesh;
+    };
+
+    unsigned int VAO, VBO, EBO;
+    Slot slots[RING_SIZE];
+    long long centerTile;
+    int tilesStreamed;
+    size_t bytesStreamed;
+
+    // Scratch buffers reused for every tile build
+    std::vector<float> tileVertices;
+    std::vector<unsigned int> tileIndices;
+
+    static int slotFor(long long tile) {
+        long long m = tile % RING_SIZE;
+        return static_cast<int>(m < 0 ? m + RING_SIZE : m);
+    }
+
+    // Deterministic per-tile random numbers (splitmix64)
+    static uint64_t hash(uint64_t x) {
+        x += 0x9E3779B97F4A7C15ull;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+        return x ^ (x >> 31);
+    }
+
+    static float random01(uint64_t& state) {
+        state = hash(state);
+        return static_cast<float>(state >> 40) / static_cast<float>(1ull << 24);
+    }
+
+    // Same 8 corners and winding as Cube::createGeometry()
+    void addBox(const glm::vec3& center, const glm::vec3& size, const glm::vec3& color) {
+        static const unsigned int boxIndices[INDICES_PER_BOX] = {
+            4, 5, 6,  4, 6, 7,
+            1, 0, 3,  1, 3, 2,
+            0, 4, 7,  0, 7, 3,
+            5, 1, 2,  5, 2, 6,
+            7, 6, 2,  7, 2, 3,
+            0, 1, 5,  0, 5, 4
+        };
+        if (tileIndices.size() + INDICES_PER_BOX > static_cast<size_t>(MAX_TILE_INDICES)) return;
+
+        unsigned int base = static_cast<unsigned int>(tileVertices.size() / 6);
+        glm::vec3 h = size * 0.5f;
+        const float corners[8][3] = {
+            { -1, -1, -1 }, { 1, -1, -1 }, { 1, 1, -1 }, { -1, 1, -1 },
+            { -1, -1,  1 }, { 1, -1,  1 }, { 1, 1,  1 }, { -1, 1,  1 }
+        };
+        for (const auto& c : corners) {
+            tileVertices.insert(tileVertices.end(), {
+                center.x + c[0] * h.x, center.y + c[1] * h.y, center.z + c[2] * h.z,
+                color.r, color.g, color.b });
+        }
+        for (unsigned int index : boxIndices) tileIndices.push_back(base + index);
+    }
+
+    // Tile-local geometry centered on the tile (x in [-L/2, L/2])
+    void buildTile(long long tile) {
+        tileVertices.clear();
+        tileIndices.clear();
+        uint64_t seed = hash(static_cast<uint64_t>(tile));
+        float length = TILE_LENGTH;
+        float half = length * 0.5f;
+
+        float grassShade = 0.9f + 0.2f * random01(seed);
+        addBox(glm::vec3(0.0f, GROUND_Y - 0.06f, 0.0f), glm::vec3(length, 0.1f, GROUND_HALF_WIDTH * 2.0f),
+            glm::vec3(0.25f, 0.5f, 0.2f) * grassShade);
+
+        // Two-lane road, edge lines and center dashes
+        addBox(glm::vec3(0.0f, GROUND_Y - 0.02f, 0.0f), glm::vec3(length, 0.04f, 7.0f), glm::vec3(0.22f, 0.22f, 0.24f));
+        addBox(glm::vec3(0.0f, GROUND_Y + 0.005f, 3.2f), glm::vec3(length, 0.01f, 0.15f), glm::vec3(0.9f, 0.9f, 0.9f));
+        addBox(glm::vec3(0.0f, GROUND_Y + 0.005f, -3.2f), glm::vec3(length, 0.01f, 0.15f), glm::vec3(0.9f, 0.9f, 0.9f));
+        for (float x = -half + 2.0f; x < half; x += 8.0f) {
+            addBox(glm::vec3(x + 1.5f, GROUND_Y + 0.005f, 0.0f), glm::vec3(3.0f, 0.01f, 0.15f), glm::vec3(0.95f, 0.85f, 0.2f));
+        }
+
+        // Roadside trees (trunk + crown) on both verges
+        int trees = 2 + static_cast<int>(random01(seed) * 10.0f);
+        for (int i = 0; i < trees; i++) {
+            float x = -half + random01(seed) * length;
+            float side = random01(seed) < 0.5f ? -1.0f : 1.0f;
+            float z = side * (6.0f + random01(seed) * 25.0f);
+            float height = 2.0f + random01(seed) * 3.0f;
+            addBox(glm::vec3(x, GROUND_Y + height * 0.5f, z), glm::vec3(0.3f, height, 0.3f), glm::vec3(0.4f, 0.26f, 0.13f));
+            addBox(glm::vec3(x, GROUND_Y + height + 0.8f, z), glm::vec3(2.0f, 1.6f, 2.0f),
+                glm::vec3(0.1f, 0.35f + 0.25f * random01(seed), 0.1f));
+        }
+
+        // Lamp posts; the lamp head reaches out over the verge
+        for (int i = 0; i < LAMPS_PER_TILE; i++) {
+            glm::vec3 head = lampHead(i);
+            float side = head.z > 0.0f ? 1.0f : -1.0f;
+            addBox(glm::vec3(head.x, GROUND_Y + 2.75f, head.z + side * 0.6f), glm::vec3(0.15f, 5.5f, 0.15f),
+                glm::vec3(0.35f, 0.35f, 0.38f));
+            addBox(head, glm::vec3(0.5f, 0.15f, 1.4f), glm::vec3(1.0f, 0.9f, 0.7f));
+        }
+
+        // Kilometre post every 1000 units of route
+        double tileStart = static_cast<double>(tile) * TILE_LENGTH;
+        double nextKm = std::ceil(tileStart / 1000.0) * 1000.0;
+        if (nextKm < tileStart + TILE_LENGTH) {
+            float x = static_cast<float>(nextKm - tileStart) - half;
+            addBox(glm::vec3(x, GROUND_Y + 0.6f, 4.2f), glm::vec3(0.15f, 1.2f, 0.4f), glm::vec3(0.95f, 0.95f, 0.95f));
+        }
+    }
+
+    void streamIn(long long tile) {
+        buildTile(tile);
+        Slot& slot = slots[slotFor(tile)];
+
+        // The element buffer binding is VAO state, so write through our own VAO
+        glBindVertexArray(VAO);
+        glBindBuffer(GL_ARRAY_BUFFER, VBO);
+        glBufferSubData(GL_ARRAY_BUFFER, slotFor(tile) * MAX_TILE_VERTICES * 6 * sizeof(float),
+            tileVertices.size() * sizeof(float), tileVertices.data());
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+        glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, slotFor(tile) * MAX_TILE_INDICES * sizeof(unsigned int),
+            tileIndices.size() * sizeof(unsigned int), tileIndices.data());
+        glBindVertexArray(0);
+
+        slot.tile = tile;
+        slot.loaded = true;
+        slot.mesh.count = static_cast<unsigned int>(tileIndices.size());
+        tilesStreamed++;
+        bytesStreamed += tileVertices.size() * sizeof(float) + tileIndices.size() * sizeof(unsigned int);
+    }
+
+public:
+    WorldStreamer() : VAO(0), VBO(0), EBO(0), centerTile(0), tilesStreamed(0), bytesStreamed(0) {
+        for (auto& slot : slots) {
+            slot.tile = 0;
+            slot.loaded = false;
+        }
+    }
+
+    // Allocates the whole ring once
+    void setup() {
+        glGenVertexArrays(1, &VAO);
+        glGenBuffers(1, &VBO);
+        glGenBuffers(1, &EBO);
+
+        glBindVertexArray(VAO);
+        glBindBuffer(GL_ARRAY_BUFFER, VBO);
+        glBufferData(GL_ARRAY_BUFFER, RING_SIZE * MAX_TILE_VERTICES * 6 * sizeof(float), nullptr, GL_DYNAMIC_DRAW);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, RING_SIZE * MAX_TILE_INDICES * sizeof(unsigned int), nullptr, GL_DYNAMIC_DRAW);
+
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
+        glEnableVertexAttribArray(1);
+        glBindVertexArray(0);
+
+        for (int i = 0; i < RING_SIZE; i++) {
+            slots[i].mesh.VAO = VAO;
+            slots[i].mesh.first = i * MAX_TILE_INDICES;
+            slots[i].mesh.baseVertex = i * MAX_TILE_VERTICES;
+            slots[i].mesh.indexed = true;
+        }
+
+        tileVertices.reserve(MAX_TILE_VERTICES * 6);
+        tileIndices.reserve(MAX_TILE_INDICES);
+    }
+
+    // Streams missing tiles around the focus, nearest first, at most
+    // MAX_STREAMS_PER_FRAME per call (all of them with streamAll, e.g. at startup).
+    // Returns how many were streamed in.
+    int update(const FloatingOrigin& origin, float focusX, bool streamAll = false) {
+        centerTile = static_cast<long long>(std::floor(origin.toAbsoluteX(focusX) / TILE_LENGTH));
+
+        int budget = streamAll ? RING_SIZE : MAX_STREAMS_PER_FRAME;
+        for (int d = 0; d <= RING_RADIUS && budget > 0; d++) {
+            for (int sign = 1; sign >= -1 && budget > 0; sign -= 2) {
+                long long tile = centerTile + sign * d;
+                const Slot& slot = slots[slotFor(tile)];
+                if (!slot.loaded || slot.tile != tile) {
+                    streamIn(tile);
+                    budget--;
+                }
+                if (d == 0) break;
+            }
+        }
+        return (streamAll ? RING_SIZE : MAX_STREAMS_PER_FRAME) - budget;
+    }
+
+    // One packet per loaded tile of the current window. Tile positions are
+    // computed in double and only the small render-space result is a float.
+    void submit(DrawList& list, const FloatingOrigin& origin) const {
+        glm::vec3 halfExtent(TILE_LENGTH * 0.5f, 6.0f, GROUND_HALF_WIDTH * 1.0f);
+        for (const auto& slot : slots) {
+            if (!slot.loaded || slot.tile < centerTile - RING_RADIUS || slot.tile > centerTile + RING_RADIUS) continue;
+
+            double centerX = (static_cast<double>(slot.tile) + 0.5) * TILE_LENGTH;
+            glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::vec3(origin.toLocalX(centerX), 0.0f, 0.0f));
+            list.add(slot.mesh, model, 0, halfExtent);
+        }
+    }
+
+    // One point light under every lamp head of the resident tiles
+    void collectLights(ClusteredLighting& lighting, const FloatingOrigin& origin) const {
+        for (const auto& slot : slots) {
+            if (!slot.loaded || slot.tile < centerTile - RING_RADIUS || slot.tile > centerTile + RING_RADIUS) continue;
+
+            float centerX = origin.toLocalX((static_cast<double>(slot.tile) + 0.5) * TILE_LENGTH);
+            for (int i = 0; i < LAMPS_PER_TILE; i++) {
+                PointLight light;
+                light.position = lampHead(i) + glm::vec3(centerX, -0.3f, 0.0f);
+                light.radius = 14.0f;
+                light.color = glm::vec3(1.0f, 0.8f, 0.55f);
+                light.intensity = 10.0f;
+                lighting.addLight(light);
+            }
+        }
+    }
+
+    // Far plane that still reaches the end of the ring
+    static float viewDistance() { return (RING_RADIUS + 0.5f) * TILE_LENGTH; }
+
+    // Since startup
+    int getTilesStreamed() const { return tilesStreamed; }
+    size_t getBytesStreamed() const { return bytesStreamed; }
+
+    // GPU memory of the tile ring, fixed at setup
+    static size_t getRingBytes() {
+        return RING_SIZE * (MAX_TILE_VERTICES * 6 * sizeof(float) + MAX_TILE_INDICES * sizeof(unsigned int));
+    }
+
+    void printInfo(const FloatingOrigin& origin, float focusX) const {
+        size_t ringBytes = getRingBytes();
+        std::cout << "World: route position " << origin.toAbsoluteX(focusX) / 1000.0 << " km, tile " << centerTile
+            << ", " << tilesStreamed << " tiles streamed, ring " << ringBytes / 1024 << " KB, "
+            << origin.getRebaseCount() << " origin rebases" << std::endl;
+    }
+
+    void cleanup() {
+        if (VAO) glDeleteVertexArrays(1, &VAO);
+        if (VBO) glDeleteBuffers(1, &VBO);
+        if (EBO) glDeleteBuffers(1, &EBO);
+        VAO = VBO = EBO = 0;
+    }
+};
+
+#endif
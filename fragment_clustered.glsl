@@ -0,0 +1,41 @@
+#version 330 core
+in vec3 vertexColor;
+in vec3 viewPosition;
+out vec4 FragColor;
+
+// Filled by ClusteredLighting every frame
+uniform samplerBuffer lightData;         // Per light: view position + radius, color + intensity
+uniform usamplerBuffer clusterData;      // Per cluster: first index, light count
+uniform usamplerBuffer lightIndices;
+uniform ivec3 gridSize;
+uniform vec2 screenSize;
+uniform float zNear;
+uniform float sliceScale;                // gridSize.z / log(zFar / zNear)
+uniform vec3 ambient;
+
+void main()
+{
+    // Faceted normal from screen-space derivatives; always faces the viewer
+    vec3 normal = normalize(cross(dFdx(viewPosition), dFdy(viewPosition)));
+
+    int slice = clamp(int(log(max(-viewPosition.z, zNear) / zNear) * sliceScale), 0, gridSize.z - 1);
+    ivec2 tile = clamp(ivec2(gl_FragCoord.xy / screenSize * vec2(gridSize.xy)), ivec2(0), gridSize.xy - 1);
+    uvec2 range = texelFetch(clusterData, (slice * gridSize.y + tile.y) * gridSize.x + tile.x).xy;
+
+    vec3 lighting = ambient;
+    for (uint i = 0u; i < range.y; i++) {
+        int light = int(texelFetch(lightIndices, int(range.x + i)).r);
+        vec4 positionRadius = texelFetch(lightData, light * 2);
+        vec4 colorIntensity = texelFetch(lightData, light * 2 + 1);
+
+        vec3 toLight = positionRadius.xyz - viewPosition;
+        float distance = length(toLight);
+        // Inverse-square, windowed to reach zero exactly at the radius
+        float window = clamp(1.0 - pow(distance / positionRadius.w, 4.0), 0.0, 1.0);
+        float attenuation = window * window / (distance * distance + 1.0);
+        float diffuse = max(dot(normal, toLight / max(distance, 1e-4)), 0.0);
+        lighting += colorIntensity.rgb * colorIntensity.a * diffuse * attenuation;
+    }
+
+    FragColor = vec4(vertexColor * lighting, 1.0);
+}
@@ -0,0 +1,11 @@
+#version 330 core
+in vec2 texCoord;
+in vec4 color;
+out vec4 FragColor;
+
+uniform sampler2D atlas;                 // Glyph coverage, plus a solid cell for panels and bars
+
+void main()
+{
+    FragColor = vec4(color.rgb, color.a * texture(atlas, texCoord).r);
+}
@@ -0,0 +1,32 @@
+#version 330 core
+#extension GL_ARB_viewport_array : require
+
+#define MAX_VIEWS 4
+
+layout (triangles) in;
+layout (triangle_strip, max_vertices = 12) out;
+
+in vec3 worldPos[];
+in vec3 worldColor[];
+
+out vec3 vertexColor;
+
+uniform mat4 viewProjections[MAX_VIEWS];
+uniform int viewCount;
+uniform int viewMask;
+
+// One copy of the triangle per view it is visible in, routed to that view's viewport
+void main()
+{
+    for (int v = 0; v < viewCount; v++) {
+        if ((viewMask & (1 << v)) == 0) continue;
+
+        for (int i = 0; i < 3; i++) {
+            gl_Position = viewProjections[v] * vec4(worldPos[i], 1.0);
+            gl_ViewportIndex = v;
+            vertexColor = worldColor[i];
+            EmitVertex();
+        }
+        EndPrimitive();
+    }
+}
@@ -0,0 +1,8 @@
+#version 330 core
+out vec4 FragColor;
+
+// Each fragment adds one to the overdraw counter (additive blending)
+void main()
+{
+    FragColor = vec4(1.0, 0.0, 0.0, 0.0);
+}
@@ -3,6 +3,7 @@ layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aColor;
 
 out vec3 vertexColor;
+out vec3 viewPosition;                   // For fragment_clustered.glsl
 
 uniform mat4 model;
 uniform mat4 view;
@@ -10,6 +11,8 @@ uniform mat4 projection;
 
 void main()
 {
-    gl_Position = projection * view * model * vec4(aPos, 1.0);
+    vec4 viewSpace = view * model * vec4(aPos, 1.0);
+    gl_Position = projection * viewSpace;
     vertexColor = aColor;
+    viewPosition = viewSpace.xyz;
 }
@@ -0,0 +1,48 @@
+#version 330 core
+layout (location = 0) in vec3 aPos;      // Rest pose, bus model space
+layout (location = 1) in vec3 aColor;
+layout (location = 2) in float aPart;    // Part id, see BusModel::AnimatedPart
+
+out vec3 vertexColor;
+
+uniform mat4 model;                      // Bus base transform
+uniform mat4 view;
+uniform mat4 projection;
+
+uniform float doorSlide;                 // Door offset times the maximum slide
+uniform float wheelAngle;                // Radians about each wheel's Z axis
+uniform vec3 wheelCenters[8];
+uniform vec3 lightColors[2];             // Headlight, taillight
+
+const int PART_DOOR_LEFT = 1;
+const int PART_DOOR_RIGHT = 2;
+const int PART_HEADLIGHT = 3;
+const int PART_TAILLIGHT = 4;
+const int PART_WHEEL = 8;                // 8 + wheel index
+
+void main()
+{
+    int part = int(aPart + 0.5);
+    vec3 pos = aPos;
+    vec3 color = aColor;
+
+    if (part == PART_DOOR_LEFT) {
+        pos.x -= doorSlide;
+    }
+    else if (part == PART_DOOR_RIGHT) {
+        pos.x += doorSlide;
+    }
+    else if (part == PART_HEADLIGHT || part == PART_TAILLIGHT) {
+        color = lightColors[part - PART_HEADLIGHT];
+    }
+    else if (part >= PART_WHEEL) {
+        vec3 center = wheelCenters[part - PART_WHEEL];
+        float c = cos(wheelAngle);
+        float s = sin(wheelAngle);
+        vec2 d = pos.xy - center.xy;
+        pos.xy = center.xy + vec2(d.x * c - d.y * s, d.x * s + d.y * c);
+    }
+
+    gl_Position = projection * view * model * vec4(pos, 1.0);
+    vertexColor = color;
+}
@@ -0,0 +1,16 @@
+#version 330 core
+layout (location = 0) in vec2 aPos;      // Pixels, top-left origin
+layout (location = 1) in vec2 aTexCoord;
+layout (location = 2) in vec4 aColor;
+
+out vec2 texCoord;
+out vec4 color;
+
+uniform mat4 projection;                 // Pixels to clip space
+
+void main()
+{
+    texCoord = aTexCoord;
+    color = aColor;
+    gl_Position = projection * vec4(aPos, 0.0, 1.0);
+}
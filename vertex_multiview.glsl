@@ -0,0 +1,14 @@
+#version 330 core
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aColor;
+
+out vec3 worldPos;
+out vec3 worldColor;
+
+uniform mat4 model;
+
+void main()
+{
+    worldPos = vec3(model * vec4(aPos, 1.0));
+    worldColor = aColor;
+}